@@ -10,7 +10,8 @@ StateSlotView.cc MenuView.cc EmuInput.cc TextEntry.cc \
 EmuOptions.cc OptionView.cc EmuView.cc MultiChoiceView.cc \
 ConfigFile.cc InputManagerView.cc FileUtils.cc EmuApp.cc \
 BundledGamesView.cc VideoImageEffect.cc EmuVideo.cc \
-EmuInputView.cc EmuVideoLayer.cc Cheats.cc Recent.cc
+EmuInputView.cc EmuVideoLayer.cc Cheats.cc Recent.cc GameRecorder.cc \
+AudioTelemetry.cc AudioTimeStretch.cc
 
 ifeq ($(emuFramework_onScreenControls), 1)
  SRC += TouchConfigView.cc VController.cc
@@ -40,6 +41,16 @@ include $(IMAGINE_PATH)/make/package/stdc++.mk
 
 include $(IMAGINE_PATH)/make/imagineStaticLibTarget.mk
 
+# offline tools (tools/Makefile), built with the host compiler
+HOST_CXX ?= c++
+
+tools :
+	$(PRINT_CMD)$(MAKE) -C $(projectPath)/tools CXX=$(HOST_CXX) outDir=$(CURDIR)/bin/$(buildName)
+
+main : tools
+
+.PHONY : tools
+
 install : main
 	@echo "Installing lib & headers to $(prefix)"
 	$(PRINT_CMD)mkdir -p $(prefix)/lib/pkgconfig $(prefix)/include/
@@ -0,0 +1,37 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/gfx/ProjectionPlane.hh>
+
+// Samples the output buffer fill and device delay once per emulated frame and
+// counts underruns, overruns and playback restarts. A summary of each second is
+// shown on screen and the full histograms are logged when playback stops.
+
+namespace AudioTelemetry
+{
+
+void setEnabled(bool on);
+bool isEnabled();
+void reset();
+void sampleWrite();
+void countResume();
+void dumpLog();
+void placeOverlay(const Gfx::ProjectionPlane &projP);
+void drawOverlay();
+
+}
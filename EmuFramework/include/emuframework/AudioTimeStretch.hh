@@ -0,0 +1,36 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+
+// Pitch preserving time compression (WSOLA) of the emulated audio stream.
+// While the emulator runs faster than real time, segments of its output are
+// picked at the playback speed and joined where their waveforms line up best,
+// so the audio keeps its pitch and stays in step with the real time clock.
+
+namespace AudioTimeStretch
+{
+
+// speed is emulated frames per displayed frame, 1 passes audio through
+void setSpeed(uint speed);
+bool isActive();
+void reset();
+// consumes the core's samples in EmuSystem::pcmFormat and writes the
+// stretched result with Audio::writePcm()
+void write(const void *samples, uint frames);
+
+}
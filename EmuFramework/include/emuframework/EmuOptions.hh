@@ -142,6 +142,7 @@ extern PathOption optionSavePath;
 extern Byte1Option optionCheckSavePathWriteAccess;
 
 extern Byte1Option optionShowBundledGames;
+extern Byte1Option optionShowAudioStats;
 
 // Common options handled per-emulator backend
 extern PathOption optionFirmwarePath;
@@ -105,6 +105,11 @@ public:
 	typedef DelegateFunc<void (uint result, const Input::Event &e)> LoadGameCompleteDelegate;
 	static LoadGameCompleteDelegate loadGameCompleteDel;
 	static LoadGameCompleteDelegate &onLoadGameComplete() { return loadGameCompleteDel; }
+	// optional per-system timing breakdown for the benchmark,
+	// called with a null string to reset its counters
+	typedef DelegateFunc<void (char *str, uint size, uint frames)> BenchmarkStatsDelegate;
+	static BenchmarkStatsDelegate benchmarkStatsDel;
+	static BenchmarkStatsDelegate &onBenchmarkStats() { return benchmarkStatsDel; }
 	[[gnu::hot]] static void runFrame(bool renderGfx, bool processGfx, bool renderAudio);
 	static bool vidSysIsPAL();
 	static uint multiresVideoBaseX();
@@ -151,12 +156,14 @@ public:
 	static const bool inputHasKeyboard;
 	static const bool hasBundledGames;
 
-	static TimeSys benchmark()
+	static TimeSys benchmark(bool renderAudio = 0)
 	{
+		if(benchmarkStatsDel)
+			benchmarkStatsDel(nullptr, 0, 0);
 		auto now = TimeSys::now();
 		iterateTimes(180, i)
 		{
-			runFrame(0, 1, 0);
+			runFrame(0, 1, renderAudio);
 		}
 		auto after = TimeSys::now();
 		return after-now;
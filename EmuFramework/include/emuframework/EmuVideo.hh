@@ -25,6 +25,10 @@ public:
 	char *pixBuff = nullptr;
 	uint vidPixAlign = Gfx::BufferImage::MAX_ASSUME_ALIGN;
 
+private:
+	uint burstInterval = 0, burstFrames = 0;
+	uint burstShots = 0, burstDropped = 0;
+
 public:
 	constexpr EmuVideo() {}
 	void initPixmap(char *pixBuff, const PixelFormatDesc *format, uint x, uint y, uint pitch = 0);
@@ -34,5 +38,8 @@ public:
 	void initImage(bool force, uint x, uint y, uint pitch = 0);
 	void initImage(bool force, uint xO, uint yO, uint x, uint y, uint totalX, uint totalY, uint pitch = 0);
 	void takeGameScreenshot();
+	void startScreenshotBurst(uint interval);
+	void endScreenshotBurst();
+	void updateScreenshotBurst();
 	bool isExternalTexture();
 };
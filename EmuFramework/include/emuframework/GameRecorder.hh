@@ -0,0 +1,35 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/pixmap/Pixmap.hh>
+
+// Records emulated video and audio losslessly to <save path>/<game name>.NNN.emurec
+// with a .wav sidecar. Captured data is copied into bounded buffers and encoded on
+// a separate thread, when it falls behind frames/samples are dropped and counted
+// instead of stalling emulation.
+
+namespace GameRecorder
+{
+
+bool start();
+void stop();
+bool isActive();
+void writeVideoFrame(const IG::Pixmap &pix);
+void writeAudio(const void *samples, uint frames);
+
+}
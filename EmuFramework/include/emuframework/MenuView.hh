@@ -64,7 +64,7 @@ public:
 	void loadStandardItems(MenuItem *item[], uint &items);
 	virtual void init(bool highlightFirst);
 
-	static const uint STANDARD_ITEMS = 19;
+	static const uint STANDARD_ITEMS = 20;
 	static const uint MAX_SYSTEM_ITEMS = 3;
 
 protected:
@@ -93,5 +93,6 @@ protected:
 	TextMenuItem about;
 	TextMenuItem exitApp;
 	TextMenuItem screenshot;
+	TextMenuItem recordGameplay;
 	MenuItem *item[STANDARD_ITEMS + MAX_SYSTEM_ITEMS]{};
 };
@@ -301,7 +301,7 @@ enum { CFGKEY_SOUND = 0, CFGKEY_TOUCH_CONTROL_DISPLAY = 1,
 	CFGKEY_VCONTROLLER_LAYOUT_POS = 68, CFGKEY_MOGA_INPUT_SYSTEM = 69,
 	CFGKEY_FAST_FORWARD_SPEED = 70, CFGKEY_SHOW_BUNDLED_GAMES = 71,
 	CFGKEY_IMAGE_EFFECT = 72, CFGKEY_SHOW_ON_2ND_SCREEN = 73,
-	CFGKEY_CHECK_SAVE_PATH_WRITE_ACCESS = 74
+	CFGKEY_CHECK_SAVE_PATH_WRITE_ACCESS = 74, CFGKEY_SHOW_AUDIO_STATS = 75
 	// 256+ is reserved
 };
 
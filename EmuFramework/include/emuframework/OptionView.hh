@@ -81,6 +81,7 @@ protected:
 	#ifdef CONFIG_AUDIO_SOLO_MIX
 	BoolMenuItem audioSoloMix;
 	#endif
+	BoolMenuItem audioStats;
 
 	// System
 	MultiChoiceSelectMenuItem autoSaveState;
@@ -0,0 +1,243 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+// On-disk format of gameplay recordings, shared with the offline converter in
+// tools/ so it only depends on the C/C++ standard library.
+//
+// A recording is a .emurec file holding video and a .wav sidecar holding audio.
+// The .emurec file starts with a FileHeader followed by one FrameHeader + packed
+// data per captured frame. Frame data is the raw pixel rows (no padding) XORed
+// with the previous frame unless it's a key frame, then compressed with an
+// LZ4-style byte-oriented LZ77.
+
+#include <stdint.h>
+#include <string.h>
+
+namespace Recording
+{
+
+static constexpr char MAGIC[8] {'E', 'M', 'U', 'R', 'E', 'C', 0, 1};
+static constexpr uint32_t VERSION = 1;
+static constexpr uint32_t KEY_FRAME_INTERVAL = 300;
+
+enum { FRAME_KEY = 1 };
+
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t frameRate; // emulated frames per second, 50 or 60
+	uint32_t audioRate;
+	uint32_t audioChannels;
+};
+
+struct FrameHeader
+{
+	uint32_t emuFrame; // EmuSystem::emuFrameNow when captured
+	uint32_t audioFrames; // audio frames in the .wav before this video frame
+	uint16_t width, height;
+	uint8_t bytesPerPixel;
+	uint8_t rShift, gShift, bShift;
+	uint8_t rBits, gBits, bBits;
+	uint8_t flags;
+	uint32_t packedSize;
+
+	uint32_t size() const { return width * height * bytesPerPixel; }
+};
+
+static_assert(sizeof(FileHeader) == 24, "unexpected FileHeader padding");
+static_assert(sizeof(FrameHeader) == 24, "unexpected FrameHeader padding");
+
+inline void xorDelta(uint8_t *dest, const uint8_t *src, const uint8_t *prev, uint32_t size)
+{
+	for(uint32_t i = 0; i < size; i++)
+		dest[i] = src[i] ^ prev[i];
+}
+
+// LZ codec
+
+static constexpr uint32_t LZ_MIN_MATCH = 4;
+static constexpr uint32_t LZ_HASH_BITS = 12;
+
+static constexpr uint32_t lzCompressBound(uint32_t size)
+{
+	return size + size / 255 + 16;
+}
+
+inline uint32_t lzRead32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+inline uint32_t lzHash(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+inline uint8_t *lzWriteLength(uint8_t *op, uint32_t len)
+{
+	for(; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = len;
+	return op;
+}
+
+inline uint8_t *lzWriteLiterals(uint8_t *op, uint8_t *token, const uint8_t *literals, uint32_t len)
+{
+	*token = (len >= 15 ? 15 : len) << 4;
+	if(len >= 15)
+		op = lzWriteLength(op, len - 15);
+	if(!len)
+		return op;
+	memcpy(op, literals, len);
+	return op + len;
+}
+
+// compresses size bytes of src into dest, which must hold lzCompressBound(size) bytes,
+// and returns the compressed size
+inline uint32_t lzCompress(const uint8_t *src, uint32_t size, uint8_t *dest)
+{
+	uint32_t table[1 << LZ_HASH_BITS] {};
+	const uint8_t *ip = src, *anchor = src, *end = src + size;
+	uint8_t *op = dest;
+	if(size > 12)
+	{
+		// like LZ4, the last match ends at least 5 bytes before the end of input
+		const uint8_t *matchLimit = end - 5, *ipLimit = end - 12;
+		while(ip < ipLimit)
+		{
+			auto seq = lzRead32(ip);
+			auto &entry = table[lzHash(seq)];
+			auto ref = src + entry;
+			entry = ip - src;
+			if(ref >= ip || ip - ref > 0xFFFF || lzRead32(ref) != seq)
+			{
+				// step faster through data that isn't compressing
+				ip += 1 + ((ip - anchor) >> 6);
+				continue;
+			}
+			auto mp = ip + LZ_MIN_MATCH, rp = ref + LZ_MIN_MATCH;
+			while(mp < matchLimit && *mp == *rp)
+			{
+				mp++;
+				rp++;
+			}
+			auto token = op++;
+			op = lzWriteLiterals(op, token, anchor, ip - anchor);
+			uint32_t offset = ip - ref;
+			*op++ = offset;
+			*op++ = offset >> 8;
+			uint32_t matchLen = (mp - ip) - LZ_MIN_MATCH;
+			*token |= matchLen >= 15 ? 15 : matchLen;
+			if(matchLen >= 15)
+				op = lzWriteLength(op, matchLen - 15);
+			ip = anchor = mp;
+		}
+	}
+	auto token = op++;
+	op = lzWriteLiterals(op, token, anchor, end - anchor);
+	return op - dest;
+}
+
+inline bool lzReadLength(const uint8_t *&ip, const uint8_t *end, uint32_t &len)
+{
+	uint8_t b;
+	do
+	{
+		if(ip == end)
+			return false;
+		b = *ip++;
+		len += b;
+	} while(b == 255);
+	return true;
+}
+
+// decompresses exactly destSize bytes, returns false on corrupt input
+inline bool lzDecompress(const uint8_t *src, uint32_t size, uint8_t *dest, uint32_t destSize)
+{
+	const uint8_t *ip = src, *end = src + size;
+	uint8_t *op = dest, *oend = dest + destSize;
+	while(ip < end)
+	{
+		uint32_t token = *ip++;
+		uint32_t litLen = token >> 4;
+		if(litLen == 15 && !lzReadLength(ip, end, litLen))
+			return false;
+		if((uint32_t)(end - ip) < litLen || (uint32_t)(oend - op) < litLen)
+			return false;
+		if(litLen)
+			memcpy(op, ip, litLen);
+		op += litLen;
+		ip += litLen;
+		if(ip == end)
+			break; // last sequence only has literals
+		if(end - ip < 2)
+			return false;
+		uint32_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if(!offset || offset > (uint32_t)(op - dest))
+			return false;
+		uint32_t matchLen = token & 15;
+		if(matchLen == 15 && !lzReadLength(ip, end, matchLen))
+			return false;
+		matchLen += LZ_MIN_MATCH;
+		if((uint32_t)(oend - op) < matchLen)
+			return false;
+		// byte copy since the match may overlap the output
+		auto mp = op - offset;
+		while(matchLen--)
+			*op++ = *mp++;
+	}
+	return op == oend;
+}
+
+// WAV sidecar
+
+struct WavHeader
+{
+	char riff[4];
+	uint32_t riffSize;
+	char wave[4];
+	char fmt[4];
+	uint32_t fmtSize;
+	uint16_t formatTag;
+	uint16_t channels;
+	uint32_t rate;
+	uint32_t bytesPerSec;
+	uint16_t blockAlign;
+	uint16_t bitsPerSample;
+	char data[4];
+	uint32_t dataSize;
+};
+
+static_assert(sizeof(WavHeader) == 44, "unexpected WavHeader padding");
+
+inline WavHeader makeWavHeader(uint32_t rate, uint32_t channels, uint32_t bitsPerSample, uint32_t dataSize)
+{
+	uint32_t blockAlign = channels * (bitsPerSample / 8);
+	return
+	{
+		{'R', 'I', 'F', 'F'}, 36 + dataSize, {'W', 'A', 'V', 'E'},
+		{'f', 'm', 't', ' '}, 16, 1, (uint16_t)channels, rate, rate * blockAlign,
+		(uint16_t)blockAlign, (uint16_t)bitsPerSample,
+		{'d', 'a', 't', 'a'}, dataSize
+	};
+}
+
+}
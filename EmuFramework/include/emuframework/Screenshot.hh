@@ -22,12 +22,17 @@
 
 bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname);
 
+// copies the frame and writes it on a background thread, the result is reported
+// with the popup (only errors if quiet is set), returns the screenshot number or
+// -1 if no file name or capture buffer was free
+int queueScreenshot(const IG::Pixmap &vidPix, bool quiet = false);
+
 template <size_t S>
-static int sprintScreenshotFilename(std::array<char, S> &str)
+static int sprintScreenshotFilename(std::array<char, S> &str, uint firstNum = 0)
 {
 	const uint maxNum = 999;
 	int num = -1;
-	iterateTimes(maxNum, i)
+	for(uint i = firstNum; i < maxNum; i++)
 	{
 		string_printf(str, "%s/%s.%.3d.png", EmuSystem::savePath(), EmuSystem::gameName(), i);
 		if(!FsSys::fileExists(str.data()))
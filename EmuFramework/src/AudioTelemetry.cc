@@ -0,0 +1,194 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "AudioTelemetry"
+#include <emuframework/AudioTelemetry.hh>
+#include <emuframework/EmuSystem.hh>
+#include <imagine/audio/Audio.hh>
+#include <imagine/gfx/GfxText.hh>
+#include <imagine/gfx/GeomRect.hh>
+#include <imagine/gui/View.hh>
+#include <imagine/util/time/sys.hh>
+#include <imagine/util/strings.h>
+#include <algorithm>
+
+namespace AudioTelemetry
+{
+
+static constexpr uint FILL_BUCKETS = 21; // 5% steps, last one is a full buffer
+static constexpr uint DELAY_BUCKET_MS = 8;
+static constexpr uint DELAY_BUCKETS = 32; // last one holds everything larger
+
+struct Counters
+{
+	uint samples = 0;
+	uint64 fillPercentSum = 0;
+	uint minFillPercent = 100;
+	uint64 delayMsSum = 0;
+	uint maxDelayMs = 0;
+	uint underruns = 0;
+	uint overrunFrames = 0;
+	uint resumes = 0;
+};
+
+static bool enabled = false;
+static std::array<uint, FILL_BUCKETS> fillHist{};
+static std::array<uint, DELAY_BUCKETS> delayHist{};
+static Counters total, second;
+static Audio::OutputStats prevOutputStats;
+static TimeSys secondStart{};
+static std::array<char, 128> overlayStr{};
+static Gfx::Text overlayText;
+static Gfx::ProjectionPlane overlayProjP;
+
+void setEnabled(bool on)
+{
+	if(on == enabled)
+		return;
+	enabled = on;
+	if(on)
+	{
+		if(!overlayText.face)
+			overlayText.init(View::defaultFace);
+		reset();
+	}
+	else
+	{
+		overlayText.str = nullptr;
+	}
+}
+
+bool isEnabled()
+{
+	return enabled;
+}
+
+void reset()
+{
+	fillHist = {};
+	delayHist = {};
+	total = {};
+	second = {};
+	prevOutputStats = Audio::outputStats();
+	secondStart = TimeSys::now();
+}
+
+static void updateOverlay()
+{
+	uint avgFill = second.samples ? second.fillPercentSum / second.samples : 0;
+	uint avgDelay = second.samples ? second.delayMsSum / second.samples : 0;
+	string_printf(overlayStr, "Audio: fill %u%% (min %u%%) delay %ums (max %ums)\n"
+		"underruns %u/s, dropped %u frames/s, restarts %u/s",
+		avgFill, second.samples ? second.minFillPercent : 0, avgDelay, second.maxDelayMs,
+		second.underruns, second.overrunFrames, second.resumes);
+	overlayText.setString(overlayStr.data());
+	overlayText.compile(overlayProjP);
+}
+
+static void accumulate(Counters &c, uint fillPercent, uint delayMs,
+	uint underruns, uint overrunFrames)
+{
+	c.samples++;
+	c.fillPercentSum += fillPercent;
+	c.minFillPercent = std::min(c.minFillPercent, fillPercent);
+	c.delayMsSum += delayMs;
+	c.maxDelayMs = std::max(c.maxDelayMs, delayMs);
+	c.underruns += underruns;
+	c.overrunFrames += overrunFrames;
+}
+
+void sampleWrite()
+{
+	if(!enabled || !Audio::isOpen())
+		return;
+	auto &fmt = Audio::pcmFormat;
+	int bufferFrames = fmt.uSecsToFrames(Audio::hintOutputLatency());
+	int queuedFrames = std::min(std::max(bufferFrames - Audio::framesFree(), 0), bufferFrames);
+	uint fillPercent = bufferFrames ? queuedFrames * 100 / bufferFrames : 0;
+	uint delayMs = std::max(Audio::frameDelay(), 0) * 1000 / fmt.rate;
+	fillHist[std::min(fillPercent / 5, FILL_BUCKETS - 1)]++;
+	delayHist[std::min(delayMs / DELAY_BUCKET_MS, DELAY_BUCKETS - 1)]++;
+	// event counts only come from backends with CONFIG_AUDIO_STATS
+	auto stats = Audio::outputStats();
+	uint underruns = stats.underruns - prevOutputStats.underruns;
+	uint overrunFrames = stats.droppedFrames - prevOutputStats.droppedFrames;
+	prevOutputStats = stats;
+	accumulate(total, fillPercent, delayMs, underruns, overrunFrames);
+	accumulate(second, fillPercent, delayMs, underruns, overrunFrames);
+	auto now = TimeSys::now();
+	if(now - secondStart >= TimeSys::makeWithSecs(1))
+	{
+		updateOverlay();
+		second = {};
+		secondStart = now;
+	}
+}
+
+void countResume()
+{
+	if(!enabled)
+		return;
+	total.resumes++;
+	second.resumes++;
+}
+
+void dumpLog()
+{
+	if(!enabled || !total.samples)
+		return;
+	logMsg("%u samples, avg fill %u%% (min %u%%), avg delay %ums (max %ums)",
+		total.samples, (uint)(total.fillPercentSum / total.samples), total.minFillPercent,
+		(uint)(total.delayMsSum / total.samples), total.maxDelayMs);
+	logMsg("%u underruns, %u dropped frames, %u restarts, buffer %uus",
+		total.underruns, total.overrunFrames, total.resumes, Audio::hintOutputLatency());
+	logMsg("fill histogram:");
+	iterateTimes(FILL_BUCKETS, i)
+	{
+		if(fillHist[i])
+			logMsg("%3d%%: %u", i * 5, fillHist[i]);
+	}
+	logMsg("delay histogram:");
+	iterateTimes(DELAY_BUCKETS, i)
+	{
+		if(delayHist[i])
+			logMsg("%3dms%s: %u", i * DELAY_BUCKET_MS, i == DELAY_BUCKETS - 1 ? "+" : "", delayHist[i]);
+	}
+}
+
+void placeOverlay(const Gfx::ProjectionPlane &projP)
+{
+	overlayProjP = projP;
+	if(overlayText.str)
+		overlayText.compile(projP);
+}
+
+void drawOverlay()
+{
+	using namespace Gfx;
+	if(!enabled || !overlayText.str)
+		return;
+	auto &projP = overlayProjP;
+	noTexProgram.use(projP.makeTranslate());
+	setBlendMode(BLEND_MODE_ALPHA);
+	setColor(0, 0, 0, .6);
+	Gfx::GCRect rect(-projP.wHalf(), projP.hHalf() - (overlayText.ySize * 2.5),
+		-projP.wHalf() + overlayText.xSize, projP.hHalf());
+	GeomRect::draw(rect);
+	setColor(1., 1., 1., 1.);
+	texAlphaProgram.use();
+	overlayText.draw(rect.x, rect.y2, LT2DO, projP);
+}
+
+}
@@ -0,0 +1,261 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "TimeStretch"
+#include <emuframework/AudioTimeStretch.hh>
+#include <emuframework/EmuSystem.hh>
+#include <imagine/audio/Audio.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/mem/mem.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined __SSE__
+#include <xmmintrin.h>
+#elif defined __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+namespace AudioTimeStretch
+{
+
+static uint speed = 1;
+static uint rate = 0, channels = 0;
+static uint seqFrames = 0; // frames taken from the input each step
+static uint overlapFrames = 0; // cross-faded with the previous step's tail
+static uint seekFrames = 0; // search distance on each side of the nominal position
+static uint inCapacity = 0;
+static int16 *inBuff{}, *outBuff{}, *tail{};
+static float *mono{}, *tailMono{};
+static uint inFrames = 0;
+static uint inPos = 0; // nominal start of the next segment in inBuff
+static uint skipFrames = 0; // input to discard when a hop passes the buffered data
+static bool hasTail = false;
+
+// n is always a multiple of 4
+static float dotProduct(const float *a, const float *b, uint n)
+{
+	#if defined __SSE__
+	auto acc = _mm_setzero_ps();
+	for(uint i = 0; i < n; i += 4)
+	{
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+	}
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	return _mm_cvtss_f32(acc);
+	#elif defined __ARM_NEON__
+	auto acc = vdupq_n_f32(0);
+	for(uint i = 0; i < n; i += 4)
+	{
+		acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+	}
+	auto sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	sum = vpadd_f32(sum, sum);
+	return vget_lane_f32(sum, 0);
+	#else
+	float acc[4]{};
+	for(uint i = 0; i < n; i += 4)
+	{
+		acc[0] += a[i] * b[i];
+		acc[1] += a[i + 1] * b[i + 1];
+		acc[2] += a[i + 2] * b[i + 2];
+		acc[3] += a[i + 3] * b[i + 3];
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+	#endif
+}
+
+static void toMono(float *dest, const int16 *src, uint frames)
+{
+	if(channels == 2)
+	{
+		iterateTimes(frames, i)
+		{
+			dest[i] = (src[i*2] + src[i*2 + 1]) * .5f;
+		}
+	}
+	else
+	{
+		iterateTimes(frames, i)
+		{
+			dest[i] = src[i];
+		}
+	}
+}
+
+static bool setupBuffers()
+{
+	auto &fmt = EmuSystem::pcmFormat;
+	if(fmt.sample.toBits() != 16 || fmt.channels > 2)
+		return false;
+	if(inBuff && (uint)fmt.rate == rate && (uint)fmt.channels == channels)
+		return true;
+	rate = fmt.rate;
+	channels = fmt.channels;
+	overlapFrames = std::max((rate / 125) & ~3u, 4u); // 8ms
+	seqFrames = std::max(rate * 30 / 1000, overlapFrames * 2);
+	seekFrames = rate * 12 / 1000;
+	// room for a full search window plus one more segment of new input
+	inCapacity = seqFrames * 2 + seekFrames * 2;
+	inBuff = (int16*)mem_realloc(inBuff, inCapacity * channels * sizeof(int16));
+	outBuff = (int16*)mem_realloc(outBuff, seqFrames * channels * sizeof(int16));
+	tail = (int16*)mem_realloc(tail, overlapFrames * channels * sizeof(int16));
+	mono = (float*)mem_realloc(mono, (seekFrames * 2 + overlapFrames) * sizeof(float));
+	tailMono = (float*)mem_realloc(tailMono, overlapFrames * sizeof(float));
+	if(!inBuff || !outBuff || !tail || !mono || !tailMono)
+	{
+		logErr("out of memory");
+		mem_free(inBuff);
+		mem_free(outBuff);
+		mem_free(tail);
+		mem_free(mono);
+		mem_free(tailMono);
+		inBuff = outBuff = tail = nullptr;
+		mono = tailMono = nullptr;
+		return false;
+	}
+	logMsg("%dHz: %d frame segments, %d overlap, %d seek", rate, seqFrames, overlapFrames, seekFrames);
+	return true;
+}
+
+// offset from start where the input best continues the previous segment's tail
+static uint bestOffset(uint start)
+{
+	uint candidates = seekFrames * 2 + 1;
+	toMono(mono, &inBuff[start * channels], candidates + overlapFrames - 1);
+	float energy = dotProduct(mono, mono, overlapFrames);
+	uint best = seekFrames;
+	float bestScore = -INFINITY;
+	iterateTimes(candidates, i)
+	{
+		// normalized by the candidate's energy so loud segments aren't favored
+		float corr = dotProduct(&mono[i], tailMono, overlapFrames);
+		float score = corr * std::abs(corr) / (std::max(energy, 0.f) + 1.f);
+		if(score > bestScore)
+		{
+			bestScore = score;
+			best = i;
+		}
+		if(i + 1 < candidates)
+			energy += mono[i + overlapFrames] * mono[i + overlapFrames] - mono[i] * mono[i];
+	}
+	return best;
+}
+
+static void processSteps()
+{
+	const uint hop = seqFrames - overlapFrames;
+	while(inPos + seekFrames + seqFrames <= inFrames)
+	{
+		uint pos = inPos;
+		if(hasTail)
+		{
+			pos = inPos - seekFrames + bestOffset(inPos - seekFrames);
+			auto in = &inBuff[pos * channels];
+			iterateTimes(overlapFrames, i)
+			{
+				iterateTimes(channels, c)
+				{
+					uint idx = i * channels + c;
+					outBuff[idx] = ((int)tail[idx] * (int)(overlapFrames - i) + (int)in[idx] * (int)i) / (int)overlapFrames;
+				}
+			}
+			memcpy(&outBuff[overlapFrames * channels], &in[overlapFrames * channels],
+				(hop - overlapFrames) * channels * sizeof(int16));
+		}
+		else
+		{
+			memcpy(outBuff, &inBuff[pos * channels], hop * channels * sizeof(int16));
+			hasTail = true;
+		}
+		memcpy(tail, &inBuff[(pos + hop) * channels], overlapFrames * channels * sizeof(int16));
+		toMono(tailMono, tail, overlapFrames);
+		Audio::writePcm(outBuff, hop);
+
+		// advance by the speed multiple of the output and keep seekFrames before it
+		uint keepStart = inPos + hop * speed - seekFrames;
+		if(keepStart >= inFrames)
+		{
+			skipFrames = keepStart - inFrames;
+			inFrames = 0;
+		}
+		else
+		{
+			inFrames -= keepStart;
+			memmove(inBuff, &inBuff[keepStart * channels], inFrames * channels * sizeof(int16));
+		}
+		inPos = seekFrames;
+	}
+}
+
+void setSpeed(uint newSpeed)
+{
+	if(newSpeed == speed)
+		return;
+	if(newSpeed > 1)
+	{
+		if(speed <= 1)
+		{
+			if(!setupBuffers())
+				return;
+			reset();
+		}
+		logMsg("stretching audio at %ux", newSpeed);
+	}
+	else
+	{
+		logMsg("stopped stretching audio");
+	}
+	speed = newSpeed;
+}
+
+bool isActive()
+{
+	return speed > 1;
+}
+
+void reset()
+{
+	inFrames = 0;
+	inPos = seekFrames;
+	skipFrames = 0;
+	hasTail = false;
+}
+
+void write(const void *samples, uint frames)
+{
+	assert(isActive());
+	auto in = (const int16*)samples;
+	while(frames)
+	{
+		if(skipFrames)
+		{
+			uint skip = std::min(frames, skipFrames);
+			skipFrames -= skip;
+			in += skip * channels;
+			frames -= skip;
+			continue;
+		}
+		uint copy = std::min(frames, inCapacity - inFrames);
+		memcpy(&inBuff[inFrames * channels], in, copy * channels * sizeof(int16));
+		inFrames += copy;
+		in += copy * channels;
+		frames -= copy;
+		processSteps();
+	}
+}
+
+}
@@ -266,6 +266,7 @@ static bool readConfig2(IO &io)
 				if(EmuSystem::hasBundledGames)
 					optionShowBundledGames.readFromIO(io, size);
 			}
+			bcase CFGKEY_SHOW_AUDIO_STATS: optionShowAudioStats.readFromIO(io, size);
 			#ifdef EMU_FRAMEWORK_BEST_COLOR_MODE_OPTION
 			bcase CFGKEY_BEST_COLOR_MODE_HINT: optionBestColorModeHint.readFromIO(io, size);
 			#endif
@@ -501,7 +502,8 @@ static OptionBase *cfgFileOption[] =
 	&optionBestColorModeHint,
 	#endif
 	&optionShowBundledGames,
-	&optionCheckSavePathWriteAccess
+	&optionCheckSavePathWriteAccess,
+	&optionShowAudioStats
 };
 
 static void writeConfig2(IO &io)
@@ -20,6 +20,9 @@
 #include <emuframework/FilePicker.hh>
 #include <emuframework/ConfigFile.hh>
 #include <emuframework/EmuView.hh>
+#include <emuframework/GameRecorder.hh>
+#include <emuframework/AudioTelemetry.hh>
+#include <emuframework/AudioTimeStretch.hh>
 #include <imagine/gui/AlertView.hh>
 #include <cmath>
 
@@ -105,6 +108,7 @@ static void drawEmuVideo()
 		emuView.draw();
 	else if(emuView2.layer)
 		emuView2.draw();
+	AudioTelemetry::drawOverlay();
 	popup.draw();
 	Gfx::setClipRect(false);
 	Gfx::presentWindow(emuWin->win);
@@ -113,6 +117,8 @@ static void drawEmuVideo()
 void updateAndDrawEmuVideo()
 {
 	emuVideo.vidImg.write(emuVideo.vidPix, emuVideo.vidPixAlign);
+	emuVideo.updateScreenshotBurst();
+	GameRecorder::writeVideoFrame(emuVideo.vidPix);
 	drawEmuVideo();
 }
 
@@ -181,13 +187,17 @@ static Base::Screen::OnFrameDelegate frameUpdate =
 		if(unlikely(fastForwardActive))
 		{
 			EmuSystem::runFrameOnDraw = true;
+			bool renderAudio = optionSound;
+			// the frame run on draw also produces audio
+			AudioTimeStretch::setSpeed(renderAudio ? (uint)optionFastForwardSpeed + 1 : 1);
 			iterateTimes((uint)optionFastForwardSpeed, i)
 			{
-				EmuSystem::runFrame(false, false, false);
+				EmuSystem::runFrame(false, false, renderAudio);
 			}
 		}
 		else
 		{
+			AudioTimeStretch::setSpeed(1);
 			int framesToSkip = EmuSystem::setupFrameSkip(optionFrameSkip, params.frameTime());
 			if(framesToSkip >= 0)
 			{
@@ -741,6 +751,7 @@ void mainInitWindowCommon(Base::Window &win)
 
 	setupFont();
 	popup.init();
+	AudioTelemetry::setEnabled(optionShowAudioStats);
 	#ifdef CONFIG_EMUFRAMEWORK_VCONTROLS
 	initVControls();
 	EmuControls::updateVControlImg();
@@ -880,6 +891,7 @@ void placeElements()
 	logMsg("placing app elements");
 	TableView::setDefaultXIndent(mainWin.projectionPlane);
 	popup.place(emuWin->projectionPlane);
+	AudioTelemetry::placeOverlay(emuWin->projectionPlane);
 	placeEmuViews();
 	viewStack.place(mainWin.viewport().bounds(), mainWin.projectionPlane);
 	modalViewController.place(mainWin.viewport().bounds(), mainWin.projectionPlane);
@@ -22,6 +22,7 @@
 
 extern bool touchControlsAreOn;
 bool touchControlsApplicable();
+static constexpr uint screenshotBurstInterval = 30;
 
 void EmuInputView::draw()
 {
@@ -42,6 +43,7 @@ void EmuInputView::resetInput()
 	vController.resetInput();
 	#endif
 	ffKeyPushed = ffToggleActive = false;
+	emuVideo.endScreenshotBurst();
 }
 
 void EmuInputView::updateFastforward()
@@ -218,9 +220,15 @@ void EmuInputView::inputEvent(const Input::Event &e)
 					}
 
 					bcase guiKeyIdxGameScreenshot:
-					if(e.state == Input::PUSHED)
 					{
-						emuVideo.takeGameScreenshot();
+						// holding the key keeps capturing every screenshotBurstInterval frames
+						if(e.state == Input::PUSHED)
+						{
+							emuVideo.takeGameScreenshot();
+							emuVideo.startScreenshotBurst(screenshotBurstInterval);
+						}
+						else
+							emuVideo.endScreenshotBurst();
 						return;
 					}
 
@@ -215,6 +215,7 @@ PathOption optionSavePath(CFGKEY_SAVE_PATH, EmuSystem::savePath_, "");
 Byte1Option optionCheckSavePathWriteAccess{CFGKEY_CHECK_SAVE_PATH_WRITE_ACCESS, 1};
 
 Byte1Option optionShowBundledGames(CFGKEY_SHOW_BUNDLED_GAMES, 1);
+Byte1Option optionShowAudioStats(CFGKEY_SHOW_AUDIO_STATS, 0);
 
 [[gnu::weak]] PathOption optionFirmwarePath(0, nullptr, 0, nullptr);
 
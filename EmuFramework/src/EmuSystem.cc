@@ -17,6 +17,9 @@
 #include <emuframework/EmuOptions.hh>
 #include <emuframework/EmuApp.hh>
 #include <emuframework/FileUtils.hh>
+#include <emuframework/GameRecorder.hh>
+#include <emuframework/AudioTelemetry.hh>
+#include <emuframework/AudioTimeStretch.hh>
 #include <imagine/audio/Audio.hh>
 #include <algorithm>
 
@@ -36,6 +39,7 @@ Audio::PcmFormat EmuSystem::pcmFormat = Audio::pPCM;
 uint EmuSystem::audioFramesPerVideoFrame = 0;
 const uint EmuSystem::optionFrameSkipAuto = 32;
 EmuSystem::LoadGameCompleteDelegate EmuSystem::loadGameCompleteDel;
+EmuSystem::BenchmarkStatsDelegate EmuSystem::benchmarkStatsDel;
 Base::Timer EmuSystem::autoSaveStateTimer;
 [[gnu::weak]] const bool EmuSystem::inputHasKeyboard = false;
 [[gnu::weak]] const bool EmuSystem::hasBundledGames = false;
@@ -74,9 +78,13 @@ void EmuSystem::startSound()
 			Audio::setHintOutputLatency(wantedLatency);
 			#endif
 			Audio::openPcm(pcmFormat);
+			AudioTelemetry::reset();
 		}
 		else if(Audio::framesFree() <= (int)audioFramesPerVideoFrame)
+		{
 			Audio::resumePcm();
+			AudioTelemetry::countResume();
+		}
 	}
 }
 
@@ -86,27 +94,44 @@ void EmuSystem::stopSound()
 	{
 		//logMsg("stopping sound");
 		Audio::pausePcm();
+		AudioTelemetry::dumpLog();
 	}
 }
 
 void EmuSystem::writeSound(const void *samples, uint framesToWrite)
 {
-	Audio::writePcm(samples, framesToWrite);
+	GameRecorder::writeAudio(samples, framesToWrite);
+	if(AudioTimeStretch::isActive())
+		AudioTimeStretch::write(samples, framesToWrite);
+	else
+		Audio::writePcm(samples, framesToWrite);
 	if(!Audio::isPlaying() && Audio::framesFree() <= (int)audioFramesPerVideoFrame)
 	{
 		logMsg("starting audio playback with %d frames free in buffer", Audio::framesFree());
 		Audio::resumePcm();
+		AudioTelemetry::countResume();
 	}
+	AudioTelemetry::sampleWrite();
 }
 
 void EmuSystem::commitSound(Audio::BufferContext buffer, uint frames)
 {
-	Audio::commitPlayBuffer(buffer, frames);
+	GameRecorder::writeAudio(buffer.data, frames);
+	if(AudioTimeStretch::isActive())
+	{
+		// samples are copied out before any stretched output is written over the play buffer
+		AudioTimeStretch::write(buffer.data, frames);
+		Audio::commitPlayBuffer(buffer, 0);
+	}
+	else
+		Audio::commitPlayBuffer(buffer, frames);
 	if(!Audio::isPlaying() && Audio::framesFree() <= (int)audioFramesPerVideoFrame)
 	{
 		logMsg("starting audio playback with %d frames free in buffer", Audio::framesFree());
 		Audio::resumePcm();
+		AudioTelemetry::countResume();
 	}
+	AudioTelemetry::sampleWrite();
 }
 
 bool EmuSystem::stateExists(int slot)
@@ -355,9 +380,11 @@ void EmuSystem::closeGame(bool allowAutosaveState)
 	{
 		if(Audio::isOpen())
 			Audio::clearPcm();
+		AudioTimeStretch::reset();
 		if(allowAutosaveState)
 			saveAutoState();
 		logMsg("closing game %s", gameName_);
+		GameRecorder::stop();
 		closeSystem();
 		clearGamePaths();
 		cancelAutoSaveStateTimer();
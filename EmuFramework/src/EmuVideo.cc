@@ -77,23 +77,38 @@ void EmuVideo::initImage(bool force, uint xO, uint yO, uint x, uint y, uint tota
 
 void EmuVideo::takeGameScreenshot()
 {
-	FsSys::PathString path;
-	int screenshotNum = sprintScreenshotFilename(path);
-	if(screenshotNum == -1)
-	{
-		popup.postError("Too many screenshots");
-	}
+	queueScreenshot(vidPix);
+}
+
+void EmuVideo::startScreenshotBurst(uint interval)
+{
+	assert(interval);
+	logMsg("starting screenshot burst every %d frames", interval);
+	burstInterval = interval;
+	burstFrames = 0;
+	burstShots = burstDropped = 0;
+}
+
+void EmuVideo::endScreenshotBurst()
+{
+	if(!burstInterval)
+		return;
+	logMsg("ended screenshot burst, %d captured, %d dropped", burstShots, burstDropped);
+	burstInterval = 0;
+	if(burstShots > 1 || burstDropped)
+		popup.printf(2, 0, "Captured %d screenshots, %d skipped", burstShots, burstDropped);
+}
+
+void EmuVideo::updateScreenshotBurst()
+{
+	if(!burstInterval || ++burstFrames < burstInterval)
+		return;
+	burstFrames = 0;
+	// drop the frame instead of waiting if the writer thread falls behind
+	if(queueScreenshot(vidPix, true) == -1)
+		burstDropped++;
 	else
-	{
-		if(!writeScreenshot(vidPix, path.data()))
-		{
-			popup.printf(2, 1, "Error writing screenshot #%d", screenshotNum);
-		}
-		else
-		{
-			popup.printf(2, 0, "Wrote screenshot #%d", screenshotNum);
-		}
-	}
+		burstShots++;
 }
 
 bool EmuVideo::isExternalTexture()
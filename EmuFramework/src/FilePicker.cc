@@ -108,9 +108,21 @@ void loadGameCompleteFromBenchmarkFilePicker(uint result, const Input::Event &e)
 	{
 		logMsg("starting benchmark");
 		TimeSys time = EmuSystem::benchmark();
+		char stats[128]{};
+		if(EmuSystem::benchmarkStatsDel)
+		{
+			EmuSystem::benchmarkStatsDel(stats, sizeof(stats), 180);
+			logMsg("%s", stats);
+		}
+		// run again with sound synthesis to estimate its cost per frame
+		TimeSys audioTime = EmuSystem::benchmark(1);
 		EmuSystem::closeGame(0);
-		logMsg("done in: %f", double(time));
-		popup.printf(2, 0, "%.2f fps", double(180.)/double(time));
+		double audioMs = std::max(double(audioTime) - double(time), 0.) / 180. * 1000.;
+		logMsg("done in: %f, %f with audio (%.3fms/frame)", double(time), double(audioTime), audioMs);
+		if(strlen(stats))
+			popup.printf(4, 0, "%.2f fps\nAudio: %.3fms/frame\n%s", double(180.)/double(time), audioMs, stats);
+		else
+			popup.printf(3, 0, "%.2f fps\nAudio: %.3fms/frame", double(180.)/double(time), audioMs);
 	}
 }
 
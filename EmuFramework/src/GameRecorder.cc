@@ -0,0 +1,328 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "GameRecorder"
+#include <emuframework/GameRecorder.hh>
+#include <emuframework/RecordingFormat.hh>
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuApp.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/fs/sys.hh>
+#include <imagine/util/thread/pthread.hh>
+#include <algorithm>
+
+namespace GameRecorder
+{
+
+struct VideoSlot
+{
+	char *buffer = nullptr;
+	uint bufferSize = 0;
+	Recording::FrameHeader header{};
+};
+
+static constexpr uint VIDEO_SLOTS = 8;
+static constexpr uint AUDIO_BUFFER_SECS = 1;
+
+// slots and the audio ring are filled on the main thread and drained by the encoder,
+// only the ring positions are guarded by the mutex
+static VideoSlot slot[VIDEO_SLOTS];
+static uint slotStart = 0, slotCount = 0;
+static char *audioBuffer = nullptr;
+static uint audioBufferSize = 0, audioReadPos = 0, audioWritePos = 0, audioBytes = 0;
+static bool stopRequested = false;
+static MutexPThread mutex;
+static CondVarPThread cond;
+static ThreadPThread encoderThread;
+
+// main thread only
+static bool active = false;
+static Audio::PcmFormat pcmFormat;
+static uint audioFramesAccepted = 0, droppedAudioFrames = 0;
+static uint capturedFrames = 0, droppedFrames = 0;
+static int recordingNum = -1;
+
+// encoder thread only while recording
+static FileIO videoFile, audioFile;
+static uint audioBytesWritten = 0;
+
+static bool sameFrameFormat(const Recording::FrameHeader &a, const Recording::FrameHeader &b)
+{
+	return a.width == b.width && a.height == b.height && a.bytesPerPixel == b.bytesPerPixel
+		&& a.rShift == b.rShift && a.gShift == b.gShift && a.bShift == b.bShift
+		&& a.rBits == b.rBits && a.gBits == b.gBits && a.bBits == b.bBits;
+}
+
+static void writeAudioRing(uint readPos, uint bytes)
+{
+	uint firstPart = std::min(bytes, audioBufferSize - readPos);
+	audioFile.write(audioBuffer + readPos, firstPart);
+	if(bytes > firstPart)
+		audioFile.write(audioBuffer, bytes - firstPart);
+	audioBytesWritten += bytes;
+}
+
+static ptrsize encoderThreadFunc(ThreadPThread &thread)
+{
+	uint8 *prevFrame = nullptr, *delta = nullptr, *packed = nullptr;
+	uint frameBufferSize = 0, framesSinceKey = 0;
+	Recording::FrameHeader prevHeader{};
+	for(;;)
+	{
+		mutex.lock();
+		while(!slotCount && !audioBytes && !stopRequested)
+			cond.wait(mutex);
+		if(stopRequested && !slotCount && !audioBytes)
+		{
+			mutex.unlock();
+			break;
+		}
+		uint readPos = audioReadPos, bytes = audioBytes;
+		VideoSlot *s = slotCount ? &slot[slotStart] : nullptr;
+		mutex.unlock();
+
+		// audio goes first so the .wav already holds the samples a frame's audioFrames refers to
+		if(bytes)
+		{
+			writeAudioRing(readPos, bytes);
+			mutex.lock();
+			audioReadPos = (readPos + bytes) % audioBufferSize;
+			audioBytes -= bytes;
+			mutex.unlock();
+		}
+
+		if(s)
+		{
+			auto header = s->header;
+			uint size = header.size();
+			bool key = !framesSinceKey || !sameFrameFormat(header, prevHeader);
+			if(size > frameBufferSize)
+			{
+				prevFrame = (uint8*)mem_realloc(prevFrame, size);
+				delta = (uint8*)mem_realloc(delta, size);
+				packed = (uint8*)mem_realloc(packed, Recording::lzCompressBound(size));
+				frameBufferSize = size;
+			}
+			auto src = (const uint8*)s->buffer;
+			auto input = src;
+			if(!key)
+			{
+				Recording::xorDelta(delta, src, prevFrame, size);
+				input = delta;
+			}
+			header.flags = key ? Recording::FRAME_KEY : 0;
+			header.packedSize = Recording::lzCompress(input, size, packed);
+			videoFile.write(&header, sizeof(header));
+			videoFile.write(packed, header.packedSize);
+			memcpy(prevFrame, src, size);
+			prevHeader = header;
+			framesSinceKey = key ? 1 : (framesSinceKey + 1) % Recording::KEY_FRAME_INTERVAL;
+
+			mutex.lock();
+			slotStart = (slotStart + 1) % VIDEO_SLOTS;
+			slotCount--;
+			mutex.unlock();
+		}
+	}
+	mem_free(prevFrame);
+	mem_free(delta);
+	mem_free(packed);
+	return 0;
+}
+
+static bool initSync()
+{
+	static bool init = false;
+	if(!init)
+		init = mutex.create() && cond.init();
+	return init;
+}
+
+template <size_t S>
+static int sprintRecordingFilename(std::array<char, S> &str)
+{
+	const uint maxNum = 999;
+	iterateTimes(maxNum, i)
+	{
+		string_printf(str, "%s/%s.%.3d.emurec", EmuSystem::savePath(), EmuSystem::gameName(), i);
+		if(!FsSys::fileExists(str.data()))
+			return i;
+	}
+	return -1;
+}
+
+// closes and deletes the files of a recording that failed to start
+static void discardFiles(const char *videoPath, const char *audioPath)
+{
+	videoFile.close();
+	audioFile.close();
+	FsSys::remove(videoPath);
+	FsSys::remove(audioPath);
+}
+
+bool start()
+{
+	if(active)
+		return true;
+	FsSys::PathString videoPath, audioPath;
+	recordingNum = sprintRecordingFilename(videoPath);
+	if(recordingNum == -1)
+	{
+		popup.postError("Too many recordings");
+		return false;
+	}
+	string_printf(audioPath, "%s/%s.%.3d.wav", EmuSystem::savePath(), EmuSystem::gameName(), recordingNum);
+	if(videoFile.create(videoPath.data()) != OK || audioFile.create(audioPath.data()) != OK)
+	{
+		discardFiles(videoPath.data(), audioPath.data());
+		popup.postError("Error creating recording file");
+		return false;
+	}
+	if(!initSync())
+	{
+		discardFiles(videoPath.data(), audioPath.data());
+		popup.postError("Error starting recorder");
+		return false;
+	}
+
+	pcmFormat = EmuSystem::pcmFormat;
+	Recording::FileHeader fileHeader{{}, Recording::VERSION, EmuSystem::vidSysIsPAL() ? 50u : 60u,
+		(uint32)pcmFormat.rate, (uint32)pcmFormat.channels};
+	memcpy(fileHeader.magic, Recording::MAGIC, sizeof(fileHeader.magic));
+	videoFile.write(&fileHeader, sizeof(fileHeader));
+	// sizes are filled in by stop()
+	auto wavHeader = Recording::makeWavHeader(pcmFormat.rate, pcmFormat.channels, pcmFormat.sample.toBits(), 0);
+	audioFile.write(&wavHeader, sizeof(wavHeader));
+	audioBytesWritten = 0;
+
+	audioBufferSize = pcmFormat.secsToBytes(AUDIO_BUFFER_SECS);
+	audioBuffer = (char*)mem_realloc(audioBuffer, audioBufferSize);
+	audioReadPos = audioWritePos = audioBytes = 0;
+	slotStart = slotCount = 0;
+	stopRequested = false;
+	audioFramesAccepted = droppedAudioFrames = 0;
+	capturedFrames = droppedFrames = 0;
+	if(!encoderThread.create(0, encoderThreadFunc))
+	{
+		discardFiles(videoPath.data(), audioPath.data());
+		popup.postError("Error starting recorder");
+		return false;
+	}
+	active = true;
+	logMsg("started recording %s", videoPath.data());
+	popup.printf(2, 0, "Recording #%d started", recordingNum);
+	return true;
+}
+
+void stop()
+{
+	if(!active)
+		return;
+	active = false;
+	mutex.lock();
+	stopRequested = true;
+	cond.signal();
+	mutex.unlock();
+	encoderThread.join();
+
+	auto wavHeader = Recording::makeWavHeader(pcmFormat.rate, pcmFormat.channels, pcmFormat.sample.toBits(), audioBytesWritten);
+	audioFile.seekS(0);
+	audioFile.write(&wavHeader, sizeof(wavHeader));
+	audioFile.close();
+	videoFile.close();
+	iterateTimes(VIDEO_SLOTS, i)
+	{
+		mem_free(slot[i].buffer);
+		slot[i] = {};
+	}
+	mem_free(audioBuffer);
+	audioBuffer = nullptr;
+	logMsg("stopped recording, %d frames captured, %d dropped, %d audio frames dropped",
+		capturedFrames, droppedFrames, droppedAudioFrames);
+	if(droppedFrames || droppedAudioFrames)
+		popup.printf(3, 0, "Recording #%d saved, %d frames dropped", recordingNum, droppedFrames);
+	else
+		popup.printf(2, 0, "Recording #%d saved", recordingNum);
+}
+
+bool isActive()
+{
+	return active;
+}
+
+void writeVideoFrame(const IG::Pixmap &pix)
+{
+	if(!active)
+		return;
+	mutex.lock();
+	bool full = slotCount == VIDEO_SLOTS;
+	auto &s = slot[(slotStart + slotCount) % VIDEO_SLOTS];
+	mutex.unlock();
+	if(full)
+	{
+		droppedFrames++;
+		return;
+	}
+	uint lineBytes = pix.x * pix.format.bytesPerPixel;
+	uint size = lineBytes * pix.y;
+	if(s.bufferSize < size)
+	{
+		s.buffer = (char*)mem_realloc(s.buffer, size);
+		s.bufferSize = size;
+	}
+	// emulated frames are often a padded sub-region of a larger buffer
+	iterateTimes(pix.y, y)
+	{
+		memcpy(s.buffer + y * lineBytes, pix.getPixel(0, y), lineBytes);
+	}
+	auto &f = pix.format;
+	s.header = {EmuSystem::emuFrameNow, audioFramesAccepted, (uint16)pix.x, (uint16)pix.y, f.bytesPerPixel,
+		f.rShift, f.gShift, f.bShift, f.rBits, f.gBits, f.bBits, 0, 0};
+	capturedFrames++;
+
+	mutex.lock();
+	slotCount++;
+	cond.signal();
+	mutex.unlock();
+}
+
+void writeAudio(const void *samples, uint frames)
+{
+	if(!active)
+		return;
+	uint bytes = pcmFormat.framesToBytes(frames);
+	mutex.lock();
+	uint bytesFree = audioBufferSize - audioBytes;
+	uint writePos = audioWritePos;
+	mutex.unlock();
+	if(bytes > bytesFree)
+	{
+		droppedAudioFrames += frames;
+		return;
+	}
+	uint firstPart = std::min(bytes, audioBufferSize - writePos);
+	memcpy(audioBuffer + writePos, samples, firstPart);
+	if(bytes > firstPart)
+		memcpy(audioBuffer, (const char*)samples + firstPart, bytes - firstPart);
+	audioFramesAccepted += frames;
+
+	mutex.lock();
+	audioWritePos = (writePos + bytes) % audioBufferSize;
+	audioBytes += bytes;
+	cond.signal();
+	mutex.unlock();
+}
+
+}
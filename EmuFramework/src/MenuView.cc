@@ -23,6 +23,7 @@
 #include <emuframework/StateSlotView.hh>
 #include <emuframework/EmuInput.hh>
 #include <emuframework/EmuOptions.hh>
+#include <emuframework/GameRecorder.hh>
 #include <emuframework/InputManagerView.hh>
 #include <emuframework/TouchConfigView.hh>
 #include <emuframework/BundledGamesView.hh>
@@ -140,6 +141,9 @@ void MenuView::onShow()
 	stateSlotText[12] = saveSlotChar(EmuSystem::saveStateSlot);
 	stateSlot.compile(projP);
 	screenshot.active = EmuSystem::gameIsRunning();
+	recordGameplay.active = EmuSystem::gameIsRunning();
+	recordGameplay.t.setString(GameRecorder::isActive() ? "Stop Recording" : "Start Recording");
+	recordGameplay.compile(projP);
 	#if defined CONFIG_BASE_ANDROID && !defined CONFIG_MACHINE_OUYA
 	addLauncherIcon.active = EmuSystem::gameIsRunning();
 	#endif
@@ -183,6 +187,7 @@ void MenuView::loadStandardItems(MenuItem *item[], uint &items)
 	#endif
 	benchmark.init(); item[items++] = &benchmark;
 	screenshot.init(); item[items++] = &screenshot;
+	recordGameplay.init(GameRecorder::isActive() ? "Stop Recording" : "Start Recording"); item[items++] = &recordGameplay;
 	about.init(); item[items++] = &about;
 	exitApp.init(); item[items++] = &exitApp;
 }
@@ -498,6 +503,21 @@ MenuView::MenuView(Base::Window &win):
 			if(EmuSystem::gameIsRunning())
 				emuVideo.takeGameScreenshot();
 		}
+	},
+	recordGameplay
+	{
+		[this](TextMenuItem &item, View &, const Input::Event &e)
+		{
+			if(GameRecorder::isActive())
+				GameRecorder::stop();
+			else if(EmuSystem::gameIsRunning())
+				GameRecorder::start();
+			else
+				return;
+			item.t.setString(GameRecorder::isActive() ? "Stop Recording" : "Start Recording");
+			item.compile(projP);
+			postDraw();
+		}
 	}
 {}
 
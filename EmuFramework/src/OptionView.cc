@@ -16,6 +16,7 @@
 #include <emuframework/OptionView.hh>
 #include <emuframework/EmuApp.hh>
 #include <emuframework/FilePicker.hh>
+#include <emuframework/AudioTelemetry.hh>
 #include <algorithm>
 
 static FsSys::PathString savePathStrToDescStr(char *savePathStr)
@@ -548,6 +549,7 @@ void OptionView::loadAudioItems(MenuItem *item[], uint &items)
 	#ifdef CONFIG_AUDIO_SOLO_MIX
 	audioSoloMix.init(!optionAudioSoloMix); item[items++] = &audioSoloMix;
 	#endif
+	audioStats.init(optionShowAudioStats); item[items++] = &audioStats;
 }
 
 void OptionView::loadInputItems(MenuItem *item[], uint &items)
@@ -951,6 +953,16 @@ OptionView::OptionView(Base::Window &win):
 		}
 	},
 	#endif
+	audioStats
+	{
+		"Show Audio Stats",
+		[this](BoolMenuItem &item, View &, const Input::Event &e)
+		{
+			item.toggle(*this);
+			optionShowAudioStats = item.on;
+			AudioTelemetry::setEnabled(item.on);
+		}
+	},
 	// System
 	autoSaveState
 	{
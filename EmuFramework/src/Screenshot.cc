@@ -13,33 +13,76 @@
 	You should have received a copy of the GNU General Public License
 	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
 
+#define LOGTAG "Screenshot"
 #include <emuframework/Screenshot.hh>
+#include <emuframework/EmuApp.hh>
 #include <imagine/data-type/image/sys.hh>
 #include <imagine/pixmap/Pixmap.hh>
 #include <imagine/io/FileIO.hh>
 #include <imagine/fs/sys.hh>
+#include <imagine/base/Pipe.hh>
+#include <imagine/util/thread/pthread.hh>
+
+#ifndef CONFIG_DATA_TYPE_IMAGE_ANDROID
+// converts a row of any packed RGB format to RGB888, expanding components by bit replication
+static void convertRowToRGB888(const IG::Pixmap &pix, uint y, uchar *dest)
+{
+	auto src = pix.getPixel(0, y);
+	if(pix.format.id == PIXEL_RGB565)
+	{
+		auto srcPix = (const uint16*)src;
+		iterateTimes(pix.x, x)
+		{
+			uint pixVal = srcPix[x];
+			uint r = pixVal >> 11, g = (pixVal >> 5) & 0x3f, b = pixVal & 0x1f;
+			*(dest++) = (r << 3) | (r >> 2);
+			*(dest++) = (g << 2) | (g >> 4);
+			*(dest++) = (b << 3) | (b >> 2);
+		}
+		return;
+	}
+	auto &format = pix.format;
+	auto expand =
+		[](uint c, uint bits) -> uchar
+		{
+			if(bits >= 8)
+				return c >> (bits - 8);
+			return (c * 255) / ((1 << bits) - 1);
+		};
+	iterateTimes(pix.x, x)
+	{
+		uint pixVal;
+		switch(format.bytesPerPixel)
+		{
+			bcase 2: pixVal = ((const uint16*)src)[x];
+			bcase 3: pixVal = ((const uchar*)src)[x*3] | (((const uchar*)src)[x*3+1] << 8) | (((const uchar*)src)[x*3+2] << 16);
+			bcase 4: pixVal = ((const uint32*)src)[x];
+			bdefault: pixVal = ((const uchar*)src)[x];
+		}
+		if(format.isGrayscale())
+		{
+			auto i = expand(format.r(pixVal), format.rBits);
+			*(dest++) = i;
+			*(dest++) = i;
+			*(dest++) = i;
+			continue;
+		}
+		*(dest++) = expand(format.r(pixVal), format.rBits);
+		*(dest++) = expand(format.g(pixVal), format.gBits);
+		*(dest++) = expand(format.b(pixVal), format.bBits);
+	}
+}
+#endif
 
 #ifdef CONFIG_DATA_TYPE_IMAGE_QUARTZ2D
 
 bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 {
-	auto screen = vidPix.data;
-	auto tempImgBuff = (char*)mem_alloc(vidPix.x * vidPix.y * 3);
 	IG::Pixmap tempPix(PixelFormatRGB888);
-	tempPix.init(tempImgBuff, vidPix.x, vidPix.y);
-	for(uint y = 0; y < vidPix.y; y++, screen += vidPix.pitch, tempImgBuff += tempPix.pitch)
+	tempPix.init(mem_alloc(vidPix.x * vidPix.y * 3), vidPix.x, vidPix.y);
+	iterateTimes(vidPix.y, y)
 	{
-		auto rowpix = tempImgBuff;
-		for(uint x = 0; x < vidPix.x; x++)
-		{
-			// assumes RGB565
-			uint16 pixVal = *(uint16 *)(screen+2*x);
-			uint32 r = pixVal >> 11, g = (pixVal >> 5) & 0x3f, b = pixVal & 0x1f;
-			r *= 8; g *= 4; b *= 8;
-			*(rowpix++) = r;
-			*(rowpix++) = g;
-			*(rowpix++) = b;
-		}
+		convertRowToRGB888(vidPix, y, (uchar*)tempPix.getPixel(0, y));
 	}
 	Quartz2dImage::writeImage(tempPix, fname);
 	mem_free(tempPix.data);
@@ -53,7 +96,7 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 namespace Base
 {
 
-JNIEnv* jEnv(); // JNIEnv of main event thread
+extern JavaVM* jVM;
 extern jclass jBaseActivityCls;
 extern jobject jBaseActivity;
 
@@ -64,7 +107,13 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 	static JavaInstMethod<jobject> jMakeBitmap;
 	static JavaInstMethod<jobject> jWritePNG;
 	using namespace Base;
-	auto env = jEnv();
+	// called from the screenshot thread, already attached after the first call
+	JNIEnv *env;
+	if(jVM->AttachCurrentThread(&env, 0) != 0)
+	{
+		logErr("error attaching env to thread");
+		return false;
+	}
 	if(!jMakeBitmap)
 	{
 		jMakeBitmap.setup(env, jBaseActivityCls, "makeBitmap", "(III)Landroid/graphics/Bitmap;");
@@ -161,29 +210,10 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 	//png_set_packing(pngPtr);
 
 	png_byte *rowPtr= (png_byte*)mem_alloc(png_get_rowbytes(pngPtr, infoPtr));
-	auto screen = vidPix.data;
-	for(uint y=0; y < vidPix.y; y++, screen+=vidPix.pitch)
+	iterateTimes(vidPix.y, y)
 	{
-		png_byte *rowpix = rowPtr;
-		for(uint x=0; x < vidPix.x; x++)
-		{
-			// assumes RGB565
-			uint16 pixVal = *(uint16 *)(screen+2*x);
-			uint32 r = pixVal >> 11, g = (pixVal >> 5) & 0x3f, b = pixVal & 0x1f;
-			r *= 8; g *= 4; b *= 8;
-			*(rowpix++) = r;
-			*(rowpix++) = g;
-			*(rowpix++) = b;
-			if(imgwidth!=vidPix.x)
-			{
-				*(rowpix++) = r;
-				*(rowpix++) = g;
-				*(rowpix++) = b;
-			}
-		}
+		convertRowToRGB888(vidPix, y, rowPtr);
 		png_write_row(pngPtr, rowPtr);
-		if(imgheight!=vidPix.y)
-			png_write_row(pngPtr, rowPtr);
 	}
 
 	mem_free(rowPtr);
@@ -196,3 +226,135 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 }
 
 #endif
+
+// Captured frames are copied into a small ring of buffers on the main thread, the
+// writer thread then converts, encodes and writes them in order and reports
+// each result back through a pipe so the popup is only touched from the main thread
+
+namespace
+{
+
+struct ScreenshotJob
+{
+	IG::Pixmap pix{PixelFormatRGB565};
+	char *buffer = nullptr;
+	uint bufferSize = 0;
+	FsSys::PathString path{};
+	int num = -1;
+	bool quiet = false;
+};
+
+struct ScreenshotResult
+{
+	int num;
+	bool ok;
+	bool quiet;
+};
+
+}
+
+static constexpr uint MAX_PENDING_SCREENSHOTS = 4;
+static ScreenshotJob job[MAX_PENDING_SCREENSHOTS];
+static uint jobStart = 0, jobCount = 0; // ring of pending jobs, guarded by jobMutex
+static uint jobsInFlight = 0; // main thread only, includes results not yet read from the pipe
+static int lastQueuedNum = -1;
+static ThreadPThread writerThread;
+static MutexPThread jobMutex;
+static CondVarPThread jobCond;
+static Base::Pipe resultPipe;
+
+static ptrsize writerThreadFunc(ThreadPThread &thread)
+{
+	for(;;)
+	{
+		jobMutex.lock();
+		while(!jobCount)
+			jobCond.wait(jobMutex);
+		auto &j = job[jobStart];
+		jobMutex.unlock();
+
+		ScreenshotResult res{j.num, writeScreenshot(j.pix, j.path.data()), j.quiet};
+
+		jobMutex.lock();
+		jobStart = (jobStart + 1) % MAX_PENDING_SCREENSHOTS;
+		jobCount--;
+		jobMutex.unlock();
+		resultPipe.write(&res, sizeof(res));
+	}
+	return 0;
+}
+
+static bool initWriterThread()
+{
+	if(writerThread.running)
+		return true;
+	if(!jobMutex.create() || !jobCond.init())
+		return false;
+	resultPipe.init(
+		[](Base::Pipe &pipe)
+		{
+			while(pipe.hasData())
+			{
+				ScreenshotResult res;
+				if(!pipe.read(&res, sizeof(res)))
+				{
+					logErr("error reading screenshot result");
+					return 0;
+				}
+				assert(jobsInFlight);
+				jobsInFlight--;
+				if(!res.ok)
+					popup.printf(2, 1, "Error writing screenshot #%d", res.num);
+				else if(!res.quiet)
+					popup.printf(2, 0, "Wrote screenshot #%d", res.num);
+			}
+			return 1;
+		});
+	return writerThread.create(1, writerThreadFunc);
+}
+
+int queueScreenshot(const IG::Pixmap &vidPix, bool quiet)
+{
+	if(!initWriterThread())
+	{
+		popup.postError("Unable to start screenshot thread");
+		return -1;
+	}
+	if(jobsInFlight == MAX_PENDING_SCREENSHOTS)
+	{
+		logMsg("no free screenshot buffers");
+		return -1;
+	}
+	FsSys::PathString path;
+	// skip numbers already reserved by jobs that haven't reached the disk yet
+	int num = sprintScreenshotFilename(path, jobsInFlight ? lastQueuedNum + 1 : 0);
+	if(num == -1)
+	{
+		popup.postError("Too many screenshots");
+		return -1;
+	}
+
+	jobMutex.lock();
+	auto &j = job[(jobStart + jobCount) % MAX_PENDING_SCREENSHOTS];
+	jobMutex.unlock();
+	uint size = vidPix.x * vidPix.y * vidPix.format.bytesPerPixel;
+	if(j.bufferSize < size)
+	{
+		j.buffer = (char*)mem_realloc(j.buffer, size);
+		j.bufferSize = size;
+	}
+	new(&j.pix) IG::Pixmap(vidPix.format);
+	j.pix.init(j.buffer, vidPix.x, vidPix.y);
+	vidPix.copy(0, 0, 0, 0, j.pix, 0, 0);
+	j.path = path;
+	j.num = num;
+	j.quiet = quiet;
+
+	jobMutex.lock();
+	jobCount++;
+	jobCond.signal();
+	jobMutex.unlock();
+	jobsInFlight++;
+	lastQueuedNum = num;
+	return num;
+}
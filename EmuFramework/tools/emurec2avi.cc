@@ -0,0 +1,564 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+// Converts a gameplay recording (.emurec + .wav sidecar) into an uncompressed
+// AVI (BGR24 video, PCM audio) that any editor or ffmpeg can read.
+// Output is OpenDML (AVI 2.0): the movie is split into RIFF segments of up to
+// 1 GB, each with its own standard index, referenced from an indx super index
+// per stream. The first segment also carries an idx1 for AVI 1.0 readers.
+// Build with: make (see Makefile in this directory, also built by EmuFramework's "tools" target)
+// Usage: emurec2avi game.000.emurec [out.avi]
+//
+// Frames missing from the recording (skipped or dropped) are filled by repeating
+// the previous frame so the output keeps the emulated frame rate. If frames vary
+// in size they are placed at the top-left of a canvas sized to the largest one.
+
+#define _FILE_OFFSET_BITS 64
+#include <emuframework/RecordingFormat.hh>
+#include <stdio.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Recording;
+
+// RIFF sizes are 32-bit, keep every segment well below that
+// (build with a small AVI_SEGMENT_LIMIT to test segmenting on short recordings)
+#ifndef AVI_SEGMENT_LIMIT
+#define AVI_SEGMENT_LIMIT (1u << 30)
+#endif
+static const uint64_t segmentLimit = AVI_SEGMENT_LIMIT;
+// super index entries reserved per stream, one per segment
+static const uint32_t maxSegments = 1024;
+
+struct IndexEntry
+{
+	char id[4];
+	uint32_t flags;
+	uint32_t offset;
+	uint32_t size;
+};
+
+// entry of a standard (ix##) index, the offset is to the chunk data from the segment's base
+struct StdIndexEntry
+{
+	uint32_t offset;
+	uint32_t size;
+};
+
+struct SuperIndexEntry
+{
+	uint64_t offset;
+	uint32_t size;
+	uint32_t duration;
+};
+
+struct StreamIndex
+{
+	const char *chunkId;
+	const char *indexId;
+	off_t superIndexPos;
+	uint32_t durationDiv; // bytes per stream tick, 0 if each chunk is one tick
+	uint32_t segmentDuration;
+	std::vector<StdIndexEntry> segment;
+	std::vector<SuperIndexEntry> super;
+};
+
+[[noreturn]] static void fail(const char *msg)
+{
+	fprintf(stderr, "%s\n", msg);
+	exit(1);
+}
+
+static void put32(FILE *f, uint32_t v)
+{
+	uint8_t b[4] {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+	fwrite(b, 1, 4, f);
+}
+
+static void put64(FILE *f, uint64_t v)
+{
+	put32(f, v);
+	put32(f, v >> 32);
+}
+
+static void put16(FILE *f, uint16_t v)
+{
+	uint8_t b[2] {(uint8_t)v, (uint8_t)(v >> 8)};
+	fwrite(b, 1, 2, f);
+}
+
+static void putId(FILE *f, const char *id)
+{
+	fwrite(id, 1, 4, f);
+}
+
+// writes a chunk id and placeholder size, returns the position to patch
+static off_t beginChunk(FILE *f, const char *id, const char *listType = nullptr)
+{
+	putId(f, id);
+	off_t pos = ftello(f);
+	put32(f, 0);
+	if(listType)
+		putId(f, listType);
+	return pos;
+}
+
+static void endChunk(FILE *f, off_t sizePos)
+{
+	off_t end = ftello(f);
+	if(end - sizePos - 4 > (off_t)UINT32_MAX)
+		fail("chunk too large for a 32-bit RIFF size");
+	fseeko(f, sizePos, SEEK_SET);
+	put32(f, end - sizePos - 4);
+	fseeko(f, end, SEEK_SET);
+	if((end - sizePos) & 1)
+		fputc(0, f);
+}
+
+static uint8_t expand8(uint32_t c, uint32_t bits)
+{
+	if(!bits)
+		return 0;
+	if(bits >= 8)
+		return c >> (bits - 8);
+	return (c * 255) / ((1u << bits) - 1);
+}
+
+// converts a frame to a bottom-up BGR24 canvas as used by AVI DIBs
+static void convertFrame(const FrameHeader &h, const uint8_t *src, std::vector<uint8_t> &canvas, uint32_t width, uint32_t height)
+{
+	uint32_t stride = (width * 3 + 3) & ~3u;
+	for(uint32_t y = 0; y < h.height; y++)
+	{
+		auto dest = &canvas[(height - 1 - y) * stride];
+		auto line = src + y * h.width * h.bytesPerPixel;
+		for(uint32_t x = 0; x < h.width; x++)
+		{
+			uint32_t p = 0;
+			memcpy(&p, line + x * h.bytesPerPixel, h.bytesPerPixel); // recordings are little-endian
+			*dest++ = expand8((p >> h.bShift) & ((1u << h.bBits) - 1), h.bBits);
+			*dest++ = expand8((p >> h.gShift) & ((1u << h.gBits) - 1), h.gBits);
+			*dest++ = expand8((p >> h.rShift) & ((1u << h.rBits) - 1), h.rBits);
+		}
+	}
+}
+
+static bool readWav(FILE *f, WavHeader &fmt, off_t &dataPos, uint32_t &dataSize)
+{
+	char id[4];
+	uint32_t size;
+	if(fread(id, 1, 4, f) != 4 || memcmp(id, "RIFF", 4) || fread(&size, 4, 1, f) != 1
+		|| fread(id, 1, 4, f) != 4 || memcmp(id, "WAVE", 4))
+		return false;
+	bool haveFmt = false;
+	while(fread(id, 1, 4, f) == 4 && fread(&size, 4, 1, f) == 1)
+	{
+		if(!memcmp(id, "fmt ", 4) && size >= 16)
+		{
+			if(fread(&fmt.formatTag, 1, 16, f) != 16)
+				return false;
+			fseeko(f, size - 16, SEEK_CUR);
+			haveFmt = true;
+		}
+		else if(!memcmp(id, "data", 4))
+		{
+			dataPos = ftello(f);
+			// the recorder patches the size on stop, fall back to the file length if it didn't
+			fseeko(f, 0, SEEK_END);
+			uint32_t avail = std::min(ftello(f) - dataPos, (off_t)UINT32_MAX);
+			dataSize = size && size <= avail ? size : avail;
+			return haveFmt;
+		}
+		else
+			fseeko(f, size + (size & 1), SEEK_CUR);
+	}
+	return false;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s recording.emurec [out.avi]\n", argv[0]);
+		return 1;
+	}
+	std::string inPath = argv[1];
+	std::string base = inPath.substr(0, inPath.rfind('.'));
+	std::string outPath = argc > 2 ? argv[2] : base + ".avi";
+
+	FILE *in = fopen(inPath.c_str(), "rb");
+	if(!in)
+	{
+		fprintf(stderr, "can't open %s\n", inPath.c_str());
+		return 1;
+	}
+	FileHeader fileHeader;
+	if(fread(&fileHeader, sizeof(fileHeader), 1, in) != 1 || memcmp(fileHeader.magic, MAGIC, sizeof(MAGIC))
+		|| fileHeader.version != VERSION)
+	{
+		fprintf(stderr, "%s isn't a supported recording\n", inPath.c_str());
+		return 1;
+	}
+
+	// first pass finds the canvas size
+	uint32_t width = 0, height = 0, frames = 0;
+	off_t firstFramePos = ftello(in);
+	FrameHeader h;
+	while(fread(&h, sizeof(h), 1, in) == 1)
+	{
+		width = std::max(width, (uint32_t)h.width);
+		height = std::max(height, (uint32_t)h.height);
+		frames++;
+		fseeko(in, h.packedSize, SEEK_CUR);
+	}
+	if(!frames)
+	{
+		fprintf(stderr, "recording has no frames\n");
+		return 1;
+	}
+
+	WavHeader wav {};
+	off_t wavDataPos = 0;
+	uint32_t wavDataSize = 0;
+	FILE *wavFile = fopen((base + ".wav").c_str(), "rb");
+	if(wavFile && !readWav(wavFile, wav, wavDataPos, wavDataSize))
+	{
+		fprintf(stderr, "ignoring unreadable audio sidecar\n");
+		fclose(wavFile);
+		wavFile = nullptr;
+	}
+	bool hasAudio = wavFile && wav.blockAlign;
+
+	FILE *out = fopen(outPath.c_str(), "wb");
+	if(!out)
+	{
+		fprintf(stderr, "can't create %s\n", outPath.c_str());
+		return 1;
+	}
+	uint32_t stride = (width * 3 + 3) & ~3u;
+	uint32_t frameBytes = stride * height;
+	uint32_t fps = fileHeader.frameRate;
+
+	StreamIndex streams[2] {{"00db", "ix00", 0, 0, 0, {}, {}}, {"01wb", "ix01", 0, wav.blockAlign, 0, {}, {}}};
+	auto &videoIndex = streams[0];
+	auto &audioIndex = streams[1];
+	int streamCount = hasAudio ? 2 : 1;
+
+	// super index with room for maxSegments entries, filled in at the end
+	auto writeSuperIndex =
+		[&](StreamIndex &s)
+		{
+			putId(out, "indx");
+			put32(out, 24 + maxSegments * 16);
+			put16(out, 4); // longs per entry
+			fputc(0, out); // sub type
+			fputc(0, out); // AVI_INDEX_OF_INDEXES
+			s.superIndexPos = ftello(out);
+			put32(out, 0); // entries in use
+			putId(out, s.chunkId);
+			for(uint32_t i = 0; i < 3 + maxSegments * 4; i++)
+				put32(out, 0);
+		};
+
+	auto riffPos = beginChunk(out, "RIFF", "AVI ");
+	auto hdrlPos = beginChunk(out, "LIST", "hdrl");
+	putId(out, "avih");
+	put32(out, 56);
+	put32(out, 1000000 / fps);
+	put32(out, frameBytes * fps);
+	put32(out, 0);
+	put32(out, 0x10); // AVIF_HASINDEX
+	off_t totalFramesPos = ftello(out);
+	put32(out, 0); // frames in the first segment, patched later
+	put32(out, 0);
+	put32(out, streamCount);
+	put32(out, frameBytes);
+	put32(out, width);
+	put32(out, height);
+	for(int i = 0; i < 4; i++)
+		put32(out, 0);
+
+	auto strlPos = beginChunk(out, "LIST", "strl");
+	putId(out, "strh");
+	put32(out, 56);
+	putId(out, "vids");
+	putId(out, "DIB ");
+	put32(out, 0); put16(out, 0); put16(out, 0); put32(out, 0);
+	put32(out, 1); // scale
+	put32(out, fps); // rate
+	put32(out, 0);
+	off_t videoLengthPos = ftello(out);
+	put32(out, 0); // length, patched later
+	put32(out, frameBytes);
+	put32(out, 0xFFFFFFFF);
+	put32(out, 0);
+	put16(out, 0); put16(out, 0); put16(out, width); put16(out, height);
+	putId(out, "strf");
+	put32(out, 40);
+	put32(out, 40);
+	put32(out, width);
+	put32(out, height);
+	put16(out, 1);
+	put16(out, 24);
+	put32(out, 0); // BI_RGB
+	put32(out, frameBytes);
+	for(int i = 0; i < 4; i++)
+		put32(out, 0);
+	writeSuperIndex(videoIndex);
+	endChunk(out, strlPos);
+
+	off_t audioLengthPos = 0;
+	if(hasAudio)
+	{
+		strlPos = beginChunk(out, "LIST", "strl");
+		putId(out, "strh");
+		put32(out, 56);
+		putId(out, "auds");
+		put32(out, 0);
+		put32(out, 0); put16(out, 0); put16(out, 0); put32(out, 0);
+		put32(out, wav.blockAlign); // scale
+		put32(out, wav.bytesPerSec); // rate
+		put32(out, 0);
+		audioLengthPos = ftello(out);
+		put32(out, 0);
+		put32(out, wav.bytesPerSec);
+		put32(out, 0xFFFFFFFF);
+		put32(out, wav.blockAlign);
+		put16(out, 0); put16(out, 0); put16(out, 0); put16(out, 0);
+		putId(out, "strf");
+		put32(out, 16);
+		fwrite(&wav.formatTag, 1, 16, out);
+		writeSuperIndex(audioIndex);
+		endChunk(out, strlPos);
+	}
+
+	auto odmlPos = beginChunk(out, "LIST", "odml");
+	putId(out, "dmlh");
+	put32(out, 248);
+	off_t dmlhFramesPos = ftello(out);
+	for(int i = 0; i < 62; i++)
+		put32(out, 0); // total frames, patched later
+	endChunk(out, odmlPos);
+	endChunk(out, hdrlPos);
+
+	bool firstSegment = true;
+	auto moviPos = beginChunk(out, "LIST", "movi");
+	off_t moviStart = moviPos + 4; // index offsets are relative to the 'movi' fourcc
+	std::vector<IndexEntry> index;
+	uint32_t firstSegmentFrames = 0;
+
+	// writes the segment's standard indexes and closes its movi list and RIFF
+	auto endSegment =
+		[&]()
+		{
+			for(int i = 0; i < streamCount; i++)
+			{
+				auto &s = streams[i];
+				if(s.segment.empty())
+					continue;
+				if(s.super.size() == maxSegments)
+					fail("too many segments for the super index");
+				off_t pos = ftello(out);
+				uint32_t size = 24 + s.segment.size() * 8;
+				putId(out, s.indexId);
+				put32(out, size);
+				put16(out, 2); // longs per entry
+				fputc(0, out); // sub type
+				fputc(1, out); // AVI_INDEX_OF_CHUNKS
+				put32(out, s.segment.size());
+				putId(out, s.chunkId);
+				put64(out, moviStart);
+				put32(out, 0);
+				for(auto &e : s.segment)
+				{
+					put32(out, e.offset);
+					put32(out, e.size); // bit 31 clear: every chunk is a key frame
+				}
+				s.super.push_back({(uint64_t)pos, size + 8, s.segmentDuration});
+				s.segment.clear();
+				s.segmentDuration = 0;
+			}
+			endChunk(out, moviPos);
+			if(firstSegment)
+			{
+				putId(out, "idx1");
+				put32(out, index.size() * sizeof(IndexEntry));
+				for(auto &e : index)
+				{
+					putId(out, e.id);
+					put32(out, e.flags);
+					put32(out, e.offset);
+					put32(out, e.size);
+				}
+				firstSegment = false;
+			}
+			endChunk(out, riffPos);
+		};
+
+	auto writeChunk =
+		[&](StreamIndex &s, const uint8_t *data, uint32_t size, uint32_t flags)
+		{
+			// space for this chunk plus the indexes that still have to go in the segment
+			uint64_t pending = 8 + size + (size & 1) + 16;
+			for(int i = 0; i < streamCount; i++)
+				pending += 32 + (streams[i].segment.size() + 1) * 8;
+			if(firstSegment)
+				pending += 8 + (index.size() + 1) * sizeof(IndexEntry);
+			if(ftello(out) - riffPos + pending > segmentLimit)
+			{
+				if(videoIndex.segment.empty() && audioIndex.segment.empty())
+					fail("chunk too large for an AVI segment");
+				endSegment();
+				riffPos = beginChunk(out, "RIFF", "AVIX");
+				moviPos = beginChunk(out, "LIST", "movi");
+				moviStart = moviPos + 4;
+			}
+			off_t pos = ftello(out);
+			if(firstSegment)
+			{
+				index.push_back({{s.chunkId[0], s.chunkId[1], s.chunkId[2], s.chunkId[3]}, flags, (uint32_t)(pos - moviStart), size});
+				if(&s == &videoIndex)
+					firstSegmentFrames++;
+			}
+			s.segment.push_back({(uint32_t)(pos + 8 - moviStart), size});
+			s.segmentDuration += s.durationDiv ? size / s.durationDiv : 1;
+			putId(out, s.chunkId);
+			put32(out, size);
+			fwrite(data, 1, size, out);
+			if(size & 1)
+				fputc(0, out);
+		};
+
+	std::vector<uint8_t> frame, prevFrame, packed, canvas(frameBytes), audio;
+	uint32_t audioPos = 0, audioBytesOut = 0;
+	// audio goes out in chunks of at most a second
+	uint32_t maxAudioChunk = std::max(wav.bytesPerSec - wav.bytesPerSec % std::max((uint32_t)wav.blockAlign, 1u), (uint32_t)wav.blockAlign);
+	auto writeAudioUpTo =
+		[&](uint32_t audioFrames)
+		{
+			if(!hasAudio)
+				return;
+			uint32_t end = std::min((uint64_t)audioFrames * wav.blockAlign, (uint64_t)wavDataSize);
+			while(end > audioPos)
+			{
+				audio.resize(std::min(end - audioPos, maxAudioChunk));
+				fseeko(wavFile, wavDataPos + audioPos, SEEK_SET);
+				if(fread(audio.data(), 1, audio.size(), wavFile) != audio.size())
+					return;
+				writeChunk(audioIndex, audio.data(), audio.size(), 0x10);
+				audioBytesOut += audio.size();
+				audioPos += audio.size();
+			}
+		};
+
+	fseeko(in, firstFramePos, SEEK_SET);
+	uint32_t outFrames = 0, firstEmuFrame = 0, lastEmuFrame = 0, corruptFrames = 0;
+	bool haveFrame = false;
+	while(fread(&h, sizeof(h), 1, in) == 1)
+	{
+		packed.resize(h.packedSize);
+		if(fread(packed.data(), 1, h.packedSize, in) != h.packedSize)
+			break;
+		uint32_t size = h.size();
+		frame.resize(size);
+		bool key = h.flags & FRAME_KEY;
+		if(!key && prevFrame.size() != size)
+		{
+			corruptFrames++;
+			continue;
+		}
+		if(!lzDecompress(packed.data(), h.packedSize, frame.data(), size))
+		{
+			corruptFrames++;
+			continue;
+		}
+		if(!key)
+			xorDelta(frame.data(), frame.data(), prevFrame.data(), size);
+		prevFrame = frame;
+
+		// emuFrameNow only advances with automatic frame skip, otherwise assume no gap
+		uint32_t target;
+		if(!haveFrame)
+		{
+			firstEmuFrame = h.emuFrame;
+			target = 0;
+		}
+		else if(h.emuFrame > lastEmuFrame)
+			target = h.emuFrame - firstEmuFrame;
+		else
+			target = outFrames;
+		lastEmuFrame = h.emuFrame;
+
+		// repeat the previous frame to cover skipped or dropped ones
+		while(haveFrame && outFrames < target)
+		{
+			writeChunk(videoIndex, canvas.data(), frameBytes, 0x10);
+			outFrames++;
+		}
+		writeAudioUpTo(h.audioFrames);
+		if(h.width != width || h.height != height)
+			std::fill(canvas.begin(), canvas.end(), 0);
+		convertFrame(h, frame.data(), canvas, width, height);
+		writeChunk(videoIndex, canvas.data(), frameBytes, 0x10);
+		outFrames++;
+		haveFrame = true;
+	}
+	writeAudioUpTo(UINT32_MAX / std::max((uint32_t)wav.blockAlign, 1u));
+	endSegment();
+
+	for(int i = 0; i < streamCount; i++)
+	{
+		auto &s = streams[i];
+		fseeko(out, s.superIndexPos, SEEK_SET);
+		put32(out, s.super.size());
+		fseeko(out, 4 + 12, SEEK_CUR);
+		for(auto &e : s.super)
+		{
+			put64(out, e.offset);
+			put32(out, e.size);
+			put32(out, e.duration);
+		}
+	}
+	fseeko(out, totalFramesPos, SEEK_SET);
+	put32(out, firstSegmentFrames);
+	fseeko(out, videoLengthPos, SEEK_SET);
+	put32(out, outFrames);
+	fseeko(out, dmlhFramesPos, SEEK_SET);
+	put32(out, outFrames);
+	if(hasAudio)
+	{
+		fseeko(out, audioLengthPos, SEEK_SET);
+		put32(out, audioBytesOut / wav.blockAlign);
+	}
+	bool writeError = ferror(out);
+	if(fclose(out) || writeError)
+	{
+		fprintf(stderr, "error writing %s\n", outPath.c_str());
+		return 1;
+	}
+	fclose(in);
+	if(wavFile)
+		fclose(wavFile);
+	printf("wrote %s: %ux%u, %u frames from %u recorded", outPath.c_str(), width, height, outFrames, frames);
+	if(videoIndex.super.size() > 1)
+		printf(", %u segments", (uint32_t)videoIndex.super.size());
+	if(corruptFrames)
+		printf(", %u corrupt frames skipped", corruptFrames);
+	printf("\n");
+	return 0;
+}
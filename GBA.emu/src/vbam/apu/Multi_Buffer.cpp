@@ -15,6 +15,12 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 
 #include "blargg_source.h"
 
+#if defined (__SSE2__)
+	#include <emmintrin.h>
+#elif defined (__ARM_NEON__)
+	#include <arm_neon.h>
+#endif
+
 #ifdef BLARGG_ENABLE_OPTIMIZER
 	#include BLARGG_ENABLE_OPTIMIZER
 #endif
@@ -237,6 +243,95 @@ void Stereo_Mixer::mix_mono( blip_sample_t* out_, int count )
 	BLIP_READER_END( center, *bufs [2] );
 }
 
+#if defined (__SSE2__) || defined (__ARM_NEON__)
+
+// Each integrator is a serial recurrence, so left, right and center share a
+// vector and advance together. Saturating packs match BLIP_CLAMP since the
+// shifted sum always fits in 18 bits.
+void Stereo_Mixer::mix_stereo( blip_sample_t* out, int count )
+{
+	int const bass = BLIP_READER_BASS( *bufs [2] );
+	Blip_Buffer::buf_t_ const* BLIP_RESTRICT in_l = bufs [0]->buffer_ + samples_read - count;
+	Blip_Buffer::buf_t_ const* BLIP_RESTRICT in_r = bufs [1]->buffer_ + samples_read - count;
+	Blip_Buffer::buf_t_ const* BLIP_RESTRICT in_c = bufs [2]->buffer_ + samples_read - count;
+	blip_long accum_l = bufs [0]->reader_accum_;
+	blip_long accum_r = bufs [1]->reader_accum_;
+	blip_long accum_c = bufs [2]->reader_accum_;
+	int n = 0;
+
+	#if defined (__SSE2__)
+		// lanes hold left, right, center and an unused zero
+		__m128i accum = _mm_unpacklo_epi64(
+				_mm_unpacklo_epi32( _mm_cvtsi32_si128( accum_l ), _mm_cvtsi32_si128( accum_r ) ),
+				_mm_cvtsi32_si128( accum_c ) );
+		__m128i const bass_shift = _mm_cvtsi32_si128( bass );
+		#define BLIP_STEREO_STEP( s, in ) \
+			__m128i s = _mm_srai_epi32( _mm_add_epi32( accum, _mm_shuffle_epi32( accum, 0xAA ) ), blip_sample_bits - 16 );\
+			accum = _mm_add_epi32( accum, _mm_sub_epi32( (in), _mm_sra_epi32( accum, bass_shift ) ) )
+		for ( ; n + 4 <= count; n += 4 )
+		{
+			__m128i l = _mm_loadu_si128( (__m128i const*) (in_l + n) );
+			__m128i r = _mm_loadu_si128( (__m128i const*) (in_r + n) );
+			__m128i c = _mm_loadu_si128( (__m128i const*) (in_c + n) );
+			__m128i lr01 = _mm_unpacklo_epi32( l, r );
+			__m128i lr23 = _mm_unpackhi_epi32( l, r );
+			__m128i c01  = _mm_unpacklo_epi32( c, _mm_setzero_si128() );
+			__m128i c23  = _mm_unpackhi_epi32( c, _mm_setzero_si128() );
+			BLIP_STEREO_STEP( s0, _mm_unpacklo_epi64( lr01, c01 ) );
+			BLIP_STEREO_STEP( s1, _mm_unpackhi_epi64( lr01, c01 ) );
+			BLIP_STEREO_STEP( s2, _mm_unpacklo_epi64( lr23, c23 ) );
+			BLIP_STEREO_STEP( s3, _mm_unpackhi_epi64( lr23, c23 ) );
+			_mm_storeu_si128( (__m128i*) (out + n * stereo), _mm_packs_epi32(
+					_mm_unpacklo_epi64( s0, s1 ), _mm_unpacklo_epi64( s2, s3 ) ) );
+		}
+		#undef BLIP_STEREO_STEP
+		accum_l = _mm_cvtsi128_si32( accum );
+		accum_r = _mm_cvtsi128_si32( _mm_srli_si128( accum, 4 ) );
+		accum_c = _mm_cvtsi128_si32( _mm_srli_si128( accum, 8 ) );
+	#else
+		// left and right in one vector, center is scalar and added to both
+		int32x2_t accum = vset_lane_s32( accum_r, vdup_n_s32( accum_l ), 1 );
+		int32x2_t const bass_shift = vdup_n_s32( -bass );
+		#define BLIP_STEREO_STEP( s, in, c ) \
+			int32x2_t s = vshr_n_s32( vadd_s32( accum, vdup_n_s32( accum_c ) ), blip_sample_bits - 16 );\
+			accum = vadd_s32( accum, vsub_s32( (in), vshl_s32( accum, bass_shift ) ) );\
+			accum_c += (c) - (accum_c >> bass)
+		for ( ; n + 4 <= count; n += 4 )
+		{
+			int32x4x2_t in = vzipq_s32( vld1q_s32( (int32_t const*) (in_l + n) ),
+					vld1q_s32( (int32_t const*) (in_r + n) ) );
+			BLIP_STEREO_STEP( s0, vget_low_s32( in.val [0] ), in_c [n] );
+			BLIP_STEREO_STEP( s1, vget_high_s32( in.val [0] ), in_c [n + 1] );
+			BLIP_STEREO_STEP( s2, vget_low_s32( in.val [1] ), in_c [n + 2] );
+			BLIP_STEREO_STEP( s3, vget_high_s32( in.val [1] ), in_c [n + 3] );
+			vst1q_s16( out + n * stereo, vcombine_s16( vqmovn_s32( vcombine_s32( s0, s1 ) ),
+					vqmovn_s32( vcombine_s32( s2, s3 ) ) ) );
+		}
+		#undef BLIP_STEREO_STEP
+		accum_l = vget_lane_s32( accum, 0 );
+		accum_r = vget_lane_s32( accum, 1 );
+	#endif
+
+	for ( ; n < count; n++ )
+	{
+		blargg_long l = (blargg_long) (accum_c + accum_l) >> (blip_sample_bits - 16);
+		blargg_long r = (blargg_long) (accum_c + accum_r) >> (blip_sample_bits - 16);
+		BLIP_CLAMP( l, l );
+		BLIP_CLAMP( r, r );
+		out [n * stereo    ] = (blip_sample_t) l;
+		out [n * stereo + 1] = (blip_sample_t) r;
+		accum_l += in_l [n] - (accum_l >> bass);
+		accum_r += in_r [n] - (accum_r >> bass);
+		accum_c += in_c [n] - (accum_c >> bass);
+	}
+
+	bufs [0]->reader_accum_ = accum_l;
+	bufs [1]->reader_accum_ = accum_r;
+	bufs [2]->reader_accum_ = accum_c;
+}
+
+#else
+
 void Stereo_Mixer::mix_stereo( blip_sample_t* out_, int count )
 {
 	blip_sample_t* BLIP_RESTRICT out = out_ + count * stereo;
@@ -279,3 +374,5 @@ void Stereo_Mixer::mix_stereo( blip_sample_t* out_, int count )
 		break;
 	}
 }
+
+#endif
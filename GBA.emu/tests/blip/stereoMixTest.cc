@@ -0,0 +1,88 @@
+/*  This file is part of GBA.emu.
+
+	GBA.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	GBA.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with GBA.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Feeds a Stereo_Buffer random deltas and writes the mixed output to the
+// file given on the command line. The Makefile runs a SIMD and a scalar
+// build of Stereo_Mixer::mix_stereo() and compares the two files.
+// Some stretches only touch the center channel to exercise the mono path
+// and its transitions, and some frames are overdriven to exercise clamping
+
+#include "apu/Multi_Buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+static const int frames = 3000;
+
+int main(int argc, char **argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s output-file\n", argv[0]);
+		return 1;
+	}
+	FILE *f = fopen(argv[1], "wb");
+	if(!f)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	Stereo_Buffer buff;
+	buff.set_sample_rate(44100, 100);
+	buff.clock_rate(4194304 * 4);
+	buff.bass_freq(20);
+	Blip_Synth<blip_good_quality, 1> synth[3];
+	Tracked_Blip_Buffer *chan[3] = {(Tracked_Blip_Buffer*)buff.left(),
+		(Tracked_Blip_Buffer*)buff.right(), (Tracked_Blip_Buffer*)buff.center()};
+	for(int c = 0; c < 3; c++)
+	{
+		synth[c].output(chan[c]);
+		synth[c].volume(c == 2 ? 0.06 : 0.04);
+	}
+	srand(7);
+	double mixTime = 0;
+	for(int frame = 0; frame < frames; frame++)
+	{
+		const int clocks = 280896;
+		bool mono = frame % 500 < 100;
+		bool clip = frame % 250 < 4;
+		for(int c = 0; c < 3; c++)
+		{
+			if(mono && c != 2)
+				continue;
+			for(int t = 0; t < clocks; t += 1 + rand() % 800)
+			{
+				int amp = (rand() % 24) - 12;
+				if(clip)
+					amp *= 40;
+				synth[c].update(t, amp);
+				chan[c]->set_modified();
+			}
+		}
+		buff.end_frame(clocks);
+		// leave a varying remainder in the buffer between frames
+		blip_sample_t out[8000];
+		long want = (buff.samples_avail() & ~1) - ((frame % 7) * 2);
+		if(want < 0)
+			want = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		long samples = buff.read_samples(out, want);
+		mixTime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+		fwrite(out, sizeof(blip_sample_t), samples, f);
+	}
+	fclose(f);
+	printf("%s: read_samples %.2fus/frame\n", argv[0], mixTime / frames);
+	return 0;
+}
@@ -287,6 +287,14 @@ struct M68KCPU
   uint endCycles = 0;
   _m68k_memory_map memory_map[256];
 
+#if M68K_IDLE_LOOP_SKIP
+  bool idleLoopSkip = 1;       /* Run out idle loops, can be turned off for accuracy testing */
+  bool idleLoopRejected = 0;   /* Last loop didn't match a polling pattern */
+  uint idleLoopPC = 1;         /* Branch that closed the last short loop, odd when none */
+  uint idleLoopCycles = 0;     /* Cycle count when it was last taken */
+  uint idleLoopHits = 0;       /* Number of times a loop was run out */
+#endif
+
   /* Set the IPL0-IPL2 pins on the CPU (IRQ).
    * A transition from < 7 to 7 will cause a non-maskable interrupt (NMI).
    * Setting IRQ to 0 will clear an interrupt request.
@@ -526,6 +534,10 @@ unsigned int m68k_disassemble_raw(char* str_buff, unsigned int pc, const unsigne
 	extern int vdp_68k_irq_ack(M68KCPU &m68ki_cpu, int int_level);
 #endif
 
+#if M68K_IDLE_LOOP_SKIP
+	extern int m68k_idle_read_stable(M68KCPU &m68ki_cpu, unsigned int address, unsigned int size, unsigned int mask);
+#endif
+
 /* ======================================================================== */
 /* ============================== END OF FILE ============================= */
 /* ======================================================================== */
@@ -178,6 +178,16 @@
  */
 #define M68K_CHECK_INFINITE_LOOP  OPT_OFF
 
+/* If ON, short backward Bcc loops that only poll memory (waiting for VBLANK
+ * and such) are detected and run out to the end of the timeslice at once.
+ * Reads from memory with handlers are only skipped if
+ * M68K_IDLE_LOOP_STABLE_READ(CPU, A, S, M) returns non-zero, meaning the bits
+ * in mask M of the S byte read at address A can't change during the timeslice.
+ * Skipping can still be turned off at run-time with the idleLoopSkip flag.
+ */
+#define M68K_IDLE_LOOP_SKIP       OPT_ON
+#define M68K_IDLE_LOOP_STABLE_READ(CPU, A, S, M) m68k_idle_read_stable(CPU, A, S, M)
+
 /* Turn ON to enable logging of illegal instruction calls.
  * M68K_LOG_FILEHANDLE must be #defined to a stdio file stream.
  * Turn on M68K_LOG_1010_1111 to log all 1010 and 1111 calls.
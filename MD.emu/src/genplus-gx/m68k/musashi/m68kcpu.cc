@@ -942,6 +942,11 @@ void m68k_run(M68KCPU &m68ki_cpu, unsigned int cycles)
   /* Save end cycles count for when CPU is stopped */
   m68ki_cpu.endCycles = cycles;
 
+#if M68K_IDLE_LOOP_SKIP
+  /* Memory may have changed since the last timeslice, loops must be seen again */
+  m68ki_cpu.idleLoopPC = 1;
+#endif
+
   while (m68ki_cpu.cycleCount < cycles)//m68ki_cpu.endCycles)
   {
     /* Set tracing accodring to T1. */
@@ -962,6 +967,190 @@ void m68k_run(M68KCPU &m68ki_cpu, unsigned int cycles)
   }
 }
 
+#if M68K_IDLE_LOOP_SKIP
+/* Idle loop detection
+ * A short backward Bcc is checked the second time it is taken in a row within
+ * the same timeslice. If the loop body is one of the polling patterns below
+ * and everything it reads stays the same until the end of the timeslice, each
+ * further iteration would do exactly what the last one did, so the whole
+ * iterations left in the timeslice are skipped by adding their cycles at once.
+ * The last partial one runs normally, so the timeslice ends on the same
+ * instruction and cycle it would have without skipping.
+ *
+ * Recognized bodies, with memory operands in (An), (d16,An), abs.w or abs.l:
+ *   TST, BTST, CMP or CMPI of memory
+ *   MOVE of memory to Dn, optionally followed by TST, BTST, ANDI or CMPI of Dn
+ */
+
+static const uint m68ki_idle_size_mask[3] = { 0xff, 0xffff, 0xffffffff };
+
+/* Decode a memory operand and return the size of its extension words, or -1
+ * for addressing modes that aren't used for polling */
+static int m68ki_idle_loop_ea(M68KCPU &m68ki_cpu, uint op, uint ext, uint *ea)
+{
+  uint reg = op & 7;
+  switch((op >> 3) & 7)
+  {
+    case 2:
+      *ea = REG_A[reg];
+      return 0;
+    case 5:
+      *ea = REG_A[reg] + MAKE_INT_16(m68k_read_immediate_16(m68ki_cpu, ext));
+      return 2;
+    case 7:
+      if(reg == 0)
+      {
+        *ea = MAKE_INT_16(m68k_read_immediate_16(m68ki_cpu, ext));
+        return 2;
+      }
+      if(reg == 1)
+      {
+        *ea = m68k_read_immediate_32(m68ki_cpu, ext);
+        return 4;
+      }
+  }
+  return -1;
+}
+
+static int m68ki_idle_loop_read_stable(M68KCPU &m68ki_cpu, uint ea, uint size, uint mask)
+{
+  _m68k_memory_map *temp = &m68ki_cpu.memory_map[(ea >> 16) & 0xff];
+  if(size > 1 && (ea & 1))
+    return 0;
+  if(!(size == 1 ? temp->read8 : temp->read16))
+    return 1; /* plain memory, only this CPU can change it during the timeslice */
+  return M68K_IDLE_LOOP_STABLE_READ(m68ki_cpu, ADDRESS_68K(ea), size, mask);
+}
+
+static int m68ki_idle_loop_body(M68KCPU &m68ki_cpu, uint pc, uint end)
+{
+  uint op, si, ea, mask, ext;
+  int eaSize;
+
+  if(pc == end)
+    return 1; /* branch to itself */
+
+  op = m68k_read_immediate_16(m68ki_cpu, pc);
+  ext = pc + 2;
+
+  if((op & 0xc1c0) == 0x0000 && (op & 0x3000))
+  {
+    /* MOVE <ea>,Dn */
+    uint dn = (op >> 9) & 7;
+    si = ((op >> 12) == 1) ? 0 : ((op >> 12) == 3) ? 1 : 2;
+    if((eaSize = m68ki_idle_loop_ea(m68ki_cpu, op, ext, &ea)) < 0)
+      return 0;
+    mask = m68ki_idle_size_mask[si];
+    pc = ext + eaSize;
+    if(pc != end)
+    {
+      /* Test of the loaded register, only the bits it looks at must be stable */
+      uint test = m68k_read_immediate_16(m68ki_cpu, pc);
+      uint tsi = (test >> 6) & 3;
+      if((test & 7) != dn)
+        return 0;
+      if((test & 0xff38) == 0x4a00 && tsi != 3) /* TST */
+      {
+        mask &= m68ki_idle_size_mask[tsi];
+        pc += 2;
+      }
+      else if((test & 0xfff8) == 0x0800) /* BTST #n */
+      {
+        mask &= 1 << (m68k_read_immediate_16(m68ki_cpu, pc + 2) & 31);
+        pc += 4;
+      }
+      else if((test & 0xff38) == 0x0200 && tsi != 3) /* ANDI */
+      {
+        mask &= (tsi == 2) ? m68k_read_immediate_32(m68ki_cpu, pc + 2) : m68k_read_immediate_16(m68ki_cpu, pc + 2);
+        mask &= m68ki_idle_size_mask[tsi];
+        pc += (tsi == 2) ? 6 : 4;
+      }
+      else if((test & 0xff38) == 0x0c00 && tsi != 3) /* CMPI */
+      {
+        mask &= m68ki_idle_size_mask[tsi];
+        pc += (tsi == 2) ? 6 : 4;
+      }
+      else
+        return 0;
+    }
+    return pc == end && m68ki_idle_loop_read_stable(m68ki_cpu, ea, 1 << si, mask);
+  }
+
+  if((op & 0xff00) == 0x4a00 && (si = (op >> 6) & 3) != 3) /* TST */
+  {
+    mask = m68ki_idle_size_mask[si];
+  }
+  else if((op & 0xff00) == 0x0c00 && (si = (op >> 6) & 3) != 3) /* CMPI */
+  {
+    mask = m68ki_idle_size_mask[si];
+    ext += (si == 2) ? 4 : 2;
+  }
+  else if((op & 0xffc0) == 0x0800) /* BTST #n */
+  {
+    si = 0;
+    mask = 1 << (m68k_read_immediate_16(m68ki_cpu, ext) & 7);
+    ext += 2;
+  }
+  else if((op & 0xf1c0) == 0x0100) /* BTST Dn */
+  {
+    si = 0;
+    mask = 1 << (REG_D[(op >> 9) & 7] & 7);
+  }
+  else if((op & 0xf000) == 0xb000 && ((op >> 6) & 7) < 3) /* CMP */
+  {
+    si = (op >> 6) & 7;
+    mask = m68ki_idle_size_mask[si];
+  }
+  else
+    return 0;
+
+  if((eaSize = m68ki_idle_loop_ea(m68ki_cpu, op, ext, &ea)) < 0)
+    return 0;
+  return ext + eaSize == end && m68ki_idle_loop_read_stable(m68ki_cpu, ea, 1 << si, mask);
+}
+
+/* Called after a short backward branch was taken, REG_PC is the loop start */
+void m68ki_idle_loop(M68KCPU &m68ki_cpu, int offset)
+{
+  uint branch = REG_PC - offset - 2;
+  uint loopCycles, start, iterations;
+
+  if(branch != m68ki_cpu.idleLoopPC)
+  {
+    m68ki_cpu.idleLoopPC = branch;
+    m68ki_cpu.idleLoopCycles = m68ki_cpu.cycleCount;
+    m68ki_cpu.idleLoopRejected = 0;
+    return;
+  }
+  if(m68ki_cpu.idleLoopRejected)
+    return;
+
+  /* The body ran exactly once since the branch was last taken */
+  loopCycles = m68ki_cpu.cycleCount - m68ki_cpu.idleLoopCycles;
+  m68ki_cpu.idleLoopCycles = m68ki_cpu.cycleCount;
+
+  /* Bcc only, DBcc and BSR also end up here */
+  if((REG_IR & 0xf000) != 0x6000 || (REG_IR & 0x0f00) == 0x0100 || !loopCycles
+    || FLAG_T1 || m68ki_cpu.irqLatency || !m68ki_idle_loop_body(m68ki_cpu, REG_PC, branch))
+  {
+    m68ki_cpu.idleLoopRejected = 1;
+    return;
+  }
+
+  /* Iterations fitting in the timeslice, counting from after this branch's own
+   * cycles */
+  start = m68ki_cpu.cycleCount + CYC_INSTRUCTION[REG_IR];
+  if(start >= m68ki_cpu.endCycles)
+    return;
+  iterations = (m68ki_cpu.endCycles - start) / loopCycles;
+  if(!iterations)
+    return;
+  USE_CYCLES(iterations * loopCycles);
+  m68ki_cpu.idleLoopCycles = m68ki_cpu.cycleCount;
+  m68ki_cpu.idleLoopHits++;
+}
+#endif /* M68K_IDLE_LOOP_SKIP */
+
 #if 0
 int m68k_cycles_run(void)
 {
@@ -592,6 +592,14 @@
   #define m68ki_check_infinite_loop()
 #endif /* M68K_CHECK_INFINITE_LOOP */
 
+#if M68K_IDLE_LOOP_SKIP
+  void m68ki_idle_loop(M68KCPU &m68ki_cpu, int offset);
+  /* Longest recognized loop is a 6 byte MOVE + 6 byte ANDI + the branch */
+  #define m68ki_check_idle_loop(A) if((A) < 0 && (A) >= -14 && m68ki_cpu.idleLoopSkip) m68ki_idle_loop(m68ki_cpu, A)
+#else
+  #define m68ki_check_idle_loop(A)
+#endif /* M68K_IDLE_LOOP_SKIP */
+
 
 
 /* -------------------------- EA / Operand Access ------------------------- */
@@ -1425,11 +1433,13 @@ SINLINE void m68ki_jump_vector(M68KCPU &m68ki_cpu, uint vector)
 SINLINE void m68ki_branch_8(M68KCPU &m68ki_cpu, uint offset)
 {
   REG_PC += MAKE_INT_8(offset);
+  m68ki_check_idle_loop(MAKE_INT_8(offset));
 }
 
 SINLINE void m68ki_branch_16(M68KCPU &m68ki_cpu, uint offset)
 {
   REG_PC += MAKE_INT_16(offset);
+  m68ki_check_idle_loop(MAKE_INT_16(offset));
 }
 
 SINLINE void m68ki_branch_32(M68KCPU &m68ki_cpu, uint offset)
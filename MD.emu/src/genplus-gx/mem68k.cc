@@ -600,6 +600,34 @@ unsigned int vdp_read_word(unsigned int address)
   }
 }
 
+/* Idle loop detection (see m68kconf.h): VDP status bits that can't change until */
+/* the end of the current 68k timeslice. FIFO, DMA busy and HBLANK flags depend  */
+/* on the cycle count and SOVR/SCOL flags are cleared by the read itself.        */
+int m68k_idle_read_stable(M68KCPU &m68ki_cpu, unsigned int address, unsigned int size, unsigned int mask)
+{
+  _m68k_memory_map *map = &m68ki_cpu.memory_map[(address >> 16) & 0xff];
+
+  if (size == 1)
+  {
+    if ((map->read8 != vdp_read_byte) || ((address & 0xFC) != 0x04))
+    {
+      return 0;
+    }
+
+    /* even address returns the upper byte */
+    if (!(address & 1))
+    {
+      mask <<= 8;
+    }
+  }
+  else if ((size != 2) || (map->read16 != vdp_read_word) || ((address & 0xFC) != 0x04))
+  {
+    return 0;
+  }
+
+  return !(mask & 0x366);
+}
+
 void vdp_write_byte(unsigned int address, unsigned int data)
 {
   switch (address & 0xFC)
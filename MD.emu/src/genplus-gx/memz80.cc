@@ -178,6 +178,22 @@ unsigned char z80_sms_memory_r(unsigned int address)
   return z80_readmap[(address) >> 10][(address) & 0x03FF];
 }
 
+/*--------------------------------------------------------------------------*/
+/*  Idle loop detection (see z80.cc)                                        */
+/*--------------------------------------------------------------------------*/
+
+int z80_idle_read_stable(unsigned int address)
+{
+  /* Master System mode: plain memory, only changed by Z80 writes */
+  if (z80_readmem == z80_sms_memory_r)
+  {
+    return 1;
+  }
+
+  /* Z80 RAM: the 68k can only access it while the Z80 is stopped */
+  return (z80_readmem == z80_md_memory_r) && (address < 0x4000);
+}
+
 /*--------------------------------------------------------------------------*/
 /*  Z80 Port handlers                                                       */
 /*--------------------------------------------------------------------------*/
@@ -133,6 +133,14 @@
 
 #include "shared.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define YM2612_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define YM2612_NEON
+#endif
+
 /* compiler dependence */
 #ifndef INLINE
 #define INLINE static __inline__
@@ -1066,7 +1074,7 @@ INLINE void advance_lfo()
 }
 
 
-INLINE void advance_eg_channel(FM_SLOT *SLOT)
+INLINE void advance_eg_channel(FM_SLOT *SLOT, UINT32 eg_cnt)
 {
   unsigned int i = 4; /* four operators per channel */
 
@@ -1075,10 +1083,10 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
     switch(SLOT->state)
     {
       case EG_ATT:    /* attack phase */
-        if (!(ym2612.OPN.eg_cnt & ((1<<SLOT->eg_sh_ar)-1)))
+        if (!(eg_cnt & ((1<<SLOT->eg_sh_ar)-1)))
         {
           /* update attenuation level */
-          SLOT->volume += (~SLOT->volume * (eg_inc[SLOT->eg_sel_ar + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_ar)&7)]))>>4;
+          SLOT->volume += (~SLOT->volume * (eg_inc[SLOT->eg_sel_ar + ((eg_cnt>>SLOT->eg_sh_ar)&7)]))>>4;
 
           /* check phase transition*/
           if (SLOT->volume <= MIN_ATT_INDEX)
@@ -1096,7 +1104,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
         break;
 
       case EG_DEC:  /* decay phase */
-        if (!(ym2612.OPN.eg_cnt & ((1<<SLOT->eg_sh_d1r)-1)))
+        if (!(eg_cnt & ((1<<SLOT->eg_sh_d1r)-1)))
         {
           /* SSG EG type */
           if (SLOT->ssg&0x08)
@@ -1104,7 +1112,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
             /* update attenuation level */
             if (SLOT->volume < 0x200)
             {
-              SLOT->volume += 4 * eg_inc[SLOT->eg_sel_d1r + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_d1r)&7)];
+              SLOT->volume += 4 * eg_inc[SLOT->eg_sel_d1r + ((eg_cnt>>SLOT->eg_sh_d1r)&7)];
 
               /* recalculate EG output */
               if (SLOT->ssgn ^ (SLOT->ssg&0x04))   /* SSG-EG Output Inversion */
@@ -1116,7 +1124,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
           else
           {
             /* update attenuation level */
-            SLOT->volume += eg_inc[SLOT->eg_sel_d1r + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_d1r)&7)];
+            SLOT->volume += eg_inc[SLOT->eg_sel_d1r + ((eg_cnt>>SLOT->eg_sh_d1r)&7)];
 
             /* recalculate EG output */
             SLOT->vol_out = (UINT32)SLOT->volume + SLOT->tl;
@@ -1129,7 +1137,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
         break;
 
       case EG_SUS:  /* sustain phase */
-        if (!(ym2612.OPN.eg_cnt & ((1<<SLOT->eg_sh_d2r)-1)))
+        if (!(eg_cnt & ((1<<SLOT->eg_sh_d2r)-1)))
         {
           /* SSG EG type */
           if (SLOT->ssg&0x08)
@@ -1137,7 +1145,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
             /* update attenuation level */
             if (SLOT->volume < 0x200)
             {
-              SLOT->volume += 4 * eg_inc[SLOT->eg_sel_d2r + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_d2r)&7)];
+              SLOT->volume += 4 * eg_inc[SLOT->eg_sel_d2r + ((eg_cnt>>SLOT->eg_sh_d2r)&7)];
 
               /* recalculate EG output */
               if (SLOT->ssgn ^ (SLOT->ssg&0x04))   /* SSG-EG Output Inversion */
@@ -1149,7 +1157,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
           else
           {
             /* update attenuation level */
-            SLOT->volume += eg_inc[SLOT->eg_sel_d2r + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_d2r)&7)];
+            SLOT->volume += eg_inc[SLOT->eg_sel_d2r + ((eg_cnt>>SLOT->eg_sh_d2r)&7)];
 
             /* check phase transition*/
             if ( SLOT->volume >= MAX_ATT_INDEX )
@@ -1163,14 +1171,14 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
         break;
 
       case EG_REL:  /* release phase */
-        if (!(ym2612.OPN.eg_cnt & ((1<<SLOT->eg_sh_rr)-1)))
+        if (!(eg_cnt & ((1<<SLOT->eg_sh_rr)-1)))
         {
            /* SSG EG type */
           if (SLOT->ssg&0x08)
           {
             /* update attenuation level */
             if (SLOT->volume < 0x200)
-              SLOT->volume += 4 * eg_inc[SLOT->eg_sel_rr + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_rr)&7)];
+              SLOT->volume += 4 * eg_inc[SLOT->eg_sel_rr + ((eg_cnt>>SLOT->eg_sh_rr)&7)];
 
             /* check phase transition */
             if (SLOT->volume >= 0x200)
@@ -1182,7 +1190,7 @@ INLINE void advance_eg_channel(FM_SLOT *SLOT)
           else
           {
             /* update attenuation level */
-            SLOT->volume += eg_inc[SLOT->eg_sel_rr + ((ym2612.OPN.eg_cnt>>SLOT->eg_sh_rr)&7)];
+            SLOT->volume += eg_inc[SLOT->eg_sel_rr + ((eg_cnt>>SLOT->eg_sh_rr)&7)];
 
             /* check phase transition*/
             if (SLOT->volume >= MAX_ATT_INDEX)
@@ -1265,10 +1273,10 @@ INLINE void update_ssg_eg_channel(FM_SLOT *SLOT)
    } while (i);
 }
 
-INLINE void update_phase_lfo_slot(FM_SLOT *SLOT , INT32 pms, UINT32 block_fnum)
+INLINE void update_phase_lfo_slot(FM_SLOT *SLOT , INT32 pms, UINT32 block_fnum, UINT32 lfo_pm)
 {
   UINT32 fnum_lfo   = ((block_fnum & 0x7f0) >> 4) * 32 * 8;
-  INT32  lfo_fn_table_index_offset = lfo_pm_table[ fnum_lfo + pms + ym2612.OPN.LFO_PM ];
+  INT32  lfo_fn_table_index_offset = lfo_pm_table[ fnum_lfo + pms + lfo_pm ];
   
   if (lfo_fn_table_index_offset)  /* LFO phase modulation active */
   {
@@ -1295,12 +1303,12 @@ INLINE void update_phase_lfo_slot(FM_SLOT *SLOT , INT32 pms, UINT32 block_fnum)
   }
 }
 
-INLINE void update_phase_lfo_channel(FM_CH *CH)
+INLINE void update_phase_lfo_channel(FM_CH *CH, UINT32 lfo_pm)
 {
   UINT32 block_fnum = CH->block_fnum;
   
   UINT32 fnum_lfo   = ((block_fnum & 0x7f0) >> 4) * 32 * 8;
-  INT32  lfo_fn_table_index_offset = lfo_pm_table[ fnum_lfo + CH->pms + ym2612.OPN.LFO_PM ];
+  INT32  lfo_fn_table_index_offset = lfo_pm_table[ fnum_lfo + CH->pms + lfo_pm ];
 
   if (lfo_fn_table_index_offset)  /* LFO phase modulation active */
   {
@@ -1420,9 +1428,33 @@ INLINE signed int op_calc1(UINT32 phase, unsigned int env, signed int pm)
   return tl_tab[p];
 }
 
-INLINE void chan_calc(FM_CH *CH)
+/* update phase counters of a channel by one sample */
+INLINE void advance_phase_channel(FM_CH *CH, UINT32 lfo_pm)
 {
-  UINT32 AM = ym2612.OPN.LFO_AM >> CH->ams;
+  if(CH->pms)
+  {
+    /* add support for 3 slot mode */
+    if ((ym2612.OPN.ST.mode & 0xC0) && (CH == &ym2612.CH[2]))
+    {
+      update_phase_lfo_slot(&CH->SLOT[SLOT1], CH->pms, ym2612.OPN.SL3.block_fnum[1], lfo_pm);
+      update_phase_lfo_slot(&CH->SLOT[SLOT2], CH->pms, ym2612.OPN.SL3.block_fnum[2], lfo_pm);
+      update_phase_lfo_slot(&CH->SLOT[SLOT3], CH->pms, ym2612.OPN.SL3.block_fnum[0], lfo_pm);
+      update_phase_lfo_slot(&CH->SLOT[SLOT4], CH->pms, CH->block_fnum, lfo_pm);
+    }
+    else update_phase_lfo_channel(CH, lfo_pm);
+  }
+  else  /* no LFO phase modulation */
+  {
+    CH->SLOT[SLOT1].phase += CH->SLOT[SLOT1].Incr;
+    CH->SLOT[SLOT2].phase += CH->SLOT[SLOT2].Incr;
+    CH->SLOT[SLOT3].phase += CH->SLOT[SLOT3].Incr;
+    CH->SLOT[SLOT4].phase += CH->SLOT[SLOT4].Incr;
+  }
+}
+
+INLINE void chan_calc(FM_CH *CH, UINT32 lfo_am, UINT32 lfo_pm)
+{
+  UINT32 AM = lfo_am >> CH->ams;
 
   m2 = c1 = c2 = mem = 0;
 
@@ -1468,25 +1500,7 @@ INLINE void chan_calc(FM_CH *CH)
   CH->mem_value = mem;
 
   /* update phase counters AFTER output calculations */
-  if(CH->pms)
-  {
-    /* add support for 3 slot mode */
-    if ((ym2612.OPN.ST.mode & 0xC0) && (CH == &ym2612.CH[2]))
-    {
-      update_phase_lfo_slot(&CH->SLOT[SLOT1], CH->pms, ym2612.OPN.SL3.block_fnum[1]);
-      update_phase_lfo_slot(&CH->SLOT[SLOT2], CH->pms, ym2612.OPN.SL3.block_fnum[2]);
-      update_phase_lfo_slot(&CH->SLOT[SLOT3], CH->pms, ym2612.OPN.SL3.block_fnum[0]);
-      update_phase_lfo_slot(&CH->SLOT[SLOT4], CH->pms, CH->block_fnum);
-    }
-    else update_phase_lfo_channel(CH);
-  }
-  else  /* no LFO phase modulation */
-  {
-    CH->SLOT[SLOT1].phase += CH->SLOT[SLOT1].Incr;
-    CH->SLOT[SLOT2].phase += CH->SLOT[SLOT2].Incr;
-    CH->SLOT[SLOT3].phase += CH->SLOT[SLOT3].Incr;
-    CH->SLOT[SLOT4].phase += CH->SLOT[SLOT4].Incr;
-  }
+  advance_phase_channel(CH, lfo_pm);
 }
 
 /* write a OPN mode register 0x20-0x2f */
@@ -2032,33 +2046,12 @@ unsigned int YM2612Read(void)
   return ym2612.OPN.ST.status & 0xff;
 }
 
-/* Generate 16 bits samples for ym2612 */
-void YM2612Update(FMSampleType *buffer, int length)
+/* Per-sample update, used while CSM mode can key channel 3 on and off between samples */
+static void update_samples(FMSampleType *buffer, int length)
 {
   int i;
   long int lt,rt;
 
-  /* refresh PG increments and EG rates if required */
-  refresh_fc_eg_chan(&ym2612.CH[0]);
-  refresh_fc_eg_chan(&ym2612.CH[1]);
-
-  if (ym2612.OPN.ST.mode & 0xC0)
-  {
-    /* 3SLOT MODE (operator order is 0,1,3,2) */
-    if(ym2612.CH[2].SLOT[SLOT1].Incr==-1)
-    {
-      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT1] , ym2612.OPN.SL3.fc[1] , ym2612.OPN.SL3.kcode[1] );
-      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT2] , ym2612.OPN.SL3.fc[2] , ym2612.OPN.SL3.kcode[2] );
-      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT3] , ym2612.OPN.SL3.fc[0] , ym2612.OPN.SL3.kcode[0] );
-      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT4] , ym2612.CH[2].fc , ym2612.CH[2].kcode );
-    }
-  }
-  else refresh_fc_eg_chan(&ym2612.CH[2]);
-
-  refresh_fc_eg_chan(&ym2612.CH[3]);
-  refresh_fc_eg_chan(&ym2612.CH[4]);
-  refresh_fc_eg_chan(&ym2612.CH[5]);
-
   /* buffering */
   for(i=0; i < length ; i++)
   {
@@ -2079,17 +2072,17 @@ void YM2612Update(FMSampleType *buffer, int length)
     update_ssg_eg_channel(&ym2612.CH[5].SLOT[SLOT1]);
 
     /* calculate FM */
-    chan_calc(&ym2612.CH[0]);
-    chan_calc(&ym2612.CH[1]);
-    chan_calc(&ym2612.CH[2]);
-    chan_calc(&ym2612.CH[3]);
-    chan_calc(&ym2612.CH[4]);
+    chan_calc(&ym2612.CH[0], ym2612.OPN.LFO_AM, ym2612.OPN.LFO_PM);
+    chan_calc(&ym2612.CH[1], ym2612.OPN.LFO_AM, ym2612.OPN.LFO_PM);
+    chan_calc(&ym2612.CH[2], ym2612.OPN.LFO_AM, ym2612.OPN.LFO_PM);
+    chan_calc(&ym2612.CH[3], ym2612.OPN.LFO_AM, ym2612.OPN.LFO_PM);
+    chan_calc(&ym2612.CH[4], ym2612.OPN.LFO_AM, ym2612.OPN.LFO_PM);
     if (ym2612.dacen)
     {
       /* DAC Mode */
       out_fm[5] = ym2612.dacout;
     }
-    else chan_calc(&ym2612.CH[5]);
+    else chan_calc(&ym2612.CH[5], ym2612.OPN.LFO_AM, ym2612.OPN.LFO_PM);
 
     /* advance LFO */
     advance_lfo();
@@ -2101,12 +2094,12 @@ void YM2612Update(FMSampleType *buffer, int length)
       ym2612.OPN.eg_timer -= ym2612.OPN.eg_timer_overflow;
       ym2612.OPN.eg_cnt++;
 
-      advance_eg_channel(&ym2612.CH[0].SLOT[SLOT1]);
-      advance_eg_channel(&ym2612.CH[1].SLOT[SLOT1]);
-      advance_eg_channel(&ym2612.CH[2].SLOT[SLOT1]);
-      advance_eg_channel(&ym2612.CH[3].SLOT[SLOT1]);
-      advance_eg_channel(&ym2612.CH[4].SLOT[SLOT1]);
-      advance_eg_channel(&ym2612.CH[5].SLOT[SLOT1]);
+      advance_eg_channel(&ym2612.CH[0].SLOT[SLOT1], ym2612.OPN.eg_cnt);
+      advance_eg_channel(&ym2612.CH[1].SLOT[SLOT1], ym2612.OPN.eg_cnt);
+      advance_eg_channel(&ym2612.CH[2].SLOT[SLOT1], ym2612.OPN.eg_cnt);
+      advance_eg_channel(&ym2612.CH[3].SLOT[SLOT1], ym2612.OPN.eg_cnt);
+      advance_eg_channel(&ym2612.CH[4].SLOT[SLOT1], ym2612.OPN.eg_cnt);
+      advance_eg_channel(&ym2612.CH[5].SLOT[SLOT1], ym2612.OPN.eg_cnt);
     }
 
     /* 14-bit DAC inputs (range is -8192;+8192) */
@@ -2162,6 +2155,265 @@ void YM2612Update(FMSampleType *buffer, int length)
       ym2612.OPN.SL3.key_csm = 0;
     }
   }
+}
+
+/*
+** Block update
+**
+** Outside of CSM mode nothing links the channels within a sample: each one
+** only depends on its own registers and on the global LFO and EG counters.
+** So the LFO levels and EG ticks of a whole block are worked out first, then
+** each channel is run over the block on its own, and the channel outputs are
+** clipped and mixed together at the end. This gives the same samples as
+** running the six channels sample by sample.
+*/
+
+/* samples per block */
+#define FM_BLOCK_LEN 256
+
+/* LFO levels used by each sample and EG ticks following it */
+static UINT32 block_lfo_am[FM_BLOCK_LEN];
+static UINT32 block_lfo_pm[FM_BLOCK_LEN];
+static UINT8  block_eg_ticks[FM_BLOCK_LEN];
+
+/* channel outputs */
+static INT32 block_out[6][FM_BLOCK_LEN] __attribute__ ((aligned (16)));
+
+/* true if the channel is keyed off and has nothing left to output */
+INLINE int chan_is_silent(FM_CH *CH)
+{
+  return (CH->SLOT[SLOT1].state == EG_OFF) && (CH->SLOT[SLOT1].vol_out >= ENV_QUIET) &&
+         (CH->SLOT[SLOT2].state == EG_OFF) && (CH->SLOT[SLOT2].vol_out >= ENV_QUIET) &&
+         (CH->SLOT[SLOT3].state == EG_OFF) && (CH->SLOT[SLOT3].vol_out >= ENV_QUIET) &&
+         (CH->SLOT[SLOT4].state == EG_OFF) && (CH->SLOT[SLOT4].vol_out >= ENV_QUIET) &&
+         !CH->op1_out[0] && !CH->op1_out[1] && !CH->mem_value;
+}
+
+static void chan_calc_block(int c, int length, UINT32 eg_cnt)
+{
+  FM_CH *CH = &ym2612.CH[c];
+  INT32 *out = block_out[c];
+  int dac = (c == 5) && ym2612.dacen;
+  int ssg = (CH->SLOT[SLOT1].ssg | CH->SLOT[SLOT2].ssg | CH->SLOT[SLOT3].ssg | CH->SLOT[SLOT4].ssg) & 0x08;
+  int i, t;
+
+  if (!dac && chan_is_silent(CH))
+  {
+    /* EG has nothing to do in EG_OFF state, only the phases move */
+    memset(out, 0, length * sizeof(INT32));
+    if (CH->pms)
+    {
+      for (i = 0; i < length; i++)
+        advance_phase_channel(CH, block_lfo_pm[i]);
+    }
+    else
+    {
+      CH->SLOT[SLOT1].phase += (UINT32)length * CH->SLOT[SLOT1].Incr;
+      CH->SLOT[SLOT2].phase += (UINT32)length * CH->SLOT[SLOT2].Incr;
+      CH->SLOT[SLOT3].phase += (UINT32)length * CH->SLOT[SLOT3].Incr;
+      CH->SLOT[SLOT4].phase += (UINT32)length * CH->SLOT[SLOT4].Incr;
+    }
+    return;
+  }
+
+  for (i = 0; i < length; i++)
+  {
+    /* update SSG-EG output */
+    if (ssg)
+      update_ssg_eg_channel(&CH->SLOT[SLOT1]);
+
+    /* calculate FM */
+    if (dac)
+    {
+      /* DAC Mode */
+      out[i] = ym2612.dacout;
+    }
+    else
+    {
+      out_fm[c] = 0;
+      chan_calc(CH, block_lfo_am[i], block_lfo_pm[i]);
+      out[i] = out_fm[c];
+    }
+
+    /* advance envelope generator */
+    for (t = block_eg_ticks[i]; t; t--)
+      advance_eg_channel(&CH->SLOT[SLOT1], ++eg_cnt);
+  }
+}
+
+/* clip and mix the channel outputs of a block */
+static void mix_block(FMSampleType *buffer, int length)
+{
+  int i = 0, c;
+  long int lt,rt;
+
+#if defined(YM2612_SSE2) || defined(YM2612_NEON)
+  /* four samples at a time, 32-bit sums keep the low 16 bits exact */
+  for(; i + 4 <= length; i += 4)
+  {
+#ifdef YM2612_SSE2
+    const __m128i max = _mm_set1_epi32(8192);
+    const __m128i min = _mm_set1_epi32(-8192);
+    __m128i l = _mm_setzero_si128();
+    __m128i r = _mm_setzero_si128();
+
+    for (c = 0; c < 6; c++)
+    {
+      __m128i out = _mm_load_si128((const __m128i *)&block_out[c][i]);
+
+      /* 14-bit DAC inputs (range is -8192;+8192) */
+      if(config_ym2612_clip)
+      {
+        __m128i mask = _mm_cmpgt_epi32(out, max);
+        out = _mm_or_si128(_mm_and_si128(mask, max), _mm_andnot_si128(mask, out));
+        mask = _mm_cmplt_epi32(out, min);
+        out = _mm_or_si128(_mm_and_si128(mask, min), _mm_andnot_si128(mask, out));
+      }
+
+      l = _mm_add_epi32(l, _mm_and_si128(out, _mm_set1_epi32(ym2612.OPN.pan[c*2])));
+      r = _mm_add_epi32(r, _mm_and_si128(out, _mm_set1_epi32(ym2612.OPN.pan[c*2+1])));
+    }
+
+    /* keep the low 16 bits (sign-extended so the saturating pack is exact) and interleave */
+    l = _mm_srai_epi32(_mm_slli_epi32(l, 16), 16);
+    r = _mm_srai_epi32(_mm_slli_epi32(r, 16), 16);
+    l = _mm_packs_epi32(l, l);
+    r = _mm_packs_epi32(r, r);
+    _mm_storeu_si128((__m128i *)buffer, _mm_unpacklo_epi16(l, r));
+#else
+    const int32x4_t max = vdupq_n_s32(8192);
+    const int32x4_t min = vdupq_n_s32(-8192);
+    int32x4_t l = vdupq_n_s32(0);
+    int32x4_t r = vdupq_n_s32(0);
+    int16x4x2_t lr;
+
+    for (c = 0; c < 6; c++)
+    {
+      int32x4_t out = vld1q_s32(&block_out[c][i]);
+
+      /* 14-bit DAC inputs (range is -8192;+8192) */
+      if(config_ym2612_clip)
+        out = vmaxq_s32(vminq_s32(out, max), min);
+
+      l = vaddq_s32(l, vandq_s32(out, vdupq_n_s32(ym2612.OPN.pan[c*2])));
+      r = vaddq_s32(r, vandq_s32(out, vdupq_n_s32(ym2612.OPN.pan[c*2+1])));
+    }
+
+    /* keep the low 16 bits and interleave */
+    lr.val[0] = vmovn_s32(l);
+    lr.val[1] = vmovn_s32(r);
+    vst2_s16(buffer, lr);
+#endif
+    buffer += 8;
+  }
+#endif
+
+  for(; i < length; i++)
+  {
+    lt = rt = 0;
+
+    for (c = 0; c < 6; c++)
+    {
+      INT32 out = block_out[c][i];
+
+      /* 14-bit DAC inputs (range is -8192;+8192) */
+      if(config_ym2612_clip)
+      {
+        if (out > 8192) out = 8192;
+        else if (out < -8192) out = -8192;
+      }
+
+      lt += (out & ym2612.OPN.pan[c*2]);
+      rt += (out & ym2612.OPN.pan[c*2+1]);
+    }
+
+    /* buffering */
+    *buffer++ = lt;
+    *buffer++ = rt;
+  }
+}
+
+static void update_block(FMSampleType *buffer, int length)
+{
+  UINT32 eg_cnt = ym2612.OPN.eg_cnt;
+  int i, c;
+
+  /* LFO and EG timing */
+  for (i = 0; i < length; i++)
+  {
+    block_lfo_am[i] = ym2612.OPN.LFO_AM;
+    block_lfo_pm[i] = ym2612.OPN.LFO_PM;
+
+    /* advance LFO */
+    advance_lfo();
+
+    /* advance envelope generator counter */
+    block_eg_ticks[i] = 0;
+    ym2612.OPN.eg_timer += ym2612.OPN.eg_timer_add;
+    while (ym2612.OPN.eg_timer >= ym2612.OPN.eg_timer_overflow)
+    {
+      ym2612.OPN.eg_timer -= ym2612.OPN.eg_timer_overflow;
+      ym2612.OPN.eg_cnt++;
+      block_eg_ticks[i]++;
+    }
+  }
+
+  /* calculate FM, one channel at a time */
+  for (c = 0; c < 6; c++)
+    chan_calc_block(c, length, eg_cnt);
+
+  /* timer A control (no CSM key events outside of CSM mode) */
+  for (i = 0; i < length; i++)
+    INTERNAL_TIMER_A();
+
+  mix_block(buffer, length);
+}
+
+/* Generate 16 bits samples for ym2612 */
+void YM2612Update(FMSampleType *buffer, int length)
+{
+  int i;
+
+  /* refresh PG increments and EG rates if required */
+  refresh_fc_eg_chan(&ym2612.CH[0]);
+  refresh_fc_eg_chan(&ym2612.CH[1]);
+
+  if (ym2612.OPN.ST.mode & 0xC0)
+  {
+    /* 3SLOT MODE (operator order is 0,1,3,2) */
+    if(ym2612.CH[2].SLOT[SLOT1].Incr==-1)
+    {
+      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT1] , ym2612.OPN.SL3.fc[1] , ym2612.OPN.SL3.kcode[1] );
+      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT2] , ym2612.OPN.SL3.fc[2] , ym2612.OPN.SL3.kcode[2] );
+      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT3] , ym2612.OPN.SL3.fc[0] , ym2612.OPN.SL3.kcode[0] );
+      refresh_fc_eg_slot(&ym2612.CH[2].SLOT[SLOT4] , ym2612.CH[2].fc , ym2612.CH[2].kcode );
+    }
+  }
+  else refresh_fc_eg_chan(&ym2612.CH[2]);
+
+  refresh_fc_eg_chan(&ym2612.CH[3]);
+  refresh_fc_eg_chan(&ym2612.CH[4]);
+  refresh_fc_eg_chan(&ym2612.CH[5]);
+
+#ifdef YM2612_PER_SAMPLE_UPDATE
+  /* reference build for MD.emu/tests/ym2612, always use the per-sample path */
+  if (1)
+#else
+  if (((ym2612.OPN.ST.mode & 0xC0) == 0x80) || ym2612.OPN.SL3.key_csm)
+#endif
+  {
+    /* CSM mode */
+    update_samples(buffer, length);
+  }
+  else
+  {
+    for (i = 0; i < length; i += FM_BLOCK_LEN)
+    {
+      int n = length - i;
+      if (n > FM_BLOCK_LEN) n = FM_BLOCK_LEN;
+      update_block(buffer + i*2, n);
+    }
+  }
 
   /* timer B control */
   INTERNAL_TIMER_B(length);
@@ -46,6 +46,20 @@ extern sms_ntsc_t *sms_ntsc;
 // Fixes SIGBUS issues on ARM targets.
 using uint32u [[gnu::aligned(2)]] = uint32;
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define VDP_RENDER_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VDP_RENDER_NEON
+#endif
+
+/* Vector pattern cache update, background layer merge & pixel remapping */
+/* (little-endian byte order only, vector loads & stores need no alignment) */
+#if (defined(VDP_RENDER_SSE2) || defined(VDP_RENDER_NEON)) && defined(LSB_FIRST)
+#define VDP_RENDER_SIMD
+#endif
+
 #ifdef ALIGN_LONG
 /* Or change the names if you depend on these from elsewhere.. */
 #undef READ_LONG
@@ -262,7 +276,23 @@ static __inline__ void WRITE_LONG(void *address, uint32 data)
   *lb++ = table[((SRC_B << 8) & 0xff00) | (SRC_A & 0xff)];
 #endif
 
-#ifdef ALIGN_LONG
+#if defined(VDP_RENDER_SIMD)
+/* Layer B tile rows are merged 8 pixels at a time (see merge_bg_8) */
+#define DRAW_BG_COLUMN(ATTR, LINE, SRC_A, SRC_B) \
+  GET_LSB_TILE(ATTR, LINE) \
+  merge_bg_8(lb, src, atex, table); \
+  lb += 8; \
+  GET_MSB_TILE(ATTR, LINE) \
+  merge_bg_8(lb, src, atex, table); \
+  lb += 8;
+#define DRAW_BG_COLUMN_IM2(ATTR, LINE, SRC_A, SRC_B) \
+  GET_LSB_TILE_IM2(ATTR, LINE) \
+  merge_bg_8(lb, src, atex, table); \
+  lb += 8; \
+  GET_MSB_TILE_IM2(ATTR, LINE) \
+  merge_bg_8(lb, src, atex, table); \
+  lb += 8;
+#elif defined(ALIGN_LONG)
 #ifdef LSB_FIRST 
 #define DRAW_BG_COLUMN(ATTR, LINE, SRC_A, SRC_B) \
   GET_LSB_TILE(ATTR, LINE) \
@@ -539,6 +569,18 @@ uint8 object_count;
 /* Sprite Collision Info */
 uint16 spr_col;
 
+#ifdef VDP_RENDER_STATS
+vdp_render_stats_t render_stats;
+#define RENDER_STATS_TIME(STEP, CALL) \
+  { \
+    auto start = TimeSys::now(); \
+    CALL; \
+    render_stats.STEP += TimeSys::now() - start; \
+  }
+#else
+#define RENDER_STATS_TIME(STEP, CALL) CALL;
+#endif
+
 /* Function pointers */
 void (*render_bg)(int line, int width);
 void (*render_obj)(int max_width);
@@ -881,8 +923,116 @@ static uint32 make_lut_bgobj_m4(uint32 bx, uint32 sx)
 /* Pixel layer merging function                                             */
 /*--------------------------------------------------------------------------*/
 
+#ifdef VDP_RENDER_SIMD
+/* Background layers merging, computed 16 pixels at a time instead of read */
+/* from lut[0] (make_lut_bg) or lut[2] (make_lut_bg_ste, ste = all bits set) */
+#ifdef VDP_RENDER_SSE2
+static inline __m128i merge_bg_simd(__m128i a, __m128i b, __m128i ste)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i color = _mm_set1_epi8(0x0F);
+  const __m128i priority = _mm_set1_epi8(0x40);
+
+  /* Layer B is shown if layer A is transparent, or if layer B pixel is opaque */
+  /* and has priority over layer A (pixels with the same priority show layer A) */
+  __m128i a_clear = _mm_cmpeq_epi8(_mm_and_si128(a, color), zero);
+  __m128i b_clear = _mm_cmpeq_epi8(_mm_and_si128(b, color), zero);
+  __m128i a_low = _mm_cmpeq_epi8(_mm_and_si128(a, priority), zero);
+  __m128i b_low = _mm_cmpeq_epi8(_mm_and_si128(b, priority), zero);
+  __m128i b_over = _mm_andnot_si128(b_clear, _mm_andnot_si128(b_low, a_low));
+  __m128i use_b = _mm_or_si128(a_clear, b_over);
+  __m128i c = _mm_or_si128(_mm_and_si128(use_b, b), _mm_andnot_si128(use_b, a));
+  c = _mm_and_si128(c, _mm_set1_epi8(0x7F));
+
+  /* Shadow/Highlight: normal intensity when one of the pixels is high priority */
+  __m128i p = _mm_and_si128(_mm_or_si128(a, b), priority);
+  c = _mm_or_si128(c, _mm_and_si128(_mm_add_epi8(p, p), ste));
+
+  /* Strip palette & priority bits from transparent pixels */
+  __m128i c_clear = _mm_cmpeq_epi8(_mm_and_si128(c, color), zero);
+  return _mm_andnot_si128(_mm_andnot_si128(_mm_set1_epi8((char)0x80), c_clear), c);
+}
+
+/* Layer A pixels in line buffer, 8 layer B pixels from pattern cache */
+static inline void merge_bg_8(uint8 *lb, uint32 *src, uint32 atex, uint8 *table)
+{
+  __m128i a = _mm_loadl_epi64((__m128i *)lb);
+  __m128i b = _mm_or_si128(_mm_loadl_epi64((__m128i *)src), _mm_set1_epi32(atex));
+  __m128i ste = _mm_set1_epi8(-(table != lut[0]));
+  _mm_storel_epi64((__m128i *)lb, merge_bg_simd(a, b, ste));
+}
+
+static inline int merge_bg(uint8 *srca, uint8 *srcb, uint8 *dst, uint8 *table, int width)
+{
+  __m128i ste = _mm_set1_epi8(-(table != lut[0]));
+  for (; width >= 16; width -= 16, srca += 16, srcb += 16, dst += 16)
+  {
+    __m128i a = _mm_loadu_si128((__m128i *)srca);
+    __m128i b = _mm_loadu_si128((__m128i *)srcb);
+    _mm_storeu_si128((__m128i *)dst, merge_bg_simd(a, b, ste));
+  }
+  return width;
+}
+#else
+static inline uint8x16_t merge_bg_simd(uint8x16_t a, uint8x16_t b, uint8x16_t ste)
+{
+  const uint8x16_t color = vdupq_n_u8(0x0F);
+  const uint8x16_t priority = vdupq_n_u8(0x40);
+
+  /* Layer B is shown if layer A is transparent, or if layer B pixel is opaque */
+  /* and has priority over layer A (pixels with the same priority show layer A) */
+  uint8x16_t a_opaque = vtstq_u8(a, color);
+  uint8x16_t b_opaque = vtstq_u8(b, color);
+  uint8x16_t a_high = vtstq_u8(a, priority);
+  uint8x16_t b_high = vtstq_u8(b, priority);
+  uint8x16_t b_over = vandq_u8(vbicq_u8(b_high, a_high), b_opaque);
+  uint8x16_t use_b = vorrq_u8(vmvnq_u8(a_opaque), b_over);
+  uint8x16_t c = vandq_u8(vbslq_u8(use_b, b, a), vdupq_n_u8(0x7F));
+
+  /* Shadow/Highlight: normal intensity when one of the pixels is high priority */
+  uint8x16_t p = vandq_u8(vorrq_u8(a, b), priority);
+  c = vorrq_u8(c, vandq_u8(vshlq_n_u8(p, 1), ste));
+
+  /* Strip palette & priority bits from transparent pixels */
+  return vandq_u8(c, vorrq_u8(vtstq_u8(c, color), vdupq_n_u8(0x80)));
+}
+
+/* Layer A pixels in line buffer, 8 layer B pixels from pattern cache */
+static inline void merge_bg_8(uint8 *lb, uint32 *src, uint32 atex, uint8 *table)
+{
+  uint8x8_t a = vld1_u8(lb);
+  uint8x8_t b = vorr_u8(vld1_u8((uint8 *)src), vreinterpret_u8_u32(vdup_n_u32(atex)));
+  uint8x16_t ste = vdupq_n_u8(-(table != lut[0]));
+  vst1_u8(lb, vget_low_u8(merge_bg_simd(vcombine_u8(a, a), vcombine_u8(b, b), ste)));
+}
+
+static inline int merge_bg(uint8 *srca, uint8 *srcb, uint8 *dst, uint8 *table, int width)
+{
+  uint8x16_t ste = vdupq_n_u8(-(table != lut[0]));
+  for (; width >= 16; width -= 16, srca += 16, srcb += 16, dst += 16)
+  {
+    vst1q_u8(dst, merge_bg_simd(vld1q_u8(srca), vld1q_u8(srcb), ste));
+  }
+  return width;
+}
+#endif
+#endif /* VDP_RENDER_SIMD */
+
 static inline void merge(uint8 *srca, uint8 *srcb, uint8 *dst, uint8 *table, int width)
 {
+#ifdef VDP_RENDER_SIMD
+  /* Background layers */
+  if ((table == lut[0]) || (table == lut[2]))
+  {
+    int left = merge_bg(srca, srcb, dst, table, width);
+    if (!left) return;
+    srca += width - left;
+    srcb += width - left;
+    dst += width - left;
+    width = left;
+  }
+#endif
+
   do
   {
     *dst++ = table[(*srcb++ << 8) | (*srca++)];
@@ -3561,6 +3711,58 @@ void update_bg_pattern_cache_m4(int index)
   }
 }
 
+#ifdef VDP_RENDER_SIMD
+/* Update all 8 cached lines of a pattern (4 lines per vector) */
+static inline void update_bg_pattern_m5(uint8 *src, uint8 *dst)
+{
+  int y;
+
+  for(y = 0; y < 8; y += 4)
+  {
+#ifdef VDP_RENDER_SSE2
+    __m128i bp = _mm_loadu_si128((__m128i *)&src[y << 2]);
+    __m128i lo = _mm_and_si128(bp, _mm_set1_epi8(0x0F));
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(bp, 4), _mm_set1_epi8(0x0F));
+    __m128i line[2][2];
+
+    /* Two lines = (lsb) p3p2p1p0 p7p6p5p4 (msb) once unpacked in nibble order */
+    line[0][1] = _mm_unpacklo_epi8(lo, hi);
+    line[1][1] = _mm_unpackhi_epi8(lo, hi);
+    for (int j = 0; j < 2; j++)
+    {
+      line[j][0] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(line[j][1], 0xB1), 0xB1);
+      line[j][0] = _mm_or_si128(_mm_slli_epi16(line[j][0], 8), _mm_srli_epi16(line[j][0], 8));
+      line[j][1] = _mm_shuffle_epi32(line[j][1], 0xB1);
+    }
+
+    for (int j = 0; j < 2; j++)
+    {
+      int row = y + (j << 1);
+      _mm_storeu_si128((__m128i *)&dst[0x00000 | (row << 3)], line[j][0]);                               /* vflip=0, hflip=0 */
+      _mm_storeu_si128((__m128i *)&dst[0x20000 | (row << 3)], line[j][1]);                               /* vflip=0, hflip=1 */
+      _mm_storeu_si128((__m128i *)&dst[0x40000 | ((row ^ 6) << 3)], _mm_shuffle_epi32(line[j][0], 0x4E)); /* vflip=1, hflip=0 */
+      _mm_storeu_si128((__m128i *)&dst[0x60000 | ((row ^ 6) << 3)], _mm_shuffle_epi32(line[j][1], 0x4E)); /* vflip=1, hflip=1 */
+    }
+#else
+    uint8x16_t bp = vld1q_u8(&src[y << 2]);
+    uint8x16x2_t line = vzipq_u8(vandq_u8(bp, vdupq_n_u8(0x0F)), vshrq_n_u8(bp, 4));
+
+    /* Two lines = (lsb) p3p2p1p0 p7p6p5p4 (msb) once unpacked in nibble order */
+    for (int j = 0; j < 2; j++)
+    {
+      int row = y + (j << 1);
+      uint8x16_t p = vrev32q_u8(line.val[j]);
+      uint8x16_t q = vreinterpretq_u8_u32(vrev64q_u32(vreinterpretq_u32_u8(line.val[j])));
+      vst1q_u8(&dst[0x00000 | (row << 3)], p);                      /* vflip=0, hflip=0 */
+      vst1q_u8(&dst[0x20000 | (row << 3)], q);                      /* vflip=0, hflip=1 */
+      vst1q_u8(&dst[0x40000 | ((row ^ 6) << 3)], vextq_u8(p, p, 8)); /* vflip=1, hflip=0 */
+      vst1q_u8(&dst[0x60000 | ((row ^ 6) << 3)], vextq_u8(q, q, 8)); /* vflip=1, hflip=1 */
+    }
+#endif
+  }
+}
+#endif
+
 void update_bg_pattern_cache_m5(int index)
 {
   int i;
@@ -3574,6 +3776,16 @@ void update_bg_pattern_cache_m5(int index)
     /* Get modified pattern name index */
     name = bg_name_list[i];
 
+#ifdef VDP_RENDER_SIMD
+    /* Whole pattern modified (DMA, VRAM fill & copy...) */
+    if (bg_name_dirty[name] == 0xFF)
+    {
+      update_bg_pattern_m5(&vram.b[name << 5], &bg_pattern_cache[name << 6]);
+      bg_name_dirty[name] = 0;
+      continue;
+    }
+#endif
+
     /* Check modified lines */
     for(y = 0; y < 8; y ++)
     {
@@ -3735,15 +3947,18 @@ void render_line(int line)
     /* Update pattern cache */
     if (bg_list_index)
     {
-      update_bg_pattern_cache(bg_list_index);
+#ifdef VDP_RENDER_STATS
+      render_stats.patterns += bg_list_index;
+#endif
+      RENDER_STATS_TIME(pattern_cache, update_bg_pattern_cache(bg_list_index))
       bg_list_index = 0;
     }
 
     /* Render BG layer(s) */
-    render_bg(line, width);
+    RENDER_STATS_TIME(bg, render_bg(line, width))
 
     /* Render sprite layer */
-    render_obj(width);
+    RENDER_STATS_TIME(obj, render_obj(width))
 
     /* Left-most column blanking */
     if(reg[0] & 0x20)
@@ -3772,13 +3987,16 @@ void render_line(int line)
   }
 
   /* Pixel color remapping */
-  remap_line(line);
+  RENDER_STATS_TIME(remap, remap_line(line))
+#ifdef VDP_RENDER_STATS
+  render_stats.lines++;
+#endif
 }
 
 void blank_line(int line, int offset, int width)
 {
   memset(&linebuf[0][0x20 + offset], 0x40, width);
-  remap_line(line);
+  RENDER_STATS_TIME(remap, remap_line(line))
 }
 
 void remap_line(int line)
@@ -3806,6 +4024,39 @@ void remap_line(int line)
 #else
     uint16 *dst =((uint16 *)&bitmap.data[(line * bitmap.pitch)]);
 #endif
+
+#if defined(VDP_RENDER_SIMD) && !defined(SUPPORT_8BPP_RENDER) && !defined(SUPPORT_32BPP_RENDER)
+	/* No byte-indexed gather: look up 8 pixels from one read, then write them at once */
+	for (; width >= 8; width -= 8, src += 8, dst += 8)
+	{
+		uint32 lo, hi;
+		memcpy(&lo, &src[0], 4);
+		memcpy(&hi, &src[4], 4);
+#ifdef VDP_RENDER_SSE2
+		__m128i p = _mm_cvtsi32_si128(pixel[lo & 0xFF]);
+		p = _mm_insert_epi16(p, pixel[(lo >> 8) & 0xFF], 1);
+		p = _mm_insert_epi16(p, pixel[(lo >> 16) & 0xFF], 2);
+		p = _mm_insert_epi16(p, pixel[lo >> 24], 3);
+		p = _mm_insert_epi16(p, pixel[hi & 0xFF], 4);
+		p = _mm_insert_epi16(p, pixel[(hi >> 8) & 0xFF], 5);
+		p = _mm_insert_epi16(p, pixel[(hi >> 16) & 0xFF], 6);
+		p = _mm_insert_epi16(p, pixel[hi >> 24], 7);
+		_mm_storeu_si128((__m128i *)dst, p);
+#else
+		uint16x8_t p = vdupq_n_u16(pixel[lo & 0xFF]);
+		p = vsetq_lane_u16(pixel[(lo >> 8) & 0xFF], p, 1);
+		p = vsetq_lane_u16(pixel[(lo >> 16) & 0xFF], p, 2);
+		p = vsetq_lane_u16(pixel[lo >> 24], p, 3);
+		p = vsetq_lane_u16(pixel[hi & 0xFF], p, 4);
+		p = vsetq_lane_u16(pixel[(hi >> 8) & 0xFF], p, 5);
+		p = vsetq_lane_u16(pixel[(hi >> 16) & 0xFF], p, 6);
+		p = vsetq_lane_u16(pixel[hi >> 24], p, 7);
+		vst1q_u16(dst, p);
+#endif
+	}
+	if (!width) return;
+#endif
+
 	do
 	{
 		*dst++ = pixel[*src++];
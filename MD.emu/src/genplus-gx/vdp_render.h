@@ -24,9 +24,27 @@
 #ifndef _RENDER_H_
 #define _RENDER_H_
 
+#ifdef VDP_RENDER_STATS
+#include <imagine/util/time/sys.hh>
+
+/* Time spent in each line rendering step */
+struct vdp_render_stats_t
+{
+  TimeSys pattern_cache;
+  TimeSys bg;
+  TimeSys obj;
+  TimeSys remap;
+  uint32 patterns;
+  uint32 lines;
+};
+#endif
+
 /* Global variables */
 extern uint8 object_count;
 extern uint16 spr_col;
+#ifdef VDP_RENDER_STATS
+extern vdp_render_stats_t render_stats;
+#endif
 
 /* Function prototypes */
 extern void render_init(void);
@@ -625,12 +625,135 @@ OPFUNCTABLE(Z80xycb,xycb);
  ***************************************************************/
 #define PUSH(SR) do { SP -= 2; WM16( SPD, &Z80.SR ); } while (0)
 
+/***************************************************************
+ * Idle loop detection
+ * A short backward jump is checked the second time it's taken in
+ * a row within one timeslice. If the loop only polls memory that
+ * can't change before the timeslice ends, every further iteration
+ * repeats the last one, so the whole iterations left in the
+ * timeslice are skipped at once (R included) and the last partial
+ * one runs normally, ending on the same cycle as it would have.
+ * Recognized bodies are LD r,(HL) / LD A,(BC) / LD A,(DE) /
+ * LD A,(nn) / LD r,(IX+d) / LD r,(IY+d), alone or followed by
+ * OR / AND / CP of a register or immediate or BIT b,r, and a
+ * single CP (HL) or BIT b,(HL).
+ * Loops polling the YM2612 status aren't skipped since its timer
+ * flags change with time.
+ ***************************************************************/
+static int idle_loop_body(UINT32 pc, UINT32 end)
+{
+  UINT32 addr;
+  UINT8 op;
+
+  if (pc == end) return 1; /* jump to itself */
+
+  op = cpu_readop(pc);
+  switch (op)
+  {
+    case 0x0a: /* LD A,(BC) */
+      addr = BC;
+      pc += 1;
+      break;
+    case 0x1a: /* LD A,(DE) */
+      addr = DE;
+      pc += 1;
+      break;
+    case 0x3a: /* LD A,(nn) */
+      addr = cpu_readop(pc + 1) | (cpu_readop(pc + 2) << 8);
+      pc += 3;
+      break;
+    case 0xbe: /* CP (HL) */
+      return (pc + 1 == end) && z80_idle_read_stable(HL);
+    case 0xcb: /* BIT b,(HL) */
+      op = cpu_readop(pc + 1);
+      return ((op & 0xc7) == 0x46) && (pc + 2 == end) && z80_idle_read_stable(HL);
+    case 0xdd: /* LD r,(IX+d) */
+    case 0xfd: /* LD r,(IY+d) */
+      addr = (op == 0xdd) ? IX : IY;
+      op = cpu_readop(pc + 1);
+      if (((op & 0xc7) != 0x46) || (op == 0x76)) return 0;
+      addr = (addr + (INT8)cpu_readop(pc + 2)) & 0xffff;
+      pc += 3;
+      break;
+    default: /* LD r,(HL), except into H or L */
+      if (((op & 0xc7) != 0x46) || (op == 0x76) || (op == 0x66) || (op == 0x6e)) return 0;
+      addr = HL;
+      pc += 1;
+      break;
+  }
+
+  if (pc != end)
+  {
+    /* test of the loaded value, these give the same result when repeated */
+    op = cpu_readop(pc);
+    if ((((op & 0xf0) == 0xb0) || ((op & 0xf8) == 0xa0)) && ((op & 7) != 6))
+      pc += 1; /* OR r / CP r / AND r */
+    else if ((op == 0xe6) || (op == 0xf6) || (op == 0xfe))
+      pc += 2; /* AND n / OR n / CP n */
+    else if ((op == 0xcb) && ((cpu_readop(pc + 1) & 0xc0) == 0x40) && ((cpu_readop(pc + 1) & 7) != 6))
+      pc += 2; /* BIT b,r */
+    else
+      return 0;
+  }
+
+  return (pc == end) && z80_idle_read_stable(addr);
+}
+
+static void idle_loop(UINT32 branch)
+{
+  uint loopCycles, iterations;
+  UINT8 loopR;
+
+  if (branch != Z80.idleLoopPC)
+  {
+    Z80.idleLoopPC = branch;
+    Z80.idleLoopCycles = Z80.cycleCount;
+    Z80.idleLoopR = R;
+    Z80.idleLoopRejected = 0;
+    return;
+  }
+  if (Z80.idleLoopRejected) return;
+
+  /* the body ran exactly once since the jump was last taken */
+  loopCycles = Z80.cycleCount - Z80.idleLoopCycles;
+  loopR = R - Z80.idleLoopR;
+  Z80.idleLoopCycles = Z80.cycleCount;
+  Z80.idleLoopR = R;
+
+  /* DJNZ also ends up here */
+  if ((cpu_readop(branch) == 0x10) || !loopCycles || !idle_loop_body(PCD, branch))
+  {
+    Z80.idleLoopRejected = 1;
+    return;
+  }
+
+  /* an interrupt will be taken before the next iteration */
+  if (Z80.irq_state && IFF1) return;
+
+  if (Z80.cycleCount >= Z80.endCycles) return;
+  iterations = (Z80.endCycles - Z80.cycleCount) / loopCycles;
+  if (!iterations) return;
+  Z80.cycleCount += iterations * loopCycles;
+  R += iterations * loopR;
+  Z80.idleLoopCycles = Z80.cycleCount;
+  Z80.idleLoopR = R;
+  Z80.idleLoopHits++;
+}
+
+/* branch is the address of the jump opcode, PC the jump target */
+#define IDLE_LOOP(branch) {                                     \
+  if ((PCD <= (branch)) && ((branch) - PCD <= 6) && Z80.idleLoopSkip) \
+    idle_loop(branch);                                          \
+}
+
 /***************************************************************
  * JP
  ***************************************************************/
 #define JP {                                    \
+  UINT32 branch = PCD - 1;                      \
   PCD = ARG16();                                \
   WZ = PCD;                                     \
+  IDLE_LOOP(branch);                            \
 }
 
 /***************************************************************
@@ -639,8 +762,10 @@ OPFUNCTABLE(Z80xycb,xycb);
 #define JP_COND(cond) {                         \
   if (cond)                                     \
   {                                             \
+    UINT32 branch = PCD - 1;                    \
     PCD = ARG16();                              \
     WZ = PCD;                                   \
+    IDLE_LOOP(branch);                          \
   }                                             \
   else                                          \
   {                                             \
@@ -663,8 +788,10 @@ OPFUNCTABLE(Z80xycb,xycb);
 #define JR_COND(cond, opcode) {   \
   if (cond)                       \
   {                               \
+    UINT32 branch = PCD - 1;      \
     JR();                         \
     CC(ex, opcode);               \
+    IDLE_LOOP(branch);            \
   }                               \
   else PC++;                      \
 }
@@ -2895,7 +3022,7 @@ OP(op,15) { D = DEC(D);
 OP(op,16) { D = ARG();                                                                                     } /* LD   D,n         */
 OP(op,17) { RLA;                                                                                           } /* RLA              */
 
-OP(op,18) { JR();                                                                                          } /* JR   o           */
+OP(op,18) { UINT32 branch = PCD - 1; JR(); IDLE_LOOP(branch);                                              } /* JR   o           */
 OP(op,19) { ADD16(hl, de);                                                                                 } /* ADD  HL,DE       */
 OP(op,1a) { A = RM( DE ); WZ=DE+1;                                                                         } /* LD   A,(DE)      */
 OP(op,1b) { DE--;                                                                                          } /* DEC  DE          */
@@ -3288,6 +3415,10 @@ void Z80CPU::run(unsigned int cycles)
 {
 	//logMsg("loop %d to %d, %d", Z80.cycleCount, cycles, cycles - Z80.cycleCount);
 
+	endCycles = cycles;
+	// memory may have changed since the last timeslice, loops must be seen again
+	idleLoopPC = ~0u;
+
 	#ifdef Z80_COMPUTED_GOTO_EXEC
 	static const void *opL[] =
 	{
@@ -52,6 +52,7 @@ class Z80CPU : public Z80_Regs
 {
 public:
 	uint cycleCount;
+	uint endCycles;
 	unsigned char *readmap[64];
 	unsigned char *writemap[64];
 
@@ -60,6 +61,14 @@ public:
 	void (*writeport)(unsigned int port, unsigned char data);
 	unsigned char (*readport)(unsigned int port);
 
+	// idle loop detection, see idle_loop() in z80.cc
+	bool idleLoopSkip = 1; // can be turned off for accuracy testing
+	bool idleLoopRejected = 0;
+	uint idleLoopPC = ~0u;
+	uint idleLoopCycles = 0;
+	UINT8 idleLoopR = 0;
+	uint idleLoopHits = 0;
+
 	void init();
 	void reset();
 	void exit();
@@ -78,6 +87,9 @@ private:
 
 extern Z80CPU Z80;
 
+// returns non-zero if reading address can't give a different value until the Z80 timeslice ends
+extern int z80_idle_read_stable(unsigned int address);
+
 #define z80_readmap Z80.readmap
 #define z80_writemap Z80.writemap
 #define z80_readmem Z80.readmem
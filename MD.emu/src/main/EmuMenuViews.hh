@@ -40,6 +40,15 @@ public:
 			config_ym2413_enabled = optionSmsFM;
 		}
 	},
+	idleLoopSkip
+	{
+		[this](BoolMenuItem &item, View &, const Input::Event &e)
+		{
+			item.toggle(*this);
+			optionIdleLoopSkip = item.on;
+			setIdleLoopSkip(item.on);
+		}
+	},
 	bigEndianSram
 	{
 		[this](BoolMenuItem &item, View &, const Input::Event &e)
@@ -246,6 +255,7 @@ public:
 		OptionView::loadSystemItems(item, items);
 		bigEndianSram.init("Use Big-Endian SRAM", optionBigEndianSram); item[items++] = &bigEndianSram;
 		regionInit(); item[items++] = &region;
+		idleLoopSkip.init("Skip Idle Loops", optionIdleLoopSkip); item[items++] = &idleLoopSkip;
 		#ifndef NO_SCD
 		cdBiosPathInit(item, items);
 		#endif
@@ -26,7 +26,11 @@
 #include "state.h"
 #include "sound.h"
 #include "vdp_ctrl.h"
+#ifdef VDP_RENDER_STATS
+#include "vdp_render.h"
+#endif
 #include "genesis.h"
+#include "z80.h"
 #include "genplus-config.h"
 #include "EmuConfig.hh"
 #ifndef NO_SCD
@@ -106,6 +110,7 @@ enum {
 	CFGKEY_6_BTN_PAD = 280, CFGKEY_MD_CD_BIOS_USA_PATH = 281,
 	CFGKEY_MD_CD_BIOS_JPN_PATH = 282, CFGKEY_MD_CD_BIOS_EUR_PATH = 283,
 	CFGKEY_MD_REGION = 284, CFGKEY_VIDEO_SYSTEM = 285,
+	CFGKEY_IDLE_LOOP_SKIP = 286,
 };
 
 static bool usingMultiTap = 0;
@@ -120,8 +125,18 @@ static PathOption optionCDBiosJpnPath(CFGKEY_MD_CD_BIOS_JPN_PATH, cdBiosJpnPath,
 static PathOption optionCDBiosEurPath(CFGKEY_MD_CD_BIOS_EUR_PATH, cdBiosEurPath, "");
 #endif
 static Byte1Option optionVideoSystem(CFGKEY_VIDEO_SYSTEM, 0);
+static Byte1Option optionIdleLoopSkip(CFGKEY_IDLE_LOOP_SKIP, 1);
 static uint autoDetectedVidSysPAL = 0;
 
+static void setIdleLoopSkip(bool on)
+{
+	mm68k.idleLoopSkip = on;
+	Z80.idleLoopSkip = on;
+	#ifndef NO_SCD
+	sCD.cpu.idleLoopSkip = on;
+	#endif
+}
+
 const char *EmuSystem::inputFaceBtnName = "A/B/C";
 const char *EmuSystem::inputCenterBtnName = "Mode/Start";
 const uint EmuSystem::inputFaceBtns = 6;
@@ -163,6 +178,7 @@ void EmuSystem::onOptionsLoaded()
 	vController.gp.activeFaceBtns = option6BtnPad ? 6 : 3;
 	#endif
 	config_ym2413_enabled = optionSmsFM;
+	setIdleLoopSkip(optionIdleLoopSkip);
 }
 
 bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
@@ -188,6 +204,7 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 				optionRegion = 0;
 		}
 		bcase CFGKEY_VIDEO_SYSTEM: optionVideoSystem.readFromIO(io, readSize);
+		bcase CFGKEY_IDLE_LOOP_SKIP: optionIdleLoopSkip.readFromIO(io, readSize);
 		bdefault: return 0;
 	}
 	return 1;
@@ -199,6 +216,7 @@ void EmuSystem::writeConfig(IO &io)
 	optionSmsFM.writeWithKeyIfNotDefault(io);
 	option6BtnPad.writeWithKeyIfNotDefault(io);
 	optionVideoSystem.writeWithKeyIfNotDefault(io);
+	optionIdleLoopSkip.writeWithKeyIfNotDefault(io);
 	#ifndef NO_SCD
 	optionCDBiosUsaPath.writeToIO(io);
 	optionCDBiosJpnPath.writeToIO(io);
@@ -493,11 +511,15 @@ void EmuSystem::saveAutoState()
 void EmuSystem::closeSystem()
 {
 	saveBackupMem();
+	logMsg("idle loops skipped: 68K %u, Z80 %u", mm68k.idleLoopHits, Z80.idleLoopHits);
+	mm68k.idleLoopHits = Z80.idleLoopHits = 0;
 	#ifndef NO_SCD
 	if(sCD.isActive)
 	{
+		logMsg("idle loops skipped: sub-68K %u", sCD.cpu.idleLoopHits);
 		scd_deinit();
 	}
+	sCD.cpu.idleLoopHits = 0;
 	#endif
 	old_system[0] = old_system[1] = -1;
 	clearCheatList();
@@ -854,6 +876,22 @@ CallResult onInit(int argc, char** argv)
 
 	mainInitCommon(argc, argv, navViewGrad);
 
+	#ifdef VDP_RENDER_STATS
+	EmuSystem::onBenchmarkStats() =
+		[](char *str, uint size, uint frames)
+		{
+			if(!str)
+			{
+				render_stats = {};
+				return;
+			}
+			auto perFrame = [frames](TimeSys t) { return double(t) * 1000. / frames; };
+			snprintf(str, size, "VDP ms/frame: patterns %.3f, planes %.3f, sprites %.3f, remap %.3f",
+				perFrame(render_stats.pattern_cache), perFrame(render_stats.bg),
+				perFrame(render_stats.obj), perFrame(render_stats.remap));
+		};
+	#endif
+
 	mainWin.win.setOnInputEvent(
 		[](Base::Window &win, const Input::Event &e)
 		{
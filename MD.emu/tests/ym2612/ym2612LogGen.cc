@@ -0,0 +1,165 @@
+/*  This file is part of MD.emu.
+
+	MD.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	MD.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with MD.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Generates the YM2612 register logs in logs/, each one weighted towards
+// a feature that has its own code in ym2612.cc. See ym2612Replay.cc for
+// the log format.
+// Usage: ym2612LogGen <mixed|ssgeg|lfo|csm|dac> [seed] [writes]
+// The default seed differs per kind
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+static uint32_t rngState = 1;
+
+static uint32_t rnd()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+static bool chance(int n) { return rnd() % n == 0; }
+
+static void write(int wait, int reg, int val)
+{
+	printf("%d %d %02x %02x\n", wait, reg >> 8, reg & 0xff, val & 0xff);
+}
+
+enum Kind { MIXED, SSGEG, LFO, CSM, DAC };
+
+// typical gap between writes: mostly short, with longer note-length pauses
+static int randomWait()
+{
+	return chance(8) ? rnd() % 3000 : rnd() % 200;
+}
+
+static void randomWrite(Kind kind, int wait)
+{
+	int maxCh = kind == DAC ? 5 : 6; // channel 6 is the DAC while it's enabled
+	int ch = rnd() % maxCh;
+	int part = ch >= 3 ? 0x100 : 0;
+	int c = ch % 3;
+	int slot = (rnd() % 4) * 4 + c;
+	switch(rnd() % 16)
+	{
+		case 0: case 1: // key on/off, any operator mask
+			write(wait, 0x28, (rnd() & 0xF0) | (ch < 3 ? c : c + 4));
+			break;
+		case 2: // frequency
+			write(wait, part | (0xA4 + c), rnd() & 0x3F);
+			write(0, part | (0xA0 + c), rnd());
+			break;
+		case 3: // feedback/algorithm
+			write(wait, part | (0xB0 + c), rnd());
+			break;
+		case 4: // pan and LFO sensitivity
+		{
+			int pan = chance(4) ? 0x80 : 0xC0;
+			int sens = kind == LFO ? (rnd() & 0x37) | 0x11 : rnd() & 0x37;
+			write(wait, part | (0xB4 + c), pan | sens);
+			break;
+		}
+		case 5: // LFO enable and frequency
+			write(wait, 0x22, kind == LFO ? (rnd() & 0x07) | 0x08 : rnd() & 0x0F);
+			break;
+		case 6: // detune/multiple, total level, rate and release registers
+			write(wait, part | (0x30 + (rnd() % 7) * 0x10 + slot), rnd());
+			break;
+		case 7: // SSG-EG, modes 8-15 enable it
+		{
+			int val = kind == SSGEG ? 0x08 | (rnd() & 0x07) : (chance(3) ? rnd() : 0);
+			write(wait, part | (0x90 + slot), val);
+			break;
+		}
+		case 8: // DAC enable
+			write(wait, 0x2B, (kind == DAC || chance(3)) ? 0x80 : 0);
+			break;
+		case 9: // DAC sample
+			write(wait, 0x2A, rnd());
+			break;
+		case 10: // timer control, ch3 special mode and CSM
+		{
+			int mode = rnd() & 0x3F;
+			if(kind == CSM)
+				mode |= chance(2) ? 0x80 : 0x40;
+			else if(chance(4))
+				mode |= 0x40;
+			write(wait, 0x27, mode);
+			break;
+		}
+		case 11: // timer A/B periods, kept short for CSM so timer A overflows often
+			write(wait, 0x24, kind == CSM ? 0xF0 | (rnd() & 0x0F) : rnd());
+			write(0, 0x25, rnd());
+			write(0, 0x26, rnd());
+			break;
+		case 12: // ch3 special mode operator frequencies
+		{
+			int op = rnd() % 3;
+			write(wait, 0xAC + op, rnd() & 0x3F);
+			write(0, 0xA8 + op, rnd());
+			break;
+		}
+		case 13: // total level
+			write(wait, part | (0x40 + slot), rnd() & 0x3F);
+			break;
+		default: // attack, decay, sustain and release rates (bit 7 of 0x60 is AM enable)
+		{
+			int val = rnd();
+			if(kind == LFO && (rnd() % 4) == 1)
+				val |= 0x80;
+			write(wait, part | (0x50 + (rnd() % 4) * 0x10 + slot), val);
+			break;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	static const char *kindName[] = { "mixed", "ssgeg", "lfo", "csm", "dac" };
+	int kind = -1;
+	for(int i = 0; argc > 1 && i < 5; i++)
+	{
+		if(!strcmp(argv[1], kindName[i]))
+			kind = i;
+	}
+	if(kind < 0)
+	{
+		fprintf(stderr, "usage: %s <mixed|ssgeg|lfo|csm|dac> [seed] [writes]\n", argv[0]);
+		return 1;
+	}
+	rngState = argc > 2 ? strtoul(argv[2], nullptr, 0) : kind + 1;
+	if(!rngState)
+		rngState = 1;
+	int writes = argc > 3 ? atoi(argv[3]) : 2500;
+	printf("# YM2612 register log: %s, seed %u, generated by ym2612LogGen\n", kindName[kind], rngState);
+	printf("# <samples to render before the write> <port> <register> <value>\n");
+	if(kind == DAC)
+		write(0, 0x2B, 0x80);
+	for(int i = 0; i < writes; i++)
+	{
+		if(kind == DAC && !chance(4))
+		{
+			// stream PCM at roughly 8-20kHz between the FM writes
+			write(1 + rnd() % 6, 0x2A, 0x80 + (int)(rnd() % 96) - 48);
+			continue;
+		}
+		randomWrite((Kind)kind, randomWait());
+	}
+	return 0;
+}
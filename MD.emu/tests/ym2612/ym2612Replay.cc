@@ -0,0 +1,177 @@
+/*  This file is part of MD.emu.
+
+	MD.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	MD.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with MD.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Replays YM2612 register logs through the block renderer and through a
+// second copy of ym2612.cc built with YM2612_PER_SAMPLE_UPDATE, whose
+// functions are renamed with a ref_ prefix (see Makefile), and checks the
+// output samples and status reads are identical.
+// Log lines are "<samples> <port> <register> <value>" with the register
+// and value in hex: render that many samples, then write the register.
+// Lines starting with # are comments.
+// Usage: ym2612Replay log...
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include "ym2612.h"
+
+extern void ref_YM2612Init(SysDDec clock, int rate);
+extern void ref_YM2612ResetChip(void);
+extern void ref_YM2612Update(FMSampleType *buffer, int length);
+extern void ref_YM2612Write(unsigned int a, unsigned int v);
+extern unsigned int ref_YM2612Read(void);
+
+struct RegWrite
+{
+	int wait, port, reg, val, line;
+};
+
+struct Chip
+{
+	void (*init)(SysDDec clock, int rate);
+	void (*reset)(void);
+	void (*update)(FMSampleType *buffer, int length);
+	void (*write)(unsigned int a, unsigned int v);
+	unsigned int (*read)(void);
+};
+
+static const Chip blockChip { YM2612Init, YM2612ResetChip, YM2612Update, YM2612Write, YM2612Read };
+static const Chip refChip { ref_YM2612Init, ref_YM2612ResetChip, ref_YM2612Update, ref_YM2612Write, ref_YM2612Read };
+
+// NTSC master clock / 7, rendered at the chip's native rate
+static const SysDDec chipClock = 53693175. / 7.;
+static const int rate = 53267;
+// a bit less than one frame of samples per update call, as the emulator does
+static const int maxUpdate = 800;
+
+static bool loadLog(const char *path, std::vector<RegWrite> &log)
+{
+	FILE *f = fopen(path, "r");
+	if(!f)
+	{
+		perror(path);
+		return false;
+	}
+	char line[256];
+	for(int lineNum = 1; fgets(line, sizeof line, f); lineNum++)
+	{
+		if(line[0] == '#' || line[0] == '\n')
+			continue;
+		RegWrite w;
+		if(sscanf(line, "%d %d %x %x", &w.wait, &w.port, &w.reg, &w.val) != 4
+			|| w.wait < 0 || w.port < 0 || w.port > 1)
+		{
+			fprintf(stderr, "%s:%d: bad log line\n", path, lineNum);
+			fclose(f);
+			return false;
+		}
+		w.line = lineNum;
+		log.push_back(w);
+	}
+	fclose(f);
+	return true;
+}
+
+// renders the log, appending the samples to out and the status read after each write to status
+static double replay(const Chip &chip, const std::vector<RegWrite> &log,
+	std::vector<FMSampleType> &out, std::vector<unsigned int> &status)
+{
+	static FMSampleType buff[maxUpdate * 2];
+	auto start = std::chrono::steady_clock::now();
+	chip.init(chipClock, rate);
+	chip.reset();
+	for(auto &w : log)
+	{
+		for(int left = w.wait; left;)
+		{
+			int samples = left < maxUpdate ? left : maxUpdate;
+			chip.update(buff, samples);
+			out.insert(out.end(), buff, buff + samples * 2);
+			left -= samples;
+		}
+		chip.write(w.port * 2, w.reg);
+		chip.write(w.port * 2 + 1, w.val);
+		status.push_back(chip.read());
+	}
+	// let the last notes decay
+	chip.update(buff, maxUpdate);
+	out.insert(out.end(), buff, buff + maxUpdate * 2);
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// line of the write that precedes the given output sample
+static int lineForSample(const std::vector<RegWrite> &log, size_t sample)
+{
+	size_t pos = 0;
+	int line = 0;
+	for(auto &w : log)
+	{
+		pos += w.wait;
+		if(pos > sample)
+			break;
+		line = w.line;
+	}
+	return line;
+}
+
+static bool testLog(const char *path)
+{
+	std::vector<RegWrite> log;
+	if(!loadLog(path, log))
+		return false;
+	std::vector<FMSampleType> refOut, blockOut;
+	std::vector<unsigned int> refStatus, blockStatus;
+	double refTime = replay(refChip, log, refOut, refStatus);
+	double blockTime = replay(blockChip, log, blockOut, blockStatus);
+	if(refOut != blockOut)
+	{
+		size_t i = 0;
+		while(refOut[i] == blockOut[i])
+			i++;
+		fprintf(stderr, "%s: %s channel of sample %zu differs (%d vs %d per-sample), after line %d\n",
+			path, i % 2 ? "right" : "left", i / 2, blockOut[i], refOut[i], lineForSample(log, i / 2));
+		return false;
+	}
+	if(refStatus != blockStatus)
+	{
+		size_t i = 0;
+		while(refStatus[i] == blockStatus[i])
+			i++;
+		fprintf(stderr, "%s:%d: status 0x%02X differs from per-sample 0x%02X\n",
+			path, log[i].line, blockStatus[i], refStatus[i]);
+		return false;
+	}
+	printf("%s: %zu samples match, per-sample %.1fms, block %.1fms\n",
+		path, refOut.size() / 2, refTime, blockTime);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s log...\n", argv[0]);
+		return 1;
+	}
+	int failed = 0;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!testLog(argv[i]))
+			failed++;
+	}
+	return failed ? 1 : 0;
+}
@@ -46,6 +46,9 @@ uint8 *MMC5BGVPage[8];
 
 static uint8 PRGIsRAM[32];  /* This page is/is not PRG RAM. */
 
+uint8 *CPUReadPage[32], *CPUWritePage[32];
+uint8 CPUPageKindR[32], CPUPageKindW[32];
+
 /* 16 are (sort of) reserved for UNIF/iNES and 16 to map other stuff. */
 uint8 CHRram[32];
 uint8 PRGram[32];
@@ -76,6 +79,24 @@ uint8 geniech[3];
 
 uint32 genieaddr[3];
 
+void FCEU_UpdateCPUPage(int p) {
+	uint8 *ram = RAM - (p << 11);
+
+	if (CPUPageKindR[p] == CPUPAGE_RAM)
+		CPUReadPage[p] = ram;
+	else if (CPUPageKindR[p] == CPUPAGE_CART)
+		CPUReadPage[p] = Page[p];
+	else
+		CPUReadPage[p] = 0;
+
+	if (CPUPageKindW[p] == CPUPAGE_RAM)
+		CPUWritePage[p] = ram;
+	else if (CPUPageKindW[p] == CPUPAGE_CART && PRGIsRAM[p])
+		CPUWritePage[p] = Page[p];
+	else
+		CPUWritePage[p] = 0;
+}
+
 static INLINE void setpageptr(int s, uint32 A, uint8 *p, int ram) {
 	uint32 AB = A >> 11;
 	int x;
@@ -84,11 +105,13 @@ static INLINE void setpageptr(int s, uint32 A, uint8 *p, int ram) {
 		for (x = (s >> 1) - 1; x >= 0; x--) {
 			PRGIsRAM[AB + x] = ram;
 			Page[AB + x] = p - A;
+			FCEU_UpdateCPUPage(AB + x);
 		}
 	else
 		for (x = (s >> 1) - 1; x >= 0; x--) {
 			PRGIsRAM[AB + x] = 0;
 			Page[AB + x] = 0;
+			FCEU_UpdateCPUPage(AB + x);
 		}
 }
 
@@ -102,6 +125,7 @@ void ResetCartMapping(void) {
 		Page[x] = nothing - x * 2048;
 		PRGptr[x] = CHRptr[x] = 0;
 		PRGsize[x] = CHRsize[x] = 0;
+		FCEU_UpdateCPUPage(x);
 	}
 	for (x = 0; x < 8; x++) {
 		MMC5SPRVPage[x] = MMC5BGVPage[x] = VPageR[x] = nothing - 0x400 * x;
@@ -131,6 +155,7 @@ void SetupCartCHRMapping(int chip, uint8 *p, uint32 size, int ram) {
 	CHRmask8[chip] = (size >> 13) - 1;
 
 	CHRram[chip] = ram;
+	FCEUPPU_FlushCHRCache(0);
 }
 
 DECLFR(CartBR) {
@@ -27,6 +27,19 @@ void FCEU_ClearGameSave(CartInfo *LocalHWInfo);
 
 extern uint8 *Page[32], *VPage[8], *MMC5SPRVPage[8], *MMC5BGVPage[8];
 
+/* 2KB CPU pages the 6502 core can access with a plain pointer, indexed like Page[].
+   NULL means the page goes through ARead/BWrite. */
+extern uint8 *CPUReadPage[32], *CPUWritePage[32];
+
+enum {
+	CPUPAGE_HANDLERS = 0,	/* I/O or mapper handlers somewhere in the page */
+	CPUPAGE_RAM,			/* internal RAM and its mirrors */
+	CPUPAGE_CART			/* only CartBR/CartBW, follows Page[] */
+};
+extern uint8 CPUPageKindR[32], CPUPageKindW[32];
+
+void FCEU_UpdateCPUPage(int p);
+
 void ResetCartMapping(void);
 void SetupCartPRGMapping(int chip, uint8 *p, uint32 size, int ram);
 void SetupCartCHRMapping(int chip, uint8 *p, uint32 size, int ram);
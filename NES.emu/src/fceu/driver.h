@@ -156,6 +156,10 @@ void FCEUI_SetPCMVolume(uint32 volume);
 
 void FCEUI_SetSoundQuality(int quality);
 
+//Renders the low quality sound path with band-limited steps instead of
+//point sampling the channels, at any sample rate.
+void FCEUI_SetBandLimitedSound(int on);
+
 void FCEUD_SoundToggle(void);
 void FCEUD_SoundVolumeAdjust(int);
 
@@ -166,6 +170,11 @@ extern void FCEUI_SelectStateNext(int);
 int FCEUI_SaveState(const char *fname, bool display_message=true);
 int FCEUI_LoadState(const char *fname, bool display_message=true);
 
+//Saves to or loads from an uncompressed state in memory. Pass the same buf
+//each time so it keeps its capacity and saving doesn't allocate.
+bool FCEUI_SaveStateMem(std::vector<uint8> &buf);
+bool FCEUI_LoadStateMem(std::vector<uint8> &buf);
+
 void FCEUD_SaveStateAs(void);
 void FCEUD_LoadStateFrom(void);
 
@@ -0,0 +1,112 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+// Palette index to native color conversion of a finished PPU line,
+// used by DoLine() and NES.emu/tests/expandline
+
+#include "types.h"
+#include "ppu.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+//Offset of the 64 color nativeCol bank for the emphasis bits of PPU[1].
+//Line pixels never have bit 7 set, so the |0x40 of the partial emphasis
+//bank is the same as masking with 0x3f.
+static inline uint ExpandLineBank(uint8 ppu1) {
+	if ((ppu1 >> 5) == 0x7)
+		return 0xc0;
+	else if (ppu1 & 0xE0)
+		return 0x40;
+	else
+		return 0x80;
+}
+
+//Converts a line of palette indexes, masked by mask, through the 64 colors at col.
+//With NEON the colors are split into byte planes and looked up with vtbl.
+static inline void ExpandLine(NATIVE_PIX_TYPE * __restrict out, const uint8 * __restrict in, uint8 mask, const NATIVE_PIX_TYPE * __restrict col) {
+#if defined(__ARM_NEON__) && defined(__aarch64__)
+	uint8x16_t m = vdupq_n_u8(mask);
+	#ifdef USE_PIX_RGB565
+	uint8x16x2_t c0 = vld2q_u8((const uint8*)col), c1 = vld2q_u8((const uint8*)(col + 16)),
+		c2 = vld2q_u8((const uint8*)(col + 32)), c3 = vld2q_u8((const uint8*)(col + 48));
+	uint8x16x4_t lo = { { c0.val[0], c1.val[0], c2.val[0], c3.val[0] } };
+	uint8x16x4_t hi = { { c0.val[1], c1.val[1], c2.val[1], c3.val[1] } };
+	for (int x = 0; x < 256; x += 16) {
+		uint8x16_t idx = vandq_u8(vld1q_u8(in + x), m);
+		uint8x16x2_t pix = { { vqtbl4q_u8(lo, idx), vqtbl4q_u8(hi, idx) } };
+		vst2q_u8((uint8*)(out + x), pix);
+	}
+	#else
+	uint8x16x4_t c[4] = { vld4q_u8((const uint8*)col), vld4q_u8((const uint8*)(col + 16)),
+		vld4q_u8((const uint8*)(col + 32)), vld4q_u8((const uint8*)(col + 48)) };
+	uint8x16x4_t plane[4];
+	for (int b = 0; b < 4; b++) {
+		uint8x16x4_t t = { { c[0].val[b], c[1].val[b], c[2].val[b], c[3].val[b] } };
+		plane[b] = t;
+	}
+	for (int x = 0; x < 256; x += 16) {
+		uint8x16_t idx = vandq_u8(vld1q_u8(in + x), m);
+		uint8x16x4_t pix = { { vqtbl4q_u8(plane[0], idx), vqtbl4q_u8(plane[1], idx),
+			vqtbl4q_u8(plane[2], idx), vqtbl4q_u8(plane[3], idx) } };
+		vst4q_u8((uint8*)(out + x), pix);
+	}
+	#endif
+#elif defined(__ARM_NEON__)
+	//vtbl4 covers 32 entries, vtbx4 with the index minus 32 fills in the upper half
+	//(indexes below 32 wrap past 223 and leave those lanes alone)
+	uint8x8_t m = vdup_n_u8(mask), off = vdup_n_u8(32);
+	#ifdef USE_PIX_RGB565
+	uint8x16x2_t c0 = vld2q_u8((const uint8*)col), c1 = vld2q_u8((const uint8*)(col + 16)),
+		c2 = vld2q_u8((const uint8*)(col + 32)), c3 = vld2q_u8((const uint8*)(col + 48));
+	uint8x8x4_t loA = { { vget_low_u8(c0.val[0]), vget_high_u8(c0.val[0]), vget_low_u8(c1.val[0]), vget_high_u8(c1.val[0]) } };
+	uint8x8x4_t loB = { { vget_low_u8(c2.val[0]), vget_high_u8(c2.val[0]), vget_low_u8(c3.val[0]), vget_high_u8(c3.val[0]) } };
+	uint8x8x4_t hiA = { { vget_low_u8(c0.val[1]), vget_high_u8(c0.val[1]), vget_low_u8(c1.val[1]), vget_high_u8(c1.val[1]) } };
+	uint8x8x4_t hiB = { { vget_low_u8(c2.val[1]), vget_high_u8(c2.val[1]), vget_low_u8(c3.val[1]), vget_high_u8(c3.val[1]) } };
+	for (int x = 0; x < 256; x += 8) {
+		uint8x8_t idx = vand_u8(vld1_u8(in + x), m);
+		uint8x8_t idxB = vsub_u8(idx, off);
+		uint8x8x2_t pix = { { vtbx4_u8(vtbl4_u8(loA, idx), loB, idxB), vtbx4_u8(vtbl4_u8(hiA, idx), hiB, idxB) } };
+		vst2_u8((uint8*)(out + x), pix);
+	}
+	#else
+	uint8x16x4_t c[4] = { vld4q_u8((const uint8*)col), vld4q_u8((const uint8*)(col + 16)),
+		vld4q_u8((const uint8*)(col + 32)), vld4q_u8((const uint8*)(col + 48)) };
+	uint8x8x4_t planeA[4], planeB[4];
+	for (int b = 0; b < 4; b++) {
+		uint8x8x4_t a = { { vget_low_u8(c[0].val[b]), vget_high_u8(c[0].val[b]), vget_low_u8(c[1].val[b]), vget_high_u8(c[1].val[b]) } };
+		uint8x8x4_t t = { { vget_low_u8(c[2].val[b]), vget_high_u8(c[2].val[b]), vget_low_u8(c[3].val[b]), vget_high_u8(c[3].val[b]) } };
+		planeA[b] = a;
+		planeB[b] = t;
+	}
+	for (int x = 0; x < 256; x += 8) {
+		uint8x8_t idx = vand_u8(vld1_u8(in + x), m);
+		uint8x8_t idxB = vsub_u8(idx, off);
+		uint8x8x4_t pix = { { vtbx4_u8(vtbl4_u8(planeA[0], idx), planeB[0], idxB),
+			vtbx4_u8(vtbl4_u8(planeA[1], idx), planeB[1], idxB),
+			vtbx4_u8(vtbl4_u8(planeA[2], idx), planeB[2], idxB),
+			vtbx4_u8(vtbl4_u8(planeA[3], idx), planeB[3], idxB) } };
+		vst4_u8((uint8*)(out + x), pix);
+	}
+	#endif
+#else
+	for (int x = 0; x < 256; x++)
+		out[x] = col[in[x] & mask];
+#endif
+}
@@ -181,6 +181,7 @@ static void FCEU_CloseGame(void)
 		}
 
 		GameInterface(GI_CLOSE);
+		FCEUPPU_FlushCHRCache(0);
 
 		FCEUI_StopMovie();
 
@@ -277,6 +278,7 @@ void FlushGenieRW(void) {
 		AReadG = NULL;
 		BWriteG = NULL;
 		RWWrap = 0;
+		FCEU_UpdateCPUPageKinds(0x8000, 0xFFFF);
 	}
 }
 
@@ -303,6 +305,7 @@ void SetReadHandler(int32 start, int32 end, readfunc func) {
 	else
 		for (x = end; x >= start; x--)
 			ARead[x] = func;
+	FCEU_UpdateCPUPageKinds(start, end);
 }
 
 writefunc GetWriteHandler(int32 a) {
@@ -328,6 +331,7 @@ void SetWriteHandler(int32 start, int32 end, writefunc func) {
 	else
 		for (x = end; x >= start; x--)
 			BWrite[x] = func;
+	FCEU_UpdateCPUPageKinds(start, end);
 }
 
 uint8 GameMemBlock[GAME_MEM_BLOCK_SIZE];
@@ -371,6 +375,39 @@ static DECLFR(ARAMH) {
 	return RAM[A & 0x7FF];
 }
 
+// Finds the 2KB pages in [start, end] that only use the RAM or plain cartridge
+// handlers, the CPU core reads and writes those through CPUReadPage/CPUWritePage.
+void FCEU_UpdateCPUPageKinds(int32 start, int32 end) {
+	for (int32 p = start >> 11; p <= (end >> 11); p++) {
+		int32 base = p << 11;
+		readfunc rf = ARead[base];
+		writefunc wf = BWrite[base];
+
+		for (int32 x = base + 1; x < base + 0x800 && (rf || wf); x++) {
+			if (ARead[x] != rf)
+				rf = NULL;
+			if (BWrite[x] != wf)
+				wf = NULL;
+		}
+
+		if (rf == ARAML || rf == ARAMH)
+			CPUPageKindR[p] = CPUPAGE_RAM;
+		else if (rf == CartBR)
+			CPUPageKindR[p] = CPUPAGE_CART;
+		else
+			CPUPageKindR[p] = CPUPAGE_HANDLERS;
+
+		if (wf == BRAML || wf == BRAMH)
+			CPUPageKindW[p] = CPUPAGE_RAM;
+		else if (wf == CartBW)
+			CPUPageKindW[p] = CPUPAGE_CART;
+		else
+			CPUPageKindW[p] = CPUPAGE_HANDLERS;
+
+		FCEU_UpdateCPUPage(p);
+	}
+}
+
 
 void ResetGameLoaded(void) {
 	if (GameInfo) FCEU_CloseGame();
@@ -759,6 +796,7 @@ void ResetNES(void) {
 	FCEUMOV_AddCommand(FCEUNPCMD_RESET);
 	if (!GameInfo) return;
 	GameInterface(GI_RESETM2);
+	FCEUPPU_FlushCHRCache(1);
 	FCEUSND_Reset();
 	FCEUPPU_Reset();
 	X6502_Reset();
@@ -824,6 +862,7 @@ void PowerNES(void) {
 	GameInterface(GI_POWER);
 	if (GameInfo->type == GIT_VSUNI)
 		FCEU_VSUniPower();
+	FCEUPPU_FlushCHRCache(0);
 
 	//if we are in a movie, then reset the saveram
 	extern int disableBatteryLoading;
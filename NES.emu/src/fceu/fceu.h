@@ -57,6 +57,7 @@ uint8 FCEU_ReadRomByte(uint32 i);
 
 extern readfunc ARead[0x10000];
 extern writefunc BWrite[0x10000];
+void FCEU_UpdateCPUPageKinds(int32 start, int32 end);
 
 enum GI {
 	GI_RESETM2	=1,
@@ -109,6 +110,7 @@ struct FCEUS {
 #else
 	int soundq;
 #endif
+	int bandlimit;
 	int lowpass;
 };
 
@@ -12,6 +12,7 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 
 static int32 sq2coeffs[SQ2NCOEFFS];
 static int32 coeffs[NCOEFFS];
@@ -19,6 +20,26 @@ static int32 coeffs[NCOEFFS];
 static uint32 mrindex;
 static uint32 mrratio;
 
+/* Band-limited step synthesis, used instead of the low quality renderers
+   when FSettings.bandlimit is set.  Each level change is added to blbuf as
+   a windowed sinc impulse at its exact output sample position, and
+   BLSynthRead() integrates the impulses back into steps.  The cutoff is
+   relative to the output rate, so any rate works without coefficient
+   tables.
+*/
+#define BL_TAPS 16
+#define BL_PHASE_BITS 6
+#define BL_PHASES (1<<BL_PHASE_BITS)
+#define BL_INTERP_BITS 10
+#define BL_UNIT_BITS 14
+
+static int32 blkernel[BL_PHASES+1][BL_TAPS];
+static int32 blbuf[2048+512+BL_TAPS+1];
+static int32 blacc;
+static uint64 blfactor;	/* Output samples per SOUNDTS cycle, 32.32 fixed point. */
+static uint64 blorigin;	/* Position of SOUNDTS 0 in blbuf, 32.32 fixed point. */
+static uint64 blend;
+
 void SexyFilter2(FCEU_SoundSample *in, int32 count)
 {
  #ifdef moo
@@ -84,6 +105,116 @@ void SexyFilter(InSample *in, FCEU_SoundSample *out, int32 count)
 
 template void SexyFilter(FCEU_SoundSample *in, FCEU_SoundSample *out, int32 count);
 
+void BLSynthDelta(uint32 ts, int32 delta)
+{
+ uint64 pos=blorigin+(uint64)ts*blfactor;
+ uint32 frac=(uint32)pos;
+ const int32 *a=blkernel[frac>>(32-BL_PHASE_BITS)];
+ const int32 *b=a+BL_TAPS;
+ int32 *out=&blbuf[pos>>32];
+ int32 d1,d2;
+ int x;
+
+ /* Split the delta between the two nearest phases so the impulse still
+    sums to exactly delta<<BL_UNIT_BITS. */
+ d2=(delta*(int32)((frac>>(32-BL_PHASE_BITS-BL_INTERP_BITS))&((1<<BL_INTERP_BITS)-1)))>>BL_INTERP_BITS;
+ d1=delta-d2;
+ for(x=0;x<BL_TAPS;x++)
+  out[x]+=a[x]*d1+b[x]*d2;
+}
+
+/* Returns the position of ts in 1/16 samples, the units the low quality
+   code counts in, and marks it as the end of the frame. */
+int32 BLSynthEndFrame(uint32 ts)
+{
+ blend=blorigin+(uint64)ts*blfactor;
+ return (int32)(blend>>28);
+}
+
+/* Adds the frame's count integrated samples to out and drops them from the
+   buffer.  Returns the SOUNDTS the next frame should start at; unlike the
+   low quality code's soundtsoffs rounding, the sub-cycle remainder is kept
+   in blorigin so the channels don't jitter from frame to frame. */
+uint32 BLSynthRead(FCEU_SoundSample *out, int32 count)
+{
+ uint64 left;
+ uint32 offs;
+ int32 acc=blacc;
+ int32 x;
+
+ for(x=0;x<count;x++)
+ {
+  int32 t;
+  acc+=blbuf[x];
+  t=out[x]+(acc>>BL_UNIT_BITS);
+  if(t>32767) t=32767;
+  if(t<-32768) t=-32768;
+  out[x]=t;
+ }
+ blacc=acc;
+
+ memmove(blbuf,blbuf+count,(BL_TAPS+1)*sizeof(int32));
+ memset(blbuf+BL_TAPS+1,0,count*sizeof(int32));
+
+ left=blend-((uint64)count<<32);
+ offs=(uint32)(left/blfactor);
+ blorigin=left-(uint64)offs*blfactor;
+ return offs;
+}
+
+void BLSynthReset(void)
+{
+ blacc=0;
+ blorigin=blend=0;
+ memset(blbuf,0,sizeof(blbuf));
+}
+
+void MakeBLSynth(uint32 tsinc)
+{
+ static int made=0;
+
+ blfactor=((uint64)1<<44)/tsinc;
+ BLSynthReset();
+
+ if(made) return;
+ made=1;
+
+ /* Impulse centered BL_TAPS/2 samples after the step, cut off a little
+    below Nyquist and shaped by a Blackman window.  Every phase is
+    normalized to sum to exactly 1<<BL_UNIT_BITS so the integrator never
+    drifts. */
+ for(int p=0;p<=BL_PHASES;p++)
+ {
+  double h[BL_TAPS];
+  double sum=0;
+  int32 isum=0;
+  int peak=0;
+
+  for(int k=0;k<BL_TAPS;k++)
+  {
+   double x=k-(BL_TAPS/2)-(double)p/BL_PHASES;
+   double fc=0.4;
+   double v=0;
+
+   if(fabs(x)<BL_TAPS/2)
+   {
+    double w=0.42+0.5*cos(M_PI*x/(BL_TAPS/2))+0.08*cos(2*M_PI*x/(BL_TAPS/2));
+    v=(x==0)?2*fc:sin(2*M_PI*fc*x)/(M_PI*x);
+    v*=w;
+   }
+   h[k]=v;
+   sum+=v;
+  }
+  for(int k=0;k<BL_TAPS;k++)
+  {
+   blkernel[p][k]=(int32)floor(h[k]*(1<<BL_UNIT_BITS)/sum+0.5);
+   isum+=blkernel[p][k];
+   if(blkernel[p][k]>blkernel[p][peak]) peak=k;
+  }
+  blkernel[p][peak]+=(1<<BL_UNIT_BITS)-isum;
+ }
+}
+
 /* Returns number of samples written to out. */
 /* leftover is set to the number of samples that need to be copied 
    from the end of in to the beginning of in.
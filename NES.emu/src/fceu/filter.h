@@ -4,3 +4,8 @@ int32 NeoFilterSound(FCEU_SoundSample2 *in, FCEU_SoundSample2 *out, uint32 inlen
 void MakeFilters(int32 rate);
 template<class InSample>
 void SexyFilter(InSample *in, FCEU_SoundSample *out, int32 count);
+void MakeBLSynth(uint32 tsinc);
+void BLSynthReset(void);
+void BLSynthDelta(uint32 ts, int32 delta);
+int32 BLSynthEndFrame(uint32 ts);
+uint32 BLSynthRead(FCEU_SoundSample *out, int32 count);
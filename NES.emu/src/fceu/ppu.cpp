@@ -36,6 +36,7 @@
 #include  "input.h"
 #include "driver.h"
 #include  "debug.h"
+#include  "expandline.h"
 
 #include        <cstring>
 #include        <cstdio>
@@ -395,6 +396,134 @@ int FCEUPPU_GetAttr(int ntnum, int xt, int yt) {
 		return (vnapage[ntnum][attraddr] & (3 << temp)) >> temp;
 }
 
+//Decoded CHR cache.  Each 16 byte tile of a CHR chip is kept as 8 rows of
+//ppulut1[plane 0] | ppulut2[plane 1], so a background fetch is a single load.
+//The rows are found through the page pointers (re-resolved whenever a bank
+//switch or a mapper changes one) and CHR RAM writes through the PPU update them.
+#define CHRDEC_ROW(V) ((((V) >> 1) & ~7) | ((V) & 7))
+
+typedef struct {
+	uint8 *src[8];		//page pointer dec[] was resolved from
+	uint32 *dec[8];		//decoded rows indexed with CHRDEC_ROW(), NULL if not in a CHR chip
+} CHRDECPAGES;
+
+static uint32 *chrdec[32];
+static uint32 chrdecsize[32];
+static uint8 chrdecvalid[32];
+static CHRDECPAGES chrdecV, chrdecMMC5BG, chrdecMMC5SPR;
+static uint8 *chrdecMMC5VROMSrc;
+static uint32 *chrdecMMC5VROM;
+static uint32 chrdecMMC5VROMSize;
+
+static INLINE uint32 CHRDecodeRow(const uint8 *C) {
+	return ppulut1[C[0]] | ppulut2[C[8]];
+}
+
+//Finds the CHR chip holding p and returns its decoded rows from p on,
+//decoding the chip first if it isn't current.  avail is the byte count left.
+static uint32 *CHRDecResolve(uint8 *p, uint32 *avail) {
+	int r;
+
+	*avail = 0;
+	for (r = 0; r < 32; r++) {
+		uint32 ofs, size, x, y;
+
+		if (!CHRptr[r] || p < CHRptr[r] || p >= CHRptr[r] + CHRsize[r])
+			continue;
+		ofs = p - CHRptr[r];
+		size = CHRsize[r] & ~0xF;
+		if ((ofs & 0xF) || ofs >= size)
+			return NULL;
+		if (!chrdecvalid[r]) {
+			if (chrdecsize[r] < size * 2) {
+				FCEU_free(chrdec[r]);
+				chrdec[r] = (uint32*)FCEU_malloc(size * 2);
+				chrdecsize[r] = chrdec[r] ? size * 2 : 0;
+				if (!chrdec[r])
+					return NULL;
+			}
+			for (x = 0; x < size; x += 16)
+				for (y = 0; y < 8; y++)
+					chrdec[r][(x >> 1) | y] = CHRDecodeRow(CHRptr[r] + x + y);
+			chrdecvalid[r] = 1;
+		}
+		*avail = size - ofs;
+		return chrdec[r] + (ofs >> 1);
+	}
+	return NULL;
+}
+
+static INLINE uint32 *CHRDecPageRows(CHRDECPAGES *c, uint8 **pages, uint32 x) {
+	if (c->src[x] != pages[x]) {
+		uint32 avail;
+		uint32 *dec = CHRDecResolve(pages[x] + (x << 10), &avail);
+		c->src[x] = pages[x];
+		c->dec[x] = (dec && avail >= 0x400) ? dec - (x << 9) : NULL;
+	}
+	return c->dec[x];
+}
+
+static INLINE uint32 CHRDecFetch(CHRDECPAGES *c, uint8 **pages, uint32 V) {
+	uint32 *dec = CHRDecPageRows(c, pages, V >> 10);
+	if (dec)
+		return dec[CHRDEC_ROW(V)];
+	return CHRDecodeRow(&pages[V >> 10][V]);
+}
+
+#define VRAMDEC(V)          CHRDecFetch(&chrdecV, VPage, (V))
+
+static INLINE uint32 MMC5BGVRAMDEC(uint32 V) {
+	if (!Sprite16) {
+		extern uint8 mmc5ABMode;				/* A=0, B=1 */
+		if (mmc5ABMode == 0)
+			return CHRDecFetch(&chrdecMMC5SPR, MMC5SPRVPage, V);
+		else
+			return CHRDecFetch(&chrdecMMC5BG, MMC5BGVPage, V);
+	} else return CHRDecFetch(&chrdecMMC5BG, MMC5BGVPage, V);
+}
+
+//V is an offset from MMC5HackVROMPTR
+static INLINE uint32 MMC5VROMDEC(uint32 V) {
+	if (chrdecMMC5VROMSrc != MMC5HackVROMPTR) {
+		chrdecMMC5VROMSrc = MMC5HackVROMPTR;
+		chrdecMMC5VROM = CHRDecResolve(MMC5HackVROMPTR, &chrdecMMC5VROMSize);
+	}
+	if (chrdecMMC5VROM && V < chrdecMMC5VROMSize)
+		return chrdecMMC5VROM[CHRDEC_ROW(V)];
+	return CHRDecodeRow(MMC5HackVROMPTR + V);
+}
+
+//Call after writing CHR RAM at PPU address A through VPage.
+void FCEUPPU_CHRWritten(uint32 A) {
+	uint32 *dec = CHRDecPageRows(&chrdecV, VPage, A >> 10);
+	if (dec) {
+		A &= ~8;
+		dec[CHRDEC_ROW(A)] = CHRDecodeRow(&VPage[A >> 10][A]);
+	}
+}
+
+//Call when CHR chips are set up or their contents change outside of the PPU
+//(power, reset, state loads).  Chips are decoded again when next displayed.
+void FCEUPPU_FlushCHRCache(int ramonly) {
+	int r;
+
+	for (r = 0; r < 32; r++) {
+		if (ramonly && !CHRram[r])
+			continue;
+		chrdecvalid[r] = 0;
+		if (!ramonly) {
+			FCEU_free(chrdec[r]);
+			chrdec[r] = NULL;
+			chrdecsize[r] = 0;
+		}
+	}
+	memset(&chrdecV, 0, sizeof(chrdecV));
+	memset(&chrdecMMC5BG, 0, sizeof(chrdecMMC5BG));
+	memset(&chrdecMMC5SPR, 0, sizeof(chrdecMMC5SPR));
+	chrdecMMC5VROMSrc = NULL;
+	chrdecMMC5VROM = NULL;
+}
+
 //new ppu-----
 inline void FFCEUX_PPUWrite_Default(uint32 A, uint8 V) {
 	uint32 tmp = A;
@@ -402,8 +531,10 @@ inline void FFCEUX_PPUWrite_Default(uint32 A, uint8 V) {
 	if (PPU_hook) PPU_hook(A);
 
 	if (tmp < 0x2000) {
-		if (PPUCHRRAM & (1 << (tmp >> 10)))
+		if (PPUCHRRAM & (1 << (tmp >> 10))) {
 			VPage[tmp >> 10][tmp] = V;
+			FCEUPPU_CHRWritten(tmp);
+		}
 	} else if (tmp < 0x3F00) {
 		if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
 			vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
@@ -889,8 +1020,10 @@ static DECLFW(B2007) {
 	} else {
 		PPUGenLatch = V;
 		if (tmp < 0x2000) {
-			if (PPUCHRRAM & (1 << (tmp >> 10)))
+			if (PPUCHRRAM & (1 << (tmp >> 10))) {
 				VPage[tmp >> 10][tmp] = V;
+				FCEUPPU_CHRWritten(tmp);
+			}
 		} else if (tmp < 0x3F00) {
 			if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
 				vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
@@ -1002,7 +1135,7 @@ static int spork = 0;
 						
 // lasttile is really "second to last tile."
 static void RefreshLine(int lastpixel) {
-	static uint32 pshift[2];
+	static uint32 pshift[2];	//decoded rows of the tile being drawn and the next one
 	static uint32 atlatch;
 	uint32 smorkus = RefreshAddr;
 
@@ -1221,7 +1354,6 @@ static uint8 lineBuffer[272] __attribute__ ((aligned (4)));
 
 void MMC5_hb(int);     //Ugh ugh ugh.
 static void DoLine(void) {
-	int x;
 	uint8 *target = lineBuffer;//XBuf+(scanline<<8);
 
 	if (MMC5Hack && (ScreenON || SpriteON)) MMC5_hb(scanline);
@@ -1245,36 +1377,15 @@ static void DoLine(void) {
 		if (SpriteON)
 			CopySprites(target);
 
+		uint8 mask = 0x3f;
 		if (ScreenON || SpriteON) {	// Yes, very el-cheapo.
-			if (PPU[1] & 0x01) {
-				for (x = 63; x >= 0; x--)
-					*(uint32*)&target[x << 2] = (*(uint32*)&target[x << 2]) & 0x30303030;
-			}
+			if (PPU[1] & 0x01)
+				mask = 0x30;
 		}
 		uint y =  scanline - 8;
 		assert(y*nesPixX < nesPixX*nesVisiblePixY);
 		NATIVE_PIX_TYPE *outLine = &nativePixBuff[(y*nesPixX)];
-		if((PPU[1] >> 5) == 0x7)
-		{
-			//for(x=63;x>=0;x--)
-			for(x=0;x<=255;x++)
-			{
-				//*(uint32 *)&target[x<<2]=((*(uint32*)&target[x<<2])&0x3f3f3f3f)|0xc0c0c0c0;
-				outLine[x] = nativeCol[(target[x]&0x3f)|0xc0];
-			}
-		}
-		else if(PPU[1] & 0xE0)
-			for(x=0;x<=255;x++)
-			{
-				//*(uint32 *)&target[x<<2]=(*(uint32*)&target[x<<2])|0x40404040;
-				outLine[x] = nativeCol[(target[x])|0x40];
-			}
-		else
-			for(x=0;x<=255;x++)
-			{
-				//*(uint32 *)&target[x<<2]=((*(uint32*)&target[x<<2])&0x3f3f3f3f)|0x80808080;
-				outLine[x] = nativeCol[(target[x]&0x3f)|0x80];
-			}
+		ExpandLine(outLine, target, mask, &nativeCol[ExpandLineBank(PPU[1])]);
 	}
 
 	sphitx = 0x100;
@@ -1717,6 +1828,7 @@ void FCEUPPU_Power(void) {
 		BWrite[x + 7] = B2007;
 	}
 	BWrite[0x4014] = B4014;
+	FCEU_UpdateCPUPageKinds(0x2000, 0x4014);
 }
 
 int FCEUPPU_Loop(int skip, bool commit) {
@@ -1846,6 +1958,7 @@ static uint16 TempAddrT, RefreshAddrT;
 void FCEUPPU_LoadState(int version) {
 	TempAddr = TempAddrT;
 	RefreshAddr = RefreshAddrT;
+	FCEUPPU_FlushCHRCache(1);
 }
 
 SFORMAT FCEUPPU_STATEINFO[] = {
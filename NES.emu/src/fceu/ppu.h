@@ -19,6 +19,8 @@ extern uint8 PPUCHRRAM;
 void FCEUPPU_SaveState(void);
 void FCEUPPU_LoadState(int version);
 uint8* FCEUPPU_GetCHR(uint32 vadr, uint32 refreshaddr);
+void FCEUPPU_CHRWritten(uint32 A);
+void FCEUPPU_FlushCHRCache(int ramonly);
 void ppu_getScroll(int &xpos, int &ypos);
 
 
@@ -80,6 +80,11 @@ uint32 soundtsi=0;
 static int32 sqacc[2];
 /* LQ variables segment ends. */
 
+/* Mixed square and triangle/noise/PCM levels last sent to the band-limited
+   synthesizer. */
+static int32 sqblout=0;
+static int32 tnpblout=0;
+
 /*static*/ int32 lengthcount[4];
 static const uint8 lengthtable[0x20]=
 {
@@ -945,6 +950,197 @@ static void RDoTriangleNoisePCMLQ(void)
 }
 
 
+/* Band-limited versions of the low quality renderers.  ChannelBC[0] and
+   ChannelBC[2] count CPU cycles like the high quality code, but instead of
+   touching every cycle they step from one timer expiry to the next and
+   only report the mixed level when it changes.
+*/
+static void RDoSQBL(void)
+{
+   int32 start,end,t;
+   int32 ampx;
+   int32 cf[2];
+   int32 inie[2];
+   int32 ttable[2][8];
+   int32 totalout;
+   int x;
+
+   start=ChannelBC[0];
+   end=SOUNDTS;
+   if(end<=start) return;
+   ChannelBC[0]=end;
+
+   for(x=0;x<2;x++)
+   {
+    int32 amp;
+    int32 rthresh;
+    int y;
+
+    inie[x]=1;
+    if(curfreq[x]<8 || curfreq[x]>0x7ff)
+     inie[x]=0;
+    if(!CheckFreq(curfreq[x],PSG[(x<<2)|0x1]))
+     inie[x]=0;
+    if(!lengthcount[x])
+     inie[x]=0;
+
+    if(EnvUnits[x].Mode&0x1)
+     amp=EnvUnits[x].Speed;
+    else
+     amp=EnvUnits[x].decvolume;
+
+    ampx = x ? FSettings.Square2Volume : FSettings.Square1Volume;
+    if (ampx != 256) amp = (amp * ampx) / 256;
+
+    if(!inie[x]) amp=0;
+
+    rthresh=RectDuties[(PSG[x<<2]&0xC0)>>6];
+
+    for(y=0;y<8;y++)
+     ttable[x][y] = (y < rthresh) ? amp : 0;
+    cf[x]=(curfreq[x]+1)*2;
+   }
+
+   totalout = wlookup1[ ttable[0][RectDutyCount[0]] + ttable[1][RectDutyCount[1]] ];
+   if(totalout!=sqblout)
+   {
+    BLSynthDelta(start,totalout-sqblout);
+    sqblout=totalout;
+   }
+
+   t=start;
+   while(inie[0] || inie[1])
+   {
+    int32 step=end-t;
+
+    if(inie[0] && wlcount[0]<step) step=wlcount[0];
+    if(inie[1] && wlcount[1]<step) step=wlcount[1];
+    t+=step;
+
+    for(x=0;x<2;x++)
+    {
+     if(!inie[x]) continue;
+     wlcount[x]-=step;
+     if(!wlcount[x])
+     {
+      wlcount[x]=cf[x];
+      RectDutyCount[x]=(RectDutyCount[x]+1)&7;
+     }
+    }
+
+    totalout = wlookup1[ ttable[0][RectDutyCount[0]] + ttable[1][RectDutyCount[1]] ];
+    if(totalout!=sqblout)
+    {
+     BLSynthDelta(t,totalout-sqblout);
+     sqblout=totalout;
+    }
+    if(t>=end) break;
+   }
+}
+
+static INLINE uint32 TriangleBLOut(void)
+{
+ uint32 tcout=(tristep&0xF);
+ if(!(tristep&0x10)) tcout^=0xF;
+ return (tcout*3*FSettings.TriangleVolume)/256;
+}
+
+static void RDoTriangleNoisePCMBL(void)
+{
+   uint8 PAL = ::PAL;
+   int32 start,end,t;
+   int32 trifreq,noisefreq;
+   int32 inie[2];
+   uint32 amptab[2];
+   uint32 tcout,noiseout,pcmout;
+   int nshift;
+   int32 totalout;
+
+   start=ChannelBC[2];
+   end=SOUNDTS;
+   if(end<=start) return;
+   ChannelBC[2]=end;
+
+   trifreq=(PSG[0xa]|((PSG[0xb]&7)<<8))+1;
+   inie[0]=1;
+   if(!lengthcount[2] || !TriCount || trifreq<=4)
+    inie[0]=0;
+
+   if(EnvUnits[2].Mode&0x1)
+    amptab[0]=EnvUnits[2].Speed;
+   else
+    amptab[0]=EnvUnits[2].decvolume;
+   if (FSettings.NoiseVolume != 256) amptab[0] = (amptab[0] * FSettings.NoiseVolume) / 256;
+   amptab[0]<<=1;
+   amptab[1]=0;
+
+   /* Same speedup as the low quality code, don't clock silent noise. */
+   inie[1]=1;
+   if(!lengthcount[3] || !amptab[0])
+    amptab[0]=inie[1]=0;
+
+   if(PAL)
+    noisefreq=NoiseFreqTablePAL[PSG[0xE]&0xF];
+   else
+    noisefreq=NoiseFreqTableNTSC[PSG[0xE]&0xF];
+
+   if(PSG[0xE]&0x80)
+    nshift=8;
+   else
+    nshift=13;
+
+   tcout=TriangleBLOut();
+   noiseout=amptab[(nreg>>0xe)&1];
+   pcmout=(RawDALatch*FSettings.PCMVolume)/256;
+
+   totalout = wlookup2[tcout+noiseout+pcmout];
+   if(totalout!=tnpblout)
+   {
+    BLSynthDelta(start,totalout-tnpblout);
+    tnpblout=totalout;
+   }
+
+   t=start;
+   while(inie[0] || inie[1])
+   {
+    int32 step=end-t;
+
+    if(inie[0] && wlcount[2]<step) step=wlcount[2];
+    if(inie[1] && wlcount[3]<step) step=wlcount[3];
+    t+=step;
+
+    if(inie[0])
+    {
+     wlcount[2]-=step;
+     if(!wlcount[2])
+     {
+      wlcount[2]=trifreq;
+      tristep=(tristep+1)&0x1F;
+      tcout=TriangleBLOut();
+     }
+    }
+    if(inie[1])
+    {
+     wlcount[3]-=step;
+     if(!wlcount[3])
+     {
+      wlcount[3]=noisefreq;
+      nreg=(nreg<<1)+(((nreg>>nshift)^(nreg>>14))&1);
+      nreg&=0x7fff;
+      noiseout=amptab[(nreg>>0xe)&1];
+     }
+    }
+
+    totalout = wlookup2[tcout+noiseout+pcmout];
+    if(totalout!=tnpblout)
+    {
+     BLSynthDelta(t,totalout-tnpblout);
+     tnpblout=totalout;
+    }
+    if(t>=end) break;
+   }
+}
+
 static void RDoNoise(void)
 {
  uint8 PAL = ::PAL;
@@ -1040,6 +1236,7 @@ int FlushEmulateSound(FCEU_SoundSample *WaveFinal)
 	assert(WaveFinal);
   int x;
   int32 end,left;
+  uint32 bloffs=0;
 
   if(!timestamp) return(0);
 
@@ -1082,9 +1279,14 @@ int FlushEmulateSound(FCEU_SoundSample *WaveFinal)
   }
   else
   {
-   end=(SOUNDTS<<16)/soundtsinc;
+   if(FSettings.bandlimit)
+    end=BLSynthEndFrame(SOUNDTS);
+   else
+    end=(SOUNDTS<<16)/soundtsinc;
    if(GameExpSound.Fill)
     GameExpSound.Fill(end&0xF);
+   if(FSettings.bandlimit)
+    bloffs=BLSynthRead(Wave,end>>4);
 
    SexyFilter(Wave,WaveFinal,end>>4);
 
@@ -1105,6 +1307,11 @@ int FlushEmulateSound(FCEU_SoundSample *WaveFinal)
    for(x=0;x<5;x++)
     ChannelBC[x]=end&0xF;
    soundtsoffs = (soundtsinc*(end&0xF))>>16;
+   if(FSettings.bandlimit)
+   {
+    soundtsoffs=bloffs;
+    ChannelBC[0]=ChannelBC[2]=bloffs;
+   }
    end>>=4;
   }
   //inbuf=end;
@@ -1214,6 +1421,8 @@ void FCEUSND_Power(void)
         for(x=0;x<5;x++)
          ChannelBC[x]=0;
         soundtsoffs=0;
+        sqblout=tnpblout=0;
+        BLSynthReset();
         LoadDMCPeriod(DMCFormat&0xF);
 }
 
@@ -1231,13 +1440,13 @@ void SetSoundVariables(void)
    for(x=1;x<32;x++)
    {
     wlookup1[x]=(SysDDec)16*16*16*4*95.52/((SysDDec)8128/(SysDDec)x+100);
-    if(!FSettings.soundq) wlookup1[x]>>=4;
+    if(!FSettings.soundq && !FSettings.bandlimit) wlookup1[x]>>=4;
    }
    wlookup2[0]=0;
    for(x=1;x<203;x++)
    {
     wlookup2[x]=(SysDDec)16*16*16*4*163.67/((SysDDec)24329/(SysDDec)x+100);
-    if(!FSettings.soundq) wlookup2[x]>>=4;
+    if(!FSettings.soundq && !FSettings.bandlimit) wlookup2[x]>>=4;
    }
    if(FSettings.soundq>=1)
    {
@@ -1247,6 +1456,11 @@ void SetSoundVariables(void)
     DoSQ1=RDoSQ1;
     DoSQ2=RDoSQ2;
    }
+   else if(FSettings.bandlimit)
+   {
+    DoSQ1=DoSQ2=RDoSQBL;
+    DoTriangle=DoNoise=DoPCM=RDoTriangleNoisePCMBL;
+   }
    else
    {
     DoNoise=DoTriangle=DoPCM=DoSQ1=DoSQ2=Dummyfunc;
@@ -1275,6 +1489,9 @@ void SetSoundVariables(void)
   LoadDMCPeriod(DMCFormat&0xF);  // For changing from PAL to NTSC
 
   soundtsinc=(uint32)((uint64)(PAL?(SysLDDec)PAL_CPU*65536:(SysLDDec)NTSC_CPU*65536)/(FSettings.SndRate * 16));
+
+  sqblout=tnpblout=0;
+  MakeBLSynth(soundtsinc);
 }
 
 void FCEUI_Sound(int Rate)
@@ -1296,6 +1513,12 @@ void FCEUI_SetSoundQuality(int quality)
 #endif
 }
 
+void FCEUI_SetBandLimitedSound(int on)
+{
+	FSettings.bandlimit=on;
+	SetSoundVariables();
+}
+
 void FCEUI_SetSoundVolume(uint32 volume)
 {
 	FSettings.SoundVolume=volume;
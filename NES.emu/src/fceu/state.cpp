@@ -359,16 +359,10 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 int CurrentState=0;
 extern int geniestage;
 
-
-bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
+//the chunks every state has, in both file and memory states
+static uint32 WriteCoreStateChunks(EMUFILE* os)
 {
-	//a temp memory stream. we'll dump some data here and then compress
-	//TODO - support dumping directly without compressing to save a buffer copy
-
-	EMUFILE_MEMORY ms;
-	EMUFILE* os = &ms;
-
-	uint32 totalsize = 0;
+	uint32 totalsize;
 
 	FCEUPPU_SaveState();
 	FCEUSND_SaveState();
@@ -378,6 +372,44 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
 	totalsize+=WriteStateChunk(os,31,FCEU_NEWPPU_STATEINFO);
 	totalsize+=WriteStateChunk(os,4,FCEUCTRL_STATEINFO);
 	totalsize+=WriteStateChunk(os,5,FCEUSND_STATEINFO);
+	return totalsize;
+}
+
+//reads the chunks after the header and lets the subsystems fix up their state
+static bool ReadStateBody(EMUFILE* is, int totalsize, int stateversion)
+{
+	FCEUMOV_PreLoad();
+
+	bool x = ReadStateChunks(is,totalsize)!=0;
+
+	//mbg 5/24/08 - we don't support old states, so this shouldnt matter.
+	//if(read_sfcpuc && stateversion<9500)
+	//	X.IRQlow=0;
+
+	if(GameStateRestore)
+	{
+		GameStateRestore(stateversion);
+	}
+	if (x)
+	{
+		FCEUPPU_LoadState(stateversion);
+		FCEUSND_LoadState(stateversion);
+		x=FCEUMOV_PostLoad();
+	}
+	return x;
+}
+
+
+bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
+{
+	//a temp memory stream. we'll dump some data here and then compress
+	//TODO - support dumping directly without compressing to save a buffer copy
+
+	EMUFILE_MEMORY ms;
+	EMUFILE* os = &ms;
+
+	uint32 totalsize = WriteCoreStateChunks(os);
+
 	if(FCEUMOV_Mode(MOVIEMODE_PLAY|MOVIEMODE_RECORD|MOVIEMODE_FINISHED))
 	{
 		totalsize+=WriteStateChunk(os,6,FCEUMOV_STATEINFO);
@@ -673,25 +705,9 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 		is->fread((char*)&buf[0],totalsize);
 	}
 
-	FCEUMOV_PreLoad();
-
 	EMUFILE_MEMORY mstemp(&buf);
-	bool x = ReadStateChunks(&mstemp,totalsize)!=0;
-
-	//mbg 5/24/08 - we don't support old states, so this shouldnt matter.
-	//if(read_sfcpuc && stateversion<9500)
-	//	X.IRQlow=0;
-
-	if(GameStateRestore)
-	{
-		GameStateRestore(stateversion);
-	}
-	if (x)
-	{
-		FCEUPPU_LoadState(stateversion);
-		FCEUSND_LoadState(stateversion);
-		x=FCEUMOV_PostLoad();
-	} else if (backup)
+	bool x = ReadStateBody(&mstemp,totalsize,stateversion);
+	if (!x && backup)
 	{
 		msBackupSavestate.fseek(0,SEEK_SET);
 		FCEUSS_LoadFP(&msBackupSavestate,SSLOADPARAM_NOBACKUP);
@@ -700,6 +716,44 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	return x;
 }
 
+bool FCEUSS_SaveMem(std::vector<uint8> &buf)
+{
+	//write straight into buf, it keeps its capacity from the last save so
+	//this doesn't allocate once the state size is known
+	EMUFILE_MEMORY ms(&buf);
+	EMUFILE* os = &ms;
+
+	os->fseek(16,SEEK_SET);
+	uint32 totalsize = WriteCoreStateChunks(os);
+	if(SPreSave) SPreSave();
+	totalsize+=WriteStateChunk(os,0x10,SFMDATA);
+	if(SPostSave) SPostSave();
+	ms.truncate(16+totalsize);
+
+	//same header as an uncompressed file state, so buf can also be written out as one
+	memcpy(&buf[0],"FCSX",4);
+	FCEU_en32lsb(&buf[4], totalsize);
+	FCEU_en32lsb(&buf[8], FCEU_VERSION_NUMERIC);
+	FCEU_en32lsb(&buf[12], (uint32)-1);
+	return true;
+}
+
+bool FCEUSS_LoadMem(std::vector<uint8> &buf)
+{
+	if(buf.size() < 16 || memcmp(&buf[0],"FCSX",4) || FCEU_de32lsb(&buf[12]) != (uint32)-1)
+		return false;
+
+	int totalsize = FCEU_de32lsb(&buf[4]);
+	int stateversion = FCEU_de32lsb(&buf[8]);
+	if(totalsize > (int)buf.size() - 16)
+		return false;
+
+	//read in place, nothing is copied or decompressed
+	EMUFILE_MEMORY ms(&buf);
+	ms.fseek(16,SEEK_SET);
+	return ReadStateBody(&ms,totalsize,stateversion);
+}
+
 
 bool FCEUSS_Load(const char *fname, bool display_message)
 {
@@ -911,6 +965,20 @@ int FCEUI_SaveState(const char *fname, bool display_message)
 	return FCEUSS_Save(fname, display_message);
 }
 
+bool FCEUI_SaveStateMem(std::vector<uint8> &buf)
+{
+	if(!FCEU_IsValidUI(FCEUI_SAVESTATE)) return false;
+
+	return FCEUSS_SaveMem(buf);
+}
+
+bool FCEUI_LoadStateMem(std::vector<uint8> &buf)
+{
+	if(!FCEU_IsValidUI(FCEUI_LOADSTATE)) return false;
+
+	return FCEUSS_LoadMem(buf);
+}
+
 int FCEUI_LoadState(const char *fname, bool display_message)
 {
 	if(!FCEU_IsValidUI(FCEUI_LOADSTATE)) return 0;
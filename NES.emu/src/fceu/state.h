@@ -33,6 +33,11 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel);
 
 bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params);
 
+//uncompressed states kept in memory for rewind and run-ahead, leaving out
+//the back buffer and movie chunks. buf is reused between saves.
+bool FCEUSS_SaveMem(std::vector<uint8> &buf);
+bool FCEUSS_LoadMem(std::vector<uint8> &buf);
+
 extern int CurrentState;
 void FCEUSS_CheckStates(void);
 
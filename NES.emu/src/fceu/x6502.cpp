@@ -21,6 +21,7 @@
 #include "types.h"
 #include "x6502.h"
 #include "fceu.h"
+#include "cart.h"
 #include "debug.h"
 #include "sound.h"
 #ifdef _S9XLUA_H
@@ -42,16 +43,23 @@ void (*MapIRQHook)(int a);
  timestamp+=__x;  \
 }
 
-//normal memory read
+//normal memory read, RAM and plain PRG pages skip the handler call
 static INLINE uint8 RdMem(unsigned int A)
 {
+ uint8 *p=CPUReadPage[A>>11];
+ if(p)
+  return(_DB=p[A]);
  return(_DB=ARead[A](A));
 }
 
 //normal memory write
 static INLINE void WrMem(unsigned int A, uint8 V)
 {
-	BWrite[A](A,V);
+	uint8 *p=CPUWritePage[A>>11];
+	if(p)
+		p[A]=V;
+	else
+		BWrite[A](A,V);
 	#ifdef _S9XLUA_H
 	CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
 	#endif
@@ -60,6 +68,10 @@ static INLINE void WrMem(unsigned int A, uint8 V)
 static INLINE uint8 RdRAM(unsigned int A) 
 {
   //bbit edited: this was changed so cheat substituion would work
+  //page 0 only has a direct pointer while no cheat handler is installed in it
+  uint8 *p=CPUReadPage[A>>11];
+  if(p)
+   return(_DB=p[A]);
   return(_DB=ARead[A](A));
   // return(_DB=RAM[A]); 
 }
@@ -75,13 +87,17 @@ static INLINE void WrRAM(unsigned int A, uint8 V)
 uint8 X6502_DMR(uint32 A)
 {
  ADDCYC(1);
- return(X.DB=ARead[A](A));
+ return(RdMem(A));
 }
 
 void X6502_DMW(uint32 A, uint8 V)
 {
  ADDCYC(1);
- BWrite[A](A,V);
+ uint8 *p=CPUWritePage[A>>11];
+ if(p)
+  p[A]=V;
+ else
+  BWrite[A](A,V);
  #ifdef _S9XLUA_H
  CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
  #endif
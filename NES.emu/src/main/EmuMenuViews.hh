@@ -122,9 +122,26 @@ public:
 		videoSystem.init(str, std::min((int)optionVideoSystem, (int)sizeofArray(str)-1), sizeofArray(str));
 	}
 
+	BoolMenuItem bandLimitedSound
+	{
+		"Band-limited Synthesis",
+		[this](BoolMenuItem &item, View &, const Input::Event &e)
+		{
+			item.toggle(*this);
+			optionBandLimitedSound = item.on;
+			FCEUI_SetBandLimitedSound(item.on);
+		}
+	};
+
 public:
 	SystemOptionView(Base::Window &win): OptionView(win) {}
 
+	void loadAudioItems(MenuItem *item[], uint &items)
+	{
+		OptionView::loadAudioItems(item, items);
+		bandLimitedSound.init(optionBandLimitedSound); item[items++] = &bandLimitedSound;
+	}
+
 	void loadVideoItems(MenuItem *item[], uint &items)
 	{
 		OptionView::loadVideoItems(item, items);
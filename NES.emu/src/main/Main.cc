@@ -85,13 +85,14 @@ static ESI nesInputPortDev[2]{SI_UNSET, SI_UNSET};
 
 enum {
 	CFGKEY_FDS_BIOS_PATH = 270, CFGKEY_FOUR_SCORE = 271,
-	CFGKEY_VIDEO_SYSTEM = 272,
+	CFGKEY_VIDEO_SYSTEM = 272, CFGKEY_BAND_LIMITED_SOUND = 273,
 };
 
 FsSys::PathString fdsBiosPath{};
 static PathOption optionFdsBiosPath(CFGKEY_FDS_BIOS_PATH, fdsBiosPath, "");
 static Byte1Option optionFourScore(CFGKEY_FOUR_SCORE, 0);
 static Byte1Option optionVideoSystem(CFGKEY_VIDEO_SYSTEM, 0);
+static Byte1Option optionBandLimitedSound(CFGKEY_BAND_LIMITED_SOUND, 1);
 static uint autoDetectedVidSysPAL = 0;
 
 const char *EmuSystem::inputFaceBtnName = "A/B";
@@ -149,7 +150,10 @@ static void setDirOverrides()
 
 void EmuSystem::initOptions() {}
 
-void EmuSystem::onOptionsLoaded() {}
+void EmuSystem::onOptionsLoaded()
+{
+	FCEUI_SetBandLimitedSound(optionBandLimitedSound);
+}
 
 bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 {
@@ -159,6 +163,7 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 		bcase CFGKEY_FOUR_SCORE: optionFourScore.readFromIO(io, readSize);
 		bcase CFGKEY_FDS_BIOS_PATH: optionFdsBiosPath.readFromIO(io, readSize);
 		bcase CFGKEY_VIDEO_SYSTEM: optionVideoSystem.readFromIO(io, readSize);
+		bcase CFGKEY_BAND_LIMITED_SOUND: optionBandLimitedSound.readFromIO(io, readSize);
 		logMsg("fds bios path %s", fdsBiosPath.data());
 	}
 	return 1;
@@ -168,6 +173,7 @@ void EmuSystem::writeConfig(IO &io)
 {
 	optionFourScore.writeWithKeyIfNotDefault(io);
 	optionVideoSystem.writeWithKeyIfNotDefault(io);
+	optionBandLimitedSound.writeWithKeyIfNotDefault(io);
 	optionFdsBiosPath.writeToIO(io);
 }
 
@@ -0,0 +1,5 @@
+#pragma once
+
+// imagine config for the headless host build of the fceu core
+#define CONFIG_FS
+#define CONFIG_FS_POSIX
@@ -0,0 +1,58 @@
+/*  This file is part of NES.emu.
+
+	NES.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	NES.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with NES.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// What the fceu core needs from the app and imagine to run headless
+
+#include <imagine/fs/sys.hh>
+#include <imagine/io/api/stdio.hh>
+#include <fceu/driver.h>
+#include "unzip.h"
+#include <cstdlib>
+#include <cstdarg>
+#include <sys/stat.h>
+
+FsSys::PathString fdsBiosPath{};
+const char *fceuReturnedError = 0;
+
+void FCEUD_SetPalette(uint8, uint8, uint8, uint8) {}
+void FCEUD_GetPalette(uint8, uint8 *, uint8 *, uint8 *) {}
+void FCEUD_emulateSound() {}
+void FCEUD_commitVideo() {}
+void FCEUD_UpdatePPUView(int, int) {}
+void FCEUD_UpdateNTView(int, bool) {}
+void FCEUD_TraceInstruction(uint8 *, int) {}
+
+extern "C" void logger_printf(int, const char *, ...) {}
+extern "C" void logger_vprintf(int, const char *, va_list) {}
+
+int FsPosix::fileType(const char *path)
+{
+	struct stat s;
+	return stat(path, &s) ? TYPE_NONE : TYPE_FILE;
+}
+
+// only used for archives and the FDS BIOS, neither of which the tests load
+int fgetc(IO &stream) { abort(); }
+int fseek(IO &stream, long int offset, int origin) { abort(); }
+long int ftell(IO &stream) { abort(); }
+
+unzFile unzOpen(const char *) { return 0; }
+int unzClose(unzFile) { return 0; }
+int unzGoToFirstFile(unzFile) { return -1; }
+int unzGoToNextFile(unzFile) { return -1; }
+int unzGetCurrentFileInfo(unzFile, unz_file_info *, char *, unsigned long, void *, unsigned long, char *, unsigned long) { return -1; }
+int unzOpenCurrentFile(unzFile) { return -1; }
+int unzReadCurrentFile(unzFile, void *, unsigned) { return -1; }
+int unzCloseCurrentFile(unzFile) { return 0; }
@@ -0,0 +1,190 @@
+/*  This file is part of NES.emu.
+
+	NES.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	NES.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with NES.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Runs randomly generated PRG code on a given mapper and prints a hash of
+// the picture, RAM, PRG-space reads, CPU registers and cycle count taken
+// after every frame, plus the time spent in FCEUI_Emulate() per frame.
+// The code is biased towards loads, stores and jumps so it keeps hitting
+// RAM, PRG ROM/RAM and the mapper registers. Linked against two builds of
+// the core, equal hashes mean the CPU saw the same memory in both.
+// Seed 0 runs a fixed copy loop instead, for timing.
+// Usage: randomPrgRun <rom path> <mapper> <seed> [frames] [CHR banks]
+
+#include <fceu/driver.h>
+#include <fceu/fceu.h>
+#include <fceu/x6502.h>
+#include <fceu/ppu.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <chrono>
+
+extern uint8 RAM[0x800];
+
+static uint32 rnd = 1;
+static uint32 next() { rnd = rnd * 1103515245 + 12345; return rnd >> 8; }
+
+static bool writeRom(const char *path, int mapper, uint32 seed, int chrBanks)
+{
+	const int prgBanks = 8;
+	std::vector<uint8> rom(16 + prgBanks * 16384 + chrBanks * 8192);
+	memcpy(rom.data(), "NES\x1a", 4);
+	rom[4] = prgBanks;
+	rom[5] = chrBanks;
+	rom[6] = ((mapper & 0xF) << 4) | 2; // battery backed WRAM at 0x6000
+	rom[7] = mapper & 0xF0;
+	static const uint8 memOps[] {0xA5, 0xAD, 0x85, 0x8D, 0xB1, 0x91, 0xBD, 0x9D, 0xE6, 0xEE,
+		0x4C, 0x20, 0x60, 0xD0, 0xF0, 0x48, 0x68, 0xA9, 0x6C, 0x40};
+	for(size_t i = 16; i < rom.size(); i++)
+		rom[i] = (next() & 3) ? next() : memOps[next() % sizeof(memOps)];
+	// vectors in every 16KB bank so whatever gets switched in can run
+	for(int b = 0; b < prgBanks; b++)
+	{
+		uint8 *v = &rom[16 + b * 16384 + 0x3FFA];
+		for(int i = 0; i < 3; i++)
+		{
+			uint16 a = 0x8000 | (next() & 0x7FFF);
+			v[i * 2] = a;
+			v[i * 2 + 1] = a >> 8;
+		}
+	}
+	if(!seed)
+	{
+		// random code soon hits a jam opcode and stops the CPU, so for timing
+		// run a copy loop between PRG ROM, RAM and WRAM at $FF00 of every bank
+		static const uint8 copyLoop[]
+		{
+			0x78, 0xD8, 0xA2, 0xFF, 0x9A, // SEI, CLD, LDX #$FF, TXS
+			0xA9, 0x00, 0x85, 0x10, 0xA9, 0x02, 0x85, 0x11, // $10 = $0200
+			0xA0, 0x00, // loop: LDY #0
+			0xB9, 0x00, 0x80, // LDA $8000,Y
+			0x99, 0x00, 0x02, // STA $0200,Y
+			0xB9, 0x00, 0x02, // LDA $0200,Y
+			0x99, 0x00, 0x60, // STA $6000,Y
+			0x71, 0x10, // ADC ($10),Y
+			0x79, 0x00, 0x60, // ADC $6000,Y
+			0x99, 0x00, 0x03, // STA $0300,Y
+			0xC8, 0xD0, 0xE9, // INY, BNE to LDA $8000,Y
+			0xB8, 0x50, 0xE4, // CLV, BVC loop
+			0x40, // RTI for NMI and IRQ
+		};
+		for(int b = 0; b < prgBanks; b++)
+		{
+			uint8 *bank = &rom[16 + b * 16384];
+			memcpy(bank + 0x3F00, copyLoop, sizeof(copyLoop));
+			const uint16 vectors[] {0xFF00 + sizeof(copyLoop) - 1, 0xFF00, 0xFF00 + sizeof(copyLoop) - 1};
+			for(int i = 0; i < 3; i++)
+			{
+				bank[0x3FFA + i * 2] = vectors[i];
+				bank[0x3FFA + i * 2 + 1] = vectors[i] >> 8;
+			}
+		}
+	}
+	FILE *f = fopen(path, "wb");
+	if(!f)
+		return false;
+	bool ok = fwrite(rom.data(), 1, rom.size(), f) == rom.size();
+	return !fclose(f) && ok;
+}
+
+static void writeReg(uint16 a, uint8 v) { BWrite[a](a, v); }
+
+int main(int argc, char **argv)
+{
+	if(argc < 4)
+	{
+		fprintf(stderr, "usage: %s <rom path> <mapper> <seed> [frames] [CHR banks]\n", argv[0]);
+		return 1;
+	}
+	int mapper = atoi(argv[2]);
+	uint32 seed = strtoul(argv[3], nullptr, 0);
+	int frames = argc > 4 ? atoi(argv[4]) : 300;
+	int chrBanks = argc > 5 ? atoi(argv[5]) : 8;
+	rnd = seed;
+	if(!writeRom(argv[1], mapper, seed, chrBanks))
+	{
+		fprintf(stderr, "can't write %s\n", argv[1]);
+		return 1;
+	}
+	FCEUI_Initialize();
+	for(int i = 0; i < 256; i++)
+		nativeCol[i] = i;
+	if(!FCEUI_LoadGame(argv[1], 1))
+	{
+		fprintf(stderr, "mapper %d: load failed\n", mapper);
+		return 1;
+	}
+
+	uint32 h = 2166136261u;
+	auto mix = [&](uint32 v){ h = (h ^ v) * 16777619u; };
+	std::chrono::steady_clock::duration emuTime{};
+	for(int fr = 0; fr < frames; fr++)
+	{
+		// random palette, pattern and name table data so rendering and
+		// the CHR mapping are exercised too
+		writeReg(0x2001, 0);
+		ARead[0x2002](0x2002);
+		writeReg(0x2006, 0x3F); writeReg(0x2006, 0x00);
+		for(int i = 0; i < 32; i++)
+			writeReg(0x2007, next());
+		uint16 a = next() & 0x1FF0;
+		writeReg(0x2006, a >> 8); writeReg(0x2006, a);
+		for(int i = 0; i < 64; i++)
+			writeReg(0x2007, next());
+		a = 0x2000 | (next() & 0xFF0);
+		writeReg(0x2006, a >> 8); writeReg(0x2006, a);
+		for(int i = 0; i < 64; i++)
+			writeReg(0x2007, next());
+		if(mapper == 5)
+		{
+			// MMC5 ExRAM, split screen and multiplier, rarely reached by random code
+			writeReg(0x5104, (fr >> 1) & 1);
+			writeReg(0x5200, (fr & 4) ? (next() | 0x80) : 0);
+			writeReg(0x5201, next());
+			writeReg(0x5202, next());
+			// the ExRAM tile path adds the upper CHR bits without masking them to
+			// the CHR size, so leave them clear to stay inside the 64KB of CHR ROM
+			writeReg(0x5130, 0);
+			writeReg(0x5101, next() & 3);
+			for(int i = 0; i < 12; i++)
+				writeReg(0x5120 + next() % 12, next());
+			for(int i = 0; i < 256; i++)
+				writeReg(0x5C00 + (next() & 0x3FF), next());
+		}
+		writeReg(0x2001, 0x1E | (next() & 0xE1));
+		if(fr & 1)
+			writeReg(0x2000, next() & 0xBB);
+		writeReg(0x2005, next()); writeReg(0x2005, next());
+
+		auto start = std::chrono::steady_clock::now();
+		FCEUI_Emulate(1, 0, 0);
+		emuTime += std::chrono::steady_clock::now() - start;
+
+		for(uint i = 0; i < nesPixX * nesVisiblePixY; i++)
+			mix(nativePixBuff[i]);
+		for(int i = 0; i < 0x800; i++)
+			mix(RAM[i]);
+		for(int a = 0x6000; a < 0x10000; a += 61)
+			mix(ARead[a](a));
+		mix(X.PC); mix(X.A); mix(X.X); mix(X.Y); mix(X.S); mix(X.P); mix(timestampbase);
+		if(fr % 60 == 59)
+			FCEUI_ResetNES();
+	}
+	FCEUI_CloseGame();
+	printf("mapper %d seed %u hash %08x %.3f ms/frame\n", mapper, seed, h,
+		std::chrono::duration<double, std::milli>(emuTime).count() / frames);
+	return 0;
+}
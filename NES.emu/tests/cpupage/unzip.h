@@ -0,0 +1,31 @@
+#pragma once
+
+// The part of minizip's unzip.h that fceu/file.cpp uses, so the host build
+// doesn't need minizip. hostStubs.cc makes every archive fail to open
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *unzFile;
+
+#define UNZ_OK 0
+
+typedef struct
+{
+	unsigned long uncompressed_size;
+} unz_file_info;
+
+unzFile unzOpen(const char *path);
+int unzClose(unzFile file);
+int unzGoToFirstFile(unzFile file);
+int unzGoToNextFile(unzFile file);
+int unzGetCurrentFileInfo(unzFile file, unz_file_info *info, char *fileName, unsigned long fileNameSize,
+	void *extraField, unsigned long extraFieldSize, char *comment, unsigned long commentSize);
+int unzOpenCurrentFile(unzFile file);
+int unzReadCurrentFile(unzFile file, void *buf, unsigned len);
+int unzCloseCurrentFile(unzFile file);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+/*  This file is part of NES.emu.
+
+	NES.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	NES.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with NES.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Times ExpandLine() against the per-mode loops DoLine() used before it,
+// converting full 224 line frames for each emphasis/grayscale mode
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include "types.h"
+#include "expandline.h"
+
+NATIVE_PIX_TYPE nativeCol[256];
+static NATIVE_PIX_TYPE frame[nesPixX * nesVisiblePixY];
+static uint8 lineBuffer[256];
+
+static __attribute__((noinline)) void oldConvert(NATIVE_PIX_TYPE *outLine, uint8 *target, uint8 ppu1)
+{
+	int x;
+	if (ppu1 & 0x01) {
+		for (x = 63; x >= 0; x--)
+			*(uint32*)&target[x << 2] = (*(uint32*)&target[x << 2]) & 0x30303030;
+	}
+	if ((ppu1 >> 5) == 0x7)
+		for (x = 0; x <= 255; x++)
+			outLine[x] = nativeCol[(target[x] & 0x3f) | 0xc0];
+	else if (ppu1 & 0xE0)
+		for (x = 0; x <= 255; x++)
+			outLine[x] = nativeCol[(target[x]) | 0x40];
+	else
+		for (x = 0; x <= 255; x++)
+			outLine[x] = nativeCol[(target[x] & 0x3f) | 0x80];
+}
+
+static __attribute__((noinline)) void newConvert(NATIVE_PIX_TYPE *outLine, uint8 *target, uint8 ppu1)
+{
+	uint8 mask = (ppu1 & 0x01) ? 0x30 : 0x3f;
+	ExpandLine(outLine, target, mask, &nativeCol[ExpandLineBank(ppu1)]);
+}
+
+static double nsPerLine(void (*convert)(NATIVE_PIX_TYPE *, uint8 *, uint8), uint8 ppu1, int frames)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++) {
+		for (uint y = 0; y < nesVisiblePixY; y++) {
+			// vary the line between calls so the loop can't be hoisted
+			lineBuffer[y] = (y * 13) & 0x7f;
+			convert(&frame[y * nesPixX], lineBuffer, ppu1);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / ((double)frames * nesVisiblePixY);
+}
+
+int main(int argc, char **argv)
+{
+	int frames = argc > 1 ? atoi(argv[1]) : 5000;
+	for (int i = 0; i < 256; i++) {
+		nativeCol[i] = (NATIVE_PIX_TYPE)(i * 0x9E3779B1u);
+		lineBuffer[i] = (i * 7) & 0x7f;
+	}
+	static const struct { const char *name; uint8 ppu1; } modes[] = {
+		{ "normal", 0x18 },
+		{ "grayscale", 0x19 },
+		{ "partial emphasis", 0x38 },
+		{ "full emphasis", 0xF8 },
+	};
+	printf("%u bit pixels, %d frames\n", (uint)sizeof(NATIVE_PIX_TYPE) * 8, frames);
+	for (auto &m : modes) {
+		// warm up caches once before timing
+		nsPerLine(oldConvert, m.ppu1, 1);
+		nsPerLine(newConvert, m.ppu1, 1);
+		double oldNs = nsPerLine(oldConvert, m.ppu1, frames);
+		double newNs = nsPerLine(newConvert, m.ppu1, frames);
+		printf("%-16s per-mode loops %6.1f ns/line, ExpandLine %6.1f ns/line\n", m.name, oldNs, newNs);
+	}
+	return 0;
+}
@@ -0,0 +1,93 @@
+/*  This file is part of NES.emu.
+
+	NES.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	NES.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with NES.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Checks ExpandLine() against the scalar per-mode lookup DoLine() used
+// before it, for every emphasis and grayscale combination of PPU[1].
+// Built with NEON_MODEL the NEON paths are compiled against the portable
+// intrinsics in neon-model/ so they can be checked on any host
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "types.h"
+#ifdef NEON_MODEL
+#include <arm_neon.h>
+// set after the system headers so only ExpandLine() sees the target
+#define __ARM_NEON__ 1
+#if NEON_MODEL == 64
+#define __aarch64__ 1
+#endif
+#endif
+#include "expandline.h"
+
+NATIVE_PIX_TYPE nativeCol[256];
+
+// DoLine()'s conversion before ExpandLine(), with rendering enabled
+static void refConvert(NATIVE_PIX_TYPE *outLine, const uint8 *line, uint8 ppu1)
+{
+	uint8 target[256];
+	memcpy(target, line, sizeof target);
+	if (ppu1 & 0x01) {
+		for (int x = 0; x < 256; x++)
+			target[x] &= 0x30;
+	}
+	if ((ppu1 >> 5) == 0x7) {
+		for (int x = 0; x < 256; x++)
+			outLine[x] = nativeCol[(target[x] & 0x3f) | 0xc0];
+	} else if (ppu1 & 0xE0) {
+		for (int x = 0; x < 256; x++)
+			outLine[x] = nativeCol[target[x] | 0x40];
+	} else {
+		for (int x = 0; x < 256; x++)
+			outLine[x] = nativeCol[(target[x] & 0x3f) | 0x80];
+	}
+}
+
+static NATIVE_PIX_TYPE randomColor()
+{
+	return (NATIVE_PIX_TYPE)(((uint32)rand() << 16) ^ (uint32)rand());
+}
+
+int main()
+{
+	srand(1);
+	int errors = 0;
+	for (int pass = 0; pass < 500; pass++) {
+		for (auto &c : nativeCol)
+			c = randomColor();
+		// line pixels are 6 bit palette indexes plus the 0x40 background flag
+		uint8 line[256];
+		for (auto &p : line)
+			p = rand() & 0x7f;
+		for (int mode = 0; mode < 16; mode++) {
+			uint8 ppu1 = ((mode & 0x7) << 5) | (mode >> 3) | 0x18;
+			NATIVE_PIX_TYPE ref[256], out[256];
+			refConvert(ref, line, ppu1);
+			uint8 mask = (ppu1 & 0x01) ? 0x30 : 0x3f;
+			ExpandLine(out, line, mask, &nativeCol[ExpandLineBank(ppu1)]);
+			if (memcmp(ref, out, sizeof ref)) {
+				if (errors < 10)
+					fprintf(stderr, "pass %d PPU[1] 0x%02X: mismatch\n", pass, ppu1);
+				errors++;
+			}
+		}
+	}
+	if (errors) {
+		fprintf(stderr, "%d mismatched lines\n", errors);
+		return 1;
+	}
+	printf("ExpandLine (%u bit pixels) matches the scalar lookup\n", (uint)sizeof(NATIVE_PIX_TYPE) * 8);
+	return 0;
+}
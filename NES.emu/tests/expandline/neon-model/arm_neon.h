@@ -0,0 +1,32 @@
+#pragma once
+
+// Portable scalar model of the NEON intrinsics ExpandLine() uses, matching
+// their lane order and out-of-range table index behavior. Only for
+// checking the NEON code paths on hosts without NEON, see Makefile
+
+#include <cstdint>
+#include <cstring>
+struct uint8x8_t { uint8_t v[8]; };
+struct uint8x16_t { uint8_t v[16]; };
+struct uint8x8x2_t { uint8x8_t val[2]; };
+struct uint8x8x4_t { uint8x8_t val[4]; };
+struct uint8x16x2_t { uint8x16_t val[2]; };
+struct uint8x16x4_t { uint8x16_t val[4]; };
+static inline uint8x8_t vdup_n_u8(uint8_t x) { uint8x8_t r; memset(r.v, x, 8); return r; }
+static inline uint8x16_t vdupq_n_u8(uint8_t x) { uint8x16_t r; memset(r.v, x, 16); return r; }
+static inline uint8x8_t vld1_u8(const uint8_t *p) { uint8x8_t r; memcpy(r.v, p, 8); return r; }
+static inline uint8x16_t vld1q_u8(const uint8_t *p) { uint8x16_t r; memcpy(r.v, p, 16); return r; }
+static inline uint8x8_t vand_u8(uint8x8_t a, uint8x8_t b) { for(int i=0;i<8;i++) a.v[i]&=b.v[i]; return a; }
+static inline uint8x16_t vandq_u8(uint8x16_t a, uint8x16_t b) { for(int i=0;i<16;i++) a.v[i]&=b.v[i]; return a; }
+static inline uint8x8_t vsub_u8(uint8x8_t a, uint8x8_t b) { for(int i=0;i<8;i++) a.v[i]-=b.v[i]; return a; }
+static inline uint8x8_t vget_low_u8(uint8x16_t a) { uint8x8_t r; memcpy(r.v, a.v, 8); return r; }
+static inline uint8x8_t vget_high_u8(uint8x16_t a) { uint8x8_t r; memcpy(r.v, a.v + 8, 8); return r; }
+static inline uint8x16x2_t vld2q_u8(const uint8_t *p) { uint8x16x2_t r; for(int i=0;i<16;i++) for(int k=0;k<2;k++) r.val[k].v[i]=p[i*2+k]; return r; }
+static inline uint8x16x4_t vld4q_u8(const uint8_t *p) { uint8x16x4_t r; for(int i=0;i<16;i++) for(int k=0;k<4;k++) r.val[k].v[i]=p[i*4+k]; return r; }
+static inline void vst2_u8(uint8_t *p, uint8x8x2_t a) { for(int i=0;i<8;i++) for(int k=0;k<2;k++) p[i*2+k]=a.val[k].v[i]; }
+static inline void vst4_u8(uint8_t *p, uint8x8x4_t a) { for(int i=0;i<8;i++) for(int k=0;k<4;k++) p[i*4+k]=a.val[k].v[i]; }
+static inline void vst2q_u8(uint8_t *p, uint8x16x2_t a) { for(int i=0;i<16;i++) for(int k=0;k<2;k++) p[i*2+k]=a.val[k].v[i]; }
+static inline void vst4q_u8(uint8_t *p, uint8x16x4_t a) { for(int i=0;i<16;i++) for(int k=0;k<4;k++) p[i*4+k]=a.val[k].v[i]; }
+static inline uint8x8_t vtbl4_u8(uint8x8x4_t t, uint8x8_t idx) { uint8x8_t r; for(int i=0;i<8;i++) r.v[i] = idx.v[i] < 32 ? t.val[idx.v[i]/8].v[idx.v[i]%8] : 0; return r; }
+static inline uint8x8_t vtbx4_u8(uint8x8_t a, uint8x8x4_t t, uint8x8_t idx) { for(int i=0;i<8;i++) if(idx.v[i] < 32) a.v[i] = t.val[idx.v[i]/8].v[idx.v[i]%8]; return a; }
+static inline uint8x16_t vqtbl4q_u8(uint8x16x4_t t, uint8x16_t idx) { uint8x16_t r; for(int i=0;i<16;i++) r.v[i] = idx.v[i] < 64 ? t.val[idx.v[i]/16].v[idx.v[i]%16] : 0; return r; }
@@ -50,6 +50,12 @@ public:
 	// easy interleving of two channels into a stereo output buffer.
 	long read_samples( blip_sample_t* dest, long max_samples, int stereo = 0 );
 	
+	// Same as calling read_samples() with stereo true on both buffers, but runs
+	// the two integrators together. Buffers should have the same clock rate,
+	// sample rate and bass frequency, otherwise each is read separately.
+	static long read_samples_stereo( Blip_Buffer& left, Blip_Buffer& right,
+			blip_sample_t* dest, long max_samples );
+	
 // Additional optional features
 
 	// Current output sample rate
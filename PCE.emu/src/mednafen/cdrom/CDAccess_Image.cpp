@@ -856,6 +856,13 @@ void CDAccess_Image::ImageOpen(const char *path, bool image_memcache)
   } // end to cue sheet handling
  } // end to track loop
 
+ // let threaded audio readers decode the start of each audio track ahead of time
+ for(int x = FirstTrack; x < (FirstTrack + NumTracks); x++)
+ {
+  if(Tracks[x].AReader)
+   Tracks[x].AReader->HintSeekTarget(Tracks[x].FileOffset / 4);
+ }
+
  total_sectors = RunningLBA;
 }
 
@@ -80,6 +80,11 @@ int64 AudioReader::FrameCount(void)
  return(0);
 }
 
+void AudioReader::HintSeekTarget(int64 frame_offset)
+{
+
+}
+
 /*
 **
 **
@@ -224,11 +229,363 @@ int64 SFReader::FrameCount(void)
 #endif
 
 
+/*
+**
+**
+**
+**
+**
+**
+**
+**
+**
+*/
+
+// Runs another reader on a worker thread that decodes ahead of the play position into a PCM
+// ring, so reading a CD-DA sector only copies samples. The start of each seek target (hinted
+// track starts and positions the game jumps to) is kept in a small cache so track changes and
+// looping BGM can play from it while the decoder seeks in the background.
+class ThreadedAudioReader : public AudioReader
+{
+ public:
+ ThreadedAudioReader(AudioReader *decoder);
+ ~ThreadedAudioReader();
+
+ int64 Read_(int16 *buffer, int64 frames);
+ bool Seek_(int64 frame_offset);
+ int64 FrameCount(void);
+ void HintSeekTarget(int64 frame_offset);
+
+ private:
+ static constexpr uint32 RingFrames = 44100;
+ static constexpr uint32 ChunkFrames = 588 * 4;
+ static constexpr uint32 CacheFrames = 44100 / 2;
+ static constexpr unsigned MaxCacheEntries = 8;
+
+ struct CacheEntry
+ {
+  int64 start = -1;
+  uint32 frames = 0;
+  uint32 lastUse = 0;
+  int16 *data = nullptr;
+ };
+
+ static void *ThreadStart_C(void *arg);
+ void DecodeThread(void);
+ void Restart(int64 pos);
+ CacheEntry *FindCache(int64 pos);
+ CacheEntry *AllocCache(int64 start);
+
+ AudioReader *decoder;
+ int64 frameCount;
+ MDFN_Thread *thread = nullptr;
+ MDFN_Mutex *mutex = nullptr;
+ MDFN_Cond *workCond = nullptr, *dataCond = nullptr;
+ bool exitThread = false;
+
+ // consumer side
+ int64 readPos = 0;
+
+ // PCM ring, ring[ringHead] holds frame ringStart
+ int16 *ring = nullptr;
+ uint32 ringHead = 0, ringFrames = 0;
+ int64 ringStart = 0;
+ int64 decodePos = 0;
+ bool ringActive = false, ringEOF = false;
+ uint32 restartGen = 0;
+
+ CacheEntry cache[MaxCacheEntries];
+ CacheEntry *fillEntry = nullptr; // filled from the ring after a seek miss
+ CacheEntry *hintEntry = nullptr; // filled directly by the decoder
+ int64 hints[MaxCacheEntries];
+ unsigned hintCount = 0;
+ uint32 useCounter = 0;
+
+ int16 decodeBuf[ChunkFrames * 2];
+};
+
+// tracks in a CUE sheet may share one file and stream, only decode one at a time
+static MDFN_Mutex *decodeMutex = nullptr;
+
+ThreadedAudioReader::ThreadedAudioReader(AudioReader *decoder) : decoder(decoder), frameCount(decoder->FrameCount())
+{
+ if(!(ring = (int16 *)malloc(RingFrames * sizeof(int16) * 2))
+  || !(mutex = MDFND_CreateMutex()) || !(workCond = MDFND_CreateCond()) || !(dataCond = MDFND_CreateCond())
+  || !(thread = MDFND_CreateThread(ThreadStart_C, this)))
+ {
+  if(dataCond)
+   MDFND_DestroyCond(dataCond);
+  if(workCond)
+   MDFND_DestroyCond(workCond);
+  if(mutex)
+   MDFND_DestroyMutex(mutex);
+  free(ring);
+  throw(0);
+ }
+}
+
+ThreadedAudioReader::~ThreadedAudioReader()
+{
+ MDFND_LockMutex(mutex);
+ exitThread = true;
+ MDFND_SignalCond(workCond);
+ MDFND_UnlockMutex(mutex);
+ MDFND_WaitThread(thread, NULL);
+ MDFND_DestroyCond(dataCond);
+ MDFND_DestroyCond(workCond);
+ MDFND_DestroyMutex(mutex);
+ for(auto &e : cache)
+  free(e.data);
+ free(ring);
+ delete decoder;
+}
+
+void *ThreadedAudioReader::ThreadStart_C(void *arg)
+{
+ ((ThreadedAudioReader *)arg)->DecodeThread();
+ return(NULL);
+}
+
+ThreadedAudioReader::CacheEntry *ThreadedAudioReader::FindCache(int64 pos)
+{
+ for(auto &e : cache)
+ {
+  if(e.frames && pos >= e.start && pos < e.start + e.frames)
+   return(&e);
+ }
+ return(NULL);
+}
+
+ThreadedAudioReader::CacheEntry *ThreadedAudioReader::AllocCache(int64 start)
+{
+ CacheEntry *victim = NULL;
+
+ for(auto &e : cache)
+ {
+  if(e.start == start)
+   return(&e);
+  if(&e == fillEntry || &e == hintEntry)
+   continue;
+  if(!victim || e.start == -1 || (victim->start != -1 && e.lastUse < victim->lastUse))
+   victim = &e;
+ }
+
+ if(!victim)
+  return(NULL);
+
+ if(!victim->data && !(victim->data = (int16 *)malloc(CacheFrames * sizeof(int16) * 2)))
+  return(NULL);
+
+ victim->start = start;
+ victim->frames = 0;
+ victim->lastUse = ++useCounter;
+ return(victim);
+}
+
+// Called with the mutex held, makes the decoder continue from pos
+void ThreadedAudioReader::Restart(int64 pos)
+{
+ ringStart = pos;
+ ringHead = 0;
+ ringFrames = 0;
+ decodePos = pos;
+ ringActive = true;
+ ringEOF = false;
+ restartGen++;
+ // remember the start of new seek targets, but not positions right after cached data
+ fillEntry = FindCache(pos - 1) ? NULL : AllocCache(pos);
+ if(fillEntry && fillEntry->frames)
+  fillEntry = NULL; // already cached from an earlier seek
+ MDFND_SignalCond(workCond);
+}
+
+void ThreadedAudioReader::DecodeThread(void)
+{
+ MDFND_LockMutex(mutex);
+ while(!exitThread)
+ {
+  bool fillRing = ringActive && !ringEOF && ringFrames < RingFrames;
+
+  if(!fillRing && !hintEntry && hintCount)
+  {
+   int64 hint = hints[--hintCount];
+
+   if(!FindCache(hint))
+    hintEntry = AllocCache(hint);
+   continue;
+  }
+
+  if(!fillRing && !hintEntry)
+  {
+   MDFND_WaitCond(workCond, mutex);
+   continue;
+  }
+
+  int64 pos;
+  uint32 frames;
+  uint32 gen = restartGen;
+  CacheEntry *entry = hintEntry;
+
+  if(fillRing)
+  {
+   pos = decodePos;
+   frames = std::min(ChunkFrames, RingFrames - ringFrames);
+  }
+  else
+  {
+   pos = entry->start + entry->frames;
+   frames = std::min(ChunkFrames, CacheFrames - entry->frames);
+  }
+
+  MDFND_UnlockMutex(mutex);
+  MDFND_LockMutex(decodeMutex);
+  int64 got = decoder->Read(pos, decodeBuf, frames);
+  MDFND_UnlockMutex(decodeMutex);
+  MDFND_LockMutex(mutex);
+
+  if(got < 0)
+   got = 0;
+
+  if(fillRing)
+  {
+   if(gen != restartGen)
+    continue; // consumer moved elsewhere while decoding
+
+   for(uint32 i = 0; i < got; i++)
+   {
+    uint32 idx = (ringHead + ringFrames + i) % RingFrames;
+
+    ring[idx * 2] = decodeBuf[i * 2];
+    ring[idx * 2 + 1] = decodeBuf[i * 2 + 1];
+   }
+   ringFrames += got;
+   decodePos += got;
+
+   if(fillEntry && fillEntry->start + fillEntry->frames == pos)
+   {
+    uint32 n = std::min<uint32>(got, CacheFrames - fillEntry->frames);
+
+    memcpy(fillEntry->data + fillEntry->frames * 2, decodeBuf, n * sizeof(int16) * 2);
+    fillEntry->frames += n;
+    if(fillEntry->frames == CacheFrames || n < got)
+     fillEntry = NULL;
+   }
+
+   if(got < frames)
+   {
+    ringEOF = true;
+    fillEntry = NULL;
+   }
+   MDFND_SignalCond(dataCond);
+  }
+  else if(hintEntry == entry && entry->start + entry->frames == pos)
+  {
+   memcpy(entry->data + entry->frames * 2, decodeBuf, got * sizeof(int16) * 2);
+   entry->frames += got;
+   if(entry->frames == CacheFrames || got < frames)
+    hintEntry = NULL;
+  }
+ }
+ MDFND_UnlockMutex(mutex);
+}
+
+bool ThreadedAudioReader::Seek_(int64 frame_offset)
+{
+ readPos = frame_offset;
+ return(true);
+}
+
+int64 ThreadedAudioReader::Read_(int16 *buffer, int64 frames)
+{
+ int64 done = 0;
+
+ MDFND_LockMutex(mutex);
+ while(done < frames)
+ {
+  if(readPos > ringStart && readPos <= ringStart + ringFrames)
+  {
+   // drop anything before the read position so the decoder has room to continue
+   uint32 skip = readPos - ringStart;
+
+   ringHead = (ringHead + skip) % RingFrames;
+   ringFrames -= skip;
+   ringStart = readPos;
+   MDFND_SignalCond(workCond);
+  }
+
+  if(readPos == ringStart && ringFrames)
+  {
+   uint32 n = std::min<int64>(frames - done, ringFrames);
+
+   for(uint32 i = 0; i < n; i++)
+   {
+    uint32 idx = (ringHead + i) % RingFrames;
+
+    buffer[(done + i) * 2] = ring[idx * 2];
+    buffer[(done + i) * 2 + 1] = ring[idx * 2 + 1];
+   }
+   ringHead = (ringHead + n) % RingFrames;
+   ringFrames -= n;
+   ringStart += n;
+   readPos += n;
+   done += n;
+   MDFND_SignalCond(workCond);
+   continue;
+  }
+
+  if(CacheEntry *e = FindCache(readPos))
+  {
+   uint32 offset = readPos - e->start;
+   uint32 n = std::min<int64>(frames - done, e->frames - offset);
+
+   memcpy(buffer + done * 2, e->data + offset * 2, n * sizeof(int16) * 2);
+   e->lastUse = ++useCounter;
+   readPos += n;
+   done += n;
+
+   // decode what follows the cached block while it plays
+   int64 end = e->start + e->frames;
+   if(e->frames == CacheFrames && !(ringActive && end >= ringStart && end <= decodePos))
+    Restart(end);
+   continue;
+  }
+
+  if(ringActive && ringEOF && readPos >= decodePos)
+   break;
+
+  if(!(ringActive && readPos >= ringStart && readPos <= decodePos))
+   Restart(readPos);
+
+  MDFND_WaitCond(dataCond, mutex);
+ }
+ MDFND_UnlockMutex(mutex);
+
+ return(done);
+}
+
+int64 ThreadedAudioReader::FrameCount(void)
+{
+ return(frameCount);
+}
+
+void ThreadedAudioReader::HintSeekTarget(int64 frame_offset)
+{
+ MDFND_LockMutex(mutex);
+ if(hintCount < MaxCacheEntries && !FindCache(frame_offset))
+ {
+  hints[hintCount++] = frame_offset;
+  MDFND_SignalCond(workCond);
+ }
+ MDFND_UnlockMutex(mutex);
+}
+
 AudioReader *AR_Open(IO &fp)
 {
+ AudioReader *decoder = NULL;
+
  try
  {
-  return new OggVorbisReader(fp);
+  decoder = new OggVorbisReader(fp);
  }
  catch(int i)
  {
@@ -236,15 +593,32 @@ AudioReader *AR_Open(IO &fp)
 
 
 #ifdef HAVE_LIBSNDFILE
+ if(!decoder)
+ {
+  try
+  {
+   decoder = new SFReader(fp);
+  }
+  catch(int i)
+  {
+  }
+ }
+#endif
+
+ if(!decoder)
+  return(NULL);
+
+ if(!decodeMutex && !(decodeMutex = MDFND_CreateMutex()))
+  return(decoder);
+
  try
  {
-	return new SFReader(fp);
+  return new ThreadedAudioReader(decoder);
  }
  catch(int i)
  {
+  MDFN_printf("Unable to start audio decoding thread, decoding on demand\n");
  }
-#endif
 
- return(NULL);
+ return(decoder);
 }
-
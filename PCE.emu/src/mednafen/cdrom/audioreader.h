@@ -10,6 +10,11 @@ class AudioReader
  virtual ~AudioReader();
 
  virtual int64 FrameCount(void);
+
+ // Playback will likely start at frame_offset later (track start, loop point),
+ // readers that decode in the background can prepare it ahead of time.
+ virtual void HintSeekTarget(int64 frame_offset);
+
  INLINE int64 Read(int64 frame_offset, int16 *buffer, int64 frames)
  {
   int64 ret;
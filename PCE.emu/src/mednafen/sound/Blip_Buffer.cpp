@@ -7,6 +7,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#if defined (__SSE2__)
+	#include <emmintrin.h>
+#elif defined (__ARM_NEON__)
+	#include <arm_neon.h>
+#endif
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -431,6 +436,96 @@ long Blip_Buffer::read_samples( blip_sample_t* BLIP_RESTRICT out, long max_sampl
 	return count;
 }
 
+long Blip_Buffer::read_samples_stereo( Blip_Buffer& left, Blip_Buffer& right,
+		blip_sample_t* BLIP_RESTRICT out, long max_samples )
+{
+	long count = left.samples_avail();
+	if ( count != right.samples_avail() || left.bass_shift_ != right.bass_shift_ )
+	{
+		right.read_samples( out + 1, max_samples, 1 );
+		return left.read_samples( out, max_samples, 1 );
+	}
+	if ( count > max_samples )
+		count = max_samples;
+	
+	if ( count )
+	{
+		int const bass = left.bass_shift_;
+		buf_t_ const* BLIP_RESTRICT in_l = left.buffer_;
+		buf_t_ const* BLIP_RESTRICT in_r = right.buffer_;
+		blip_long accum_l = left.reader_accum_;
+		blip_long accum_r = right.reader_accum_;
+		long n = 0;
+		
+		// Each step is a serial recurrence, so the left and right accumulators
+		// share a vector and advance together. Saturating packs match the
+		// scalar clamp since the shifted accumulator always fits in 18 bits.
+		#if defined (__SSE2__)
+			// lanes 0 and 1 hold left and right, the upper lanes are ignored
+			__m128i accum = _mm_unpacklo_epi32( _mm_cvtsi32_si128( accum_l ), _mm_cvtsi32_si128( accum_r ) );
+			__m128i const bass_shift = _mm_cvtsi32_si128( bass );
+			#define BLIP_STEREO_STEP( s, in ) \
+				__m128i s = _mm_srai_epi32( accum, blip_sample_bits - 16 );\
+				accum = _mm_add_epi32( accum, _mm_sub_epi32( (in), _mm_sra_epi32( accum, bass_shift ) ) )
+			for ( ; n + 4 <= count; n += 4 )
+			{
+				__m128i l = _mm_loadu_si128( (__m128i const*) (in_l + n) );
+				__m128i r = _mm_loadu_si128( (__m128i const*) (in_r + n) );
+				__m128i in01 = _mm_unpacklo_epi32( l, r );
+				__m128i in23 = _mm_unpackhi_epi32( l, r );
+				BLIP_STEREO_STEP( s0, in01 );
+				BLIP_STEREO_STEP( s1, _mm_srli_si128( in01, 8 ) );
+				BLIP_STEREO_STEP( s2, in23 );
+				BLIP_STEREO_STEP( s3, _mm_srli_si128( in23, 8 ) );
+				_mm_storeu_si128( (__m128i*) (out + n * 2), _mm_packs_epi32(
+						_mm_unpacklo_epi64( s0, s1 ), _mm_unpacklo_epi64( s2, s3 ) ) );
+			}
+			#undef BLIP_STEREO_STEP
+			accum_l = _mm_cvtsi128_si32( accum );
+			accum_r = _mm_cvtsi128_si32( _mm_srli_si128( accum, 4 ) );
+		#elif defined (__ARM_NEON__)
+			int32x2_t accum = vset_lane_s32( accum_r, vdup_n_s32( accum_l ), 1 );
+			int32x2_t const bass_shift = vdup_n_s32( -bass );
+			#define BLIP_STEREO_STEP( s, in ) \
+				int32x2_t s = vshr_n_s32( accum, blip_sample_bits - 16 );\
+				accum = vadd_s32( accum, vsub_s32( (in), vshl_s32( accum, bass_shift ) ) )
+			for ( ; n + 4 <= count; n += 4 )
+			{
+				int32x4x2_t in = vzipq_s32( vld1q_s32( in_l + n ), vld1q_s32( in_r + n ) );
+				BLIP_STEREO_STEP( s0, vget_low_s32( in.val [0] ) );
+				BLIP_STEREO_STEP( s1, vget_high_s32( in.val [0] ) );
+				BLIP_STEREO_STEP( s2, vget_low_s32( in.val [1] ) );
+				BLIP_STEREO_STEP( s3, vget_high_s32( in.val [1] ) );
+				vst1q_s16( out + n * 2, vcombine_s16( vqmovn_s32( vcombine_s32( s0, s1 ) ),
+						vqmovn_s32( vcombine_s32( s2, s3 ) ) ) );
+			}
+			#undef BLIP_STEREO_STEP
+			accum_l = vget_lane_s32( accum, 0 );
+			accum_r = vget_lane_s32( accum, 1 );
+		#endif
+		
+		for ( ; n < count; n++ )
+		{
+			blip_long l = accum_l >> (blip_sample_bits - 16);
+			blip_long r = accum_r >> (blip_sample_bits - 16);
+			if ( (blip_sample_t) l != l )
+				l = 0x7FFF - (l >> 24);
+			if ( (blip_sample_t) r != r )
+				r = 0x7FFF - (r >> 24);
+			out [n * 2    ] = (blip_sample_t) l;
+			out [n * 2 + 1] = (blip_sample_t) r;
+			accum_l += in_l [n] - (accum_l >> bass);
+			accum_r += in_r [n] - (accum_r >> bass);
+		}
+		
+		left.reader_accum_  = accum_l;
+		right.reader_accum_ = accum_r;
+		left.remove_samples( count );
+		right.remove_samples( count );
+	}
+	return count;
+}
+
 void Blip_Buffer::mix_samples( blip_sample_t const* in, long count )
 {
 	if ( buffer_size_ == silent_buf_size )
@@ -0,0 +1,106 @@
+/*  This file is part of PCE.emu.
+
+	PCE.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	PCE.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with PCE.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+// Checks Blip_Buffer::read_samples_stereo() against two strided
+// read_samples() calls fed the same random deltas, with periodic
+// overdriven frames to exercise the saturating clamp
+
+#include <blip/Blip_Buffer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <initializer_list>
+
+static const int frames = 2000;
+
+static int testBassFreq(int bassFreq)
+{
+	Blip_Buffer ref[2], stereo[2];
+	Blip_Synth<blip_good_quality, 8192> refSynth[2], stereoSynth[2];
+	for(int c = 0; c < 2; c++)
+	{
+		for(auto *buf : {&ref[c], &stereo[c]})
+		{
+			buf->set_sample_rate(44100, 50);
+			buf->clock_rate(7159090);
+			buf->bass_freq(bassFreq);
+		}
+		refSynth[c].output(&ref[c]);
+		stereoSynth[c].output(&stereo[c]);
+		double vol = c ? 0.9 : 2.5;
+		refSynth[c].volume(vol);
+		stereoSynth[c].volume(vol);
+	}
+	srand(bassFreq + 1);
+	double refTime = 0, stereoTime = 0;
+	for(int frame = 0; frame < frames; frame++)
+	{
+		int clocks = 119318 + (rand() % 3);
+		bool clip = frame % 300 < 3;
+		for(int c = 0; c < 2; c++)
+		{
+			for(int t = 0; t < clocks; t += 1 + rand() % 200)
+			{
+				int amp = (rand() % 16384) - 8192;
+				if(clip)
+					amp *= 4;
+				refSynth[c].update(t, amp);
+				stereoSynth[c].update(t, amp);
+			}
+		}
+		short refOut[4000], stereoOut[4000];
+		memset(refOut, 0x55, sizeof refOut);
+		memset(stereoOut, 0x55, sizeof stereoOut);
+		// request less than is available on some frames so a remainder carries over
+		long maxSamples = 600 + rand() % 400;
+		auto t0 = std::chrono::steady_clock::now();
+		long refSamples = 0;
+		for(int c = 0; c < 2; c++)
+		{
+			ref[c].end_frame(clocks);
+			refSamples = ref[c].read_samples(refOut + c, maxSamples, 1);
+		}
+		auto t1 = std::chrono::steady_clock::now();
+		for(int c = 0; c < 2; c++)
+			stereo[c].end_frame(clocks);
+		long stereoSamples = Blip_Buffer::read_samples_stereo(stereo[0], stereo[1], stereoOut, maxSamples);
+		auto t2 = std::chrono::steady_clock::now();
+		refTime += std::chrono::duration<double, std::micro>(t1 - t0).count();
+		stereoTime += std::chrono::duration<double, std::micro>(t2 - t1).count();
+		if(refSamples != stereoSamples || memcmp(refOut, stereoOut, sizeof refOut)
+			|| ref[0].samples_avail() != stereo[0].samples_avail()
+			|| ref[1].samples_avail() != stereo[1].samples_avail())
+		{
+			fprintf(stderr, "bass freq %d: mismatch in frame %d (%ld vs %ld samples)\n",
+				bassFreq, frame, refSamples, stereoSamples);
+			return 1;
+		}
+	}
+	printf("bass freq %d: read_samples x2 %.2fus/frame, read_samples_stereo %.2fus/frame\n",
+		bassFreq, refTime / frames, stereoTime / frames);
+	return 0;
+}
+
+int main()
+{
+	int errors = 0;
+	for(int bassFreq : {0, 10, 16, 300})
+		errors += testBassFreq(bassFreq);
+	if(errors)
+		return 1;
+	printf("read_samples_stereo matches read_samples\n");
+	return 0;
+}
@@ -85,16 +85,66 @@ public:
 			Settings.BlockInvalidVRAMAccessMaster = item.on;
 		}
 	};
+
+	BoolMenuItem threadedRendering
+	{
+		"Threaded Rendering",
+		[this](BoolMenuItem &item, View &, const Input::Event &e)
+		{
+			item.toggle(*this);
+			optionThreadedRendering = item.on;
+			Settings.ThreadedRendering = item.on;
+		}
+	};
+
+	BoolMenuItem decompressionCache
+	{
+		"Cache Decompressed Graphics",
+		[this](BoolMenuItem &item, View &, const Input::Event &e)
+		{
+			item.toggle(*this);
+			optionDecompressionCache = item.on;
+			Settings.DecompressionCache = item.on;
+		}
+	};
+
+	BoolMenuItem threadedAPU
+	{
+		"Threaded Sound CPU",
+		[this](BoolMenuItem &item, View &, const Input::Event &e)
+		{
+			item.toggle(*this);
+			optionThreadedAPU = item.on;
+			Settings.ThreadedAPU = item.on;
+		}
+	};
 	#endif
 
 public:
 	SystemOptionView(Base::Window &win): OptionView(win) {}
 
+	void loadAudioItems(MenuItem *item[], uint &items)
+	{
+		OptionView::loadAudioItems(item, items);
+		#ifndef SNES9X_VERSION_1_4
+		threadedAPU.init(optionThreadedAPU); item[items++] = &threadedAPU;
+		#endif
+	}
+
+	void loadVideoItems(MenuItem *item[], uint &items)
+	{
+		OptionView::loadVideoItems(item, items);
+		#ifndef SNES9X_VERSION_1_4
+		threadedRendering.init(optionThreadedRendering); item[items++] = &threadedRendering;
+		#endif
+	}
+
 	void loadSystemItems(MenuItem *item[], uint &items)
 	{
 		OptionView::loadSystemItems(item, items);
 		#ifndef SNES9X_VERSION_1_4
 		blockInvalidVRAMAccess.init(optionBlockInvalidVRAMAccess); item[items++] = &blockInvalidVRAMAccess;
+		decompressionCache.init(optionDecompressionCache); item[items++] = &decompressionCache;
 		#endif
 	}
 
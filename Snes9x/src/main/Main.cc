@@ -61,12 +61,17 @@ enum
 };
 
 enum {
-	CFGKEY_MULTITAP = 276, CFGKEY_BLOCK_INVALID_VRAM_ACCESS = 277
+	CFGKEY_MULTITAP = 276, CFGKEY_BLOCK_INVALID_VRAM_ACCESS = 277,
+	CFGKEY_THREADED_RENDERING = 278, CFGKEY_DECOMPRESSION_CACHE = 279,
+	CFGKEY_THREADED_APU = 280
 };
 
 static Byte1Option optionMultitap(CFGKEY_MULTITAP, 0);
 #ifndef SNES9X_VERSION_1_4
 static Byte1Option optionBlockInvalidVRAMAccess(CFGKEY_BLOCK_INVALID_VRAM_ACCESS, 1);
+static Byte1Option optionThreadedRendering(CFGKEY_THREADED_RENDERING, 0);
+static Byte1Option optionDecompressionCache(CFGKEY_DECOMPRESSION_CACHE, 0);
+static Byte1Option optionThreadedAPU(CFGKEY_THREADED_APU, 0);
 #endif
 
 #include <emuframework/CommonGui.hh>
@@ -132,6 +137,9 @@ void EmuSystem::onOptionsLoaded()
 {
 	#ifndef SNES9X_VERSION_1_4
 	Settings.BlockInvalidVRAMAccessMaster = optionBlockInvalidVRAMAccess;
+	Settings.ThreadedRendering = optionThreadedRendering;
+	Settings.DecompressionCache = optionDecompressionCache;
+	Settings.ThreadedAPU = optionThreadedAPU;
 	#endif
 }
 
@@ -143,6 +151,9 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 		bcase CFGKEY_MULTITAP: optionMultitap.readFromIO(io, readSize);
 		#ifndef SNES9X_VERSION_1_4
 		bcase CFGKEY_BLOCK_INVALID_VRAM_ACCESS: optionBlockInvalidVRAMAccess.readFromIO(io, readSize);
+		bcase CFGKEY_THREADED_RENDERING: optionThreadedRendering.readFromIO(io, readSize);
+		bcase CFGKEY_DECOMPRESSION_CACHE: optionDecompressionCache.readFromIO(io, readSize);
+		bcase CFGKEY_THREADED_APU: optionThreadedAPU.readFromIO(io, readSize);
 		#endif
 	}
 	return 1;
@@ -153,6 +164,9 @@ void EmuSystem::writeConfig(IO &io)
 	optionMultitap.writeWithKeyIfNotDefault(io);
 	#ifndef SNES9X_VERSION_1_4
 	optionBlockInvalidVRAMAccess.writeWithKeyIfNotDefault(io);
+	optionThreadedRendering.writeWithKeyIfNotDefault(io);
+	optionDecompressionCache.writeWithKeyIfNotDefault(io);
+	optionThreadedAPU.writeWithKeyIfNotDefault(io);
 	#endif
 }
 
@@ -458,6 +472,9 @@ void S9xAutoSaveSRAM (void)
 void EmuSystem::closeSystem()
 {
 	saveBackupMem();
+	#ifndef SNES9X_VERSION_1_4
+	S9xAPUReportThreadStats();
+	#endif
 }
 
 bool EmuSystem::vidSysIsPAL() { return 0; }
@@ -176,7 +176,12 @@
  ***********************************************************************************/
 
 #include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <atomic>
 #include "snes9x.h"
+#include "memmap.h"
 #include "apu.h"
 #include "snapshot.h"
 #include "display.h"
@@ -192,6 +197,19 @@
 #define APU_NUMERATOR_PAL			34176
 #define APU_DENOMINATOR_PAL			709379
 
+// With Settings.ThreadedAPU the SMP and DSP run on a worker thread. The CPU side
+// still works out how many SMP clocks have passed at each sync point, but queues
+// them, along with any port write made there, instead of running the SMP itself.
+// The worker replays the queue in order, so it does exactly what lockstep would.
+// Port reads and sample landing wait for the queue to drain. A frame that waits
+// more than APU_THREAD_LOCKSTEP_SYNCS times is taken as tight polling and sends
+// the following APU_THREAD_LOCKSTEP_FRAMES frames back to lockstep.
+#define APU_THREAD_QUEUE_SIZE		256		// power of two, bounds the lookahead
+#define APU_THREAD_LAND_LINES		32
+#define APU_THREAD_LOCKSTEP_SYNCS	64
+#define APU_THREAD_LOCKSTEP_FRAMES	60
+#define APU_THREAD_SPIN				4096
+
 namespace SNES
 {
 #include "bapu/dsp/blargg_endian.h"
@@ -227,6 +245,34 @@ namespace spc
 	static uint32		ratio_denominator = APU_DENOMINATOR_NTSC;
 }
 
+namespace spcthread
+{
+	struct Job
+	{
+		int32	clocks;
+		int16	port;		// -1 if the job doesn't write one
+		uint8	data;
+		bool8	dsp_sync;
+	};
+
+	static pthread_t		thread;
+	static pthread_mutex_t	mutex = PTHREAD_MUTEX_INITIALIZER;
+	static pthread_cond_t	cond = PTHREAD_COND_INITIALIZER;
+	static bool8			started = FALSE;
+	static std::atomic<bool>	sleeping(false);
+
+	static Job				queue[APU_THREAD_QUEUE_SIZE];
+	static std::atomic<uint32>	head(0);
+	static std::atomic<uint32>	tail(0);
+
+	static bool8			lockstep = FALSE;
+	static int				lockstep_frames = 0;
+	static uint32			frame_syncs = 0;
+	static int				lines = 0;
+
+	static SAPUThreadStats	stats;
+}
+
 static void EightBitize (uint8 *, int);
 static void DeStereo (uint8 *, int);
 static void ReverseStereo (uint8 *, int);
@@ -234,6 +280,13 @@ static void UpdatePlaybackRate (void);
 static void SPCSnapshotCallback (void);
 static inline int S9xAPUGetClock (int32);
 static inline int S9xAPUGetClockRemainder (int32);
+static void * APUThreadFunc (void *);
+static bool8 StartAPUThread (void);
+static inline bool8 APUThreaded (void);
+static void QueueAPUJob (int32, int, uint8, bool8);
+static void DrainAPUQueue (void);
+static void APUThreadEndFrame (void);
+static inline int32 TakeAPUClocks (void);
 
 
 static void EightBitize (uint8 *buffer, int sample_count)
@@ -372,6 +425,8 @@ void S9xFinalizeSamples (void)
 
 void S9xLandSamples (void)
 {
+	S9xAPUWaitForThread();
+
 	if (spc::sa_callback != NULL)
 		spc::sa_callback(spc::extra_data);
 	else
@@ -419,6 +474,8 @@ bool8 S9xInitSound (int buffer_ms, int lag_ms)
 	// buffer_ms : buffer size given in millisecond
 	// lag_ms    : allowable time-lag given in millisecond
 
+	S9xAPUWaitForThread();
+
 	int	sample_count     = buffer_ms * 32000 / 1000;
 	int	lag_sample_count = lag_ms    * 32000 / 1000;
 
@@ -469,6 +526,7 @@ bool8 S9xInitSound (int buffer_ms, int lag_ms)
 
 void S9xSetSoundControl (uint8 voice_switch)
 {
+	S9xAPUWaitForThread();
 	SNES::dsp.spc_dsp.set_stereo_switch (voice_switch << 8 | voice_switch);
 }
 
@@ -481,6 +539,7 @@ void S9xSetSoundControl (uint8 voice_switch)
 
 void S9xDumpSPCSnapshot (void)
 {
+	S9xAPUWaitForThread();
 	SNES::dsp.spc_dsp.dump_spc_snapshot();
 
 }
@@ -502,6 +561,8 @@ bool8 S9xInitAPU (void)
 
 void S9xDeinitAPU (void)
 {
+	S9xAPUWaitForThread();
+
 	if (spc::resampler)
 	{
 		delete spc::resampler;
@@ -533,14 +594,204 @@ static inline int S9xAPUGetClockRemainder (int32 cpucycles)
 			spc::ratio_denominator;
 }
 
+static void * APUThreadFunc (void *)
+{
+	for (;;)
+	{
+		uint32	t = spcthread::tail.load(std::memory_order_relaxed);
+
+		for (int spin = 0; t == spcthread::head.load(std::memory_order_acquire); spin++)
+		{
+			if (spin < APU_THREAD_SPIN)
+				continue;
+
+			pthread_mutex_lock(&spcthread::mutex);
+			spcthread::sleeping = true;
+			while (t == spcthread::head.load())
+				pthread_cond_wait(&spcthread::cond, &spcthread::mutex);
+			spcthread::sleeping = false;
+			pthread_mutex_unlock(&spcthread::mutex);
+		}
+
+		const spcthread::Job	&job = spcthread::queue[t & (APU_THREAD_QUEUE_SIZE - 1)];
+
+		SNES::smp.clock -= job.clocks;
+		SNES::smp.enter ();
+
+		if (job.port >= 0)
+			SNES::cpu.port_write (job.port, job.data);
+
+		if (job.dsp_sync)
+			SNES::dsp.synchronize();
+
+		spcthread::tail.store(t + 1, std::memory_order_release);
+	}
+
+	return (NULL);
+}
+
+static bool8 StartAPUThread (void)
+{
+	if (spcthread::started)
+		return (TRUE);
+
+	// With one core every sync would be a context switch
+	if (sysconf(_SC_NPROCESSORS_ONLN) < 2)
+	{
+		S9xMessage(S9X_INFO, S9X_DEBUG_OUTPUT, "Threaded APU needs more than one CPU, staying in lockstep");
+		Settings.ThreadedAPU = FALSE;
+		return (FALSE);
+	}
+
+	pthread_attr_t	attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	spcthread::started = pthread_create(&spcthread::thread, &attr, APUThreadFunc, NULL) == 0;
+	pthread_attr_destroy(&attr);
+
+	if (!spcthread::started)
+	{
+		S9xMessage(S9X_WARNING, S9X_DEBUG_OUTPUT, "Unable to start APU thread");
+		Settings.ThreadedAPU = FALSE;
+	}
+
+	return (spcthread::started);
+}
+
+static inline bool8 APUThreaded (void)
+{
+	return (Settings.ThreadedAPU && !spcthread::lockstep && StartAPUThread());
+}
+
+static void QueueAPUJob (int32 clocks, int port, uint8 data, bool8 dsp_sync)
+{
+	uint32	h = spcthread::head.load(std::memory_order_relaxed);
+
+	if (h - spcthread::tail.load(std::memory_order_acquire) >= APU_THREAD_QUEUE_SIZE)
+	{
+		spcthread::stats.QueueFull++;
+		DrainAPUQueue();
+	}
+
+	spcthread::Job	&job = spcthread::queue[h & (APU_THREAD_QUEUE_SIZE - 1)];
+	job.clocks   = clocks;
+	job.port     = port;
+	job.data     = data;
+	job.dsp_sync = dsp_sync;
+
+	spcthread::head.store(h + 1);
+
+	if (spcthread::sleeping.load())
+	{
+		pthread_mutex_lock(&spcthread::mutex);
+		pthread_cond_signal(&spcthread::cond);
+		pthread_mutex_unlock(&spcthread::mutex);
+	}
+}
+
+static void DrainAPUQueue (void)
+{
+	uint32	h = spcthread::head.load(std::memory_order_relaxed);
+
+	for (int spin = 0; spcthread::tail.load(std::memory_order_acquire) != h; spin++)
+	{
+		if (spin >= APU_THREAD_SPIN)
+			sched_yield();
+	}
+}
+
+void S9xAPUWaitForThread (void)
+{
+	// The DSP's key-on SPC dump runs on the worker itself
+	if (spcthread::started && !pthread_equal(pthread_self(), spcthread::thread))
+		DrainAPUQueue();
+}
+
+static void APUThreadEndFrame (void)
+{
+	if (!Settings.ThreadedAPU)
+		return;
+
+	if (spcthread::lockstep)
+	{
+		spcthread::stats.LockstepFrames++;
+		if (--spcthread::lockstep_frames <= 0)
+			spcthread::lockstep = FALSE;
+	}
+	else
+	{
+		spcthread::stats.Frames++;
+		if (spcthread::frame_syncs > APU_THREAD_LOCKSTEP_SYNCS)
+		{
+			S9xAPUWaitForThread();
+			spcthread::lockstep = TRUE;
+			spcthread::lockstep_frames = APU_THREAD_LOCKSTEP_FRAMES;
+		}
+	}
+
+	spcthread::frame_syncs = 0;
+}
+
+const SAPUThreadStats & S9xAPUGetThreadStats (void)
+{
+	return (spcthread::stats);
+}
+
+void S9xAPUReportThreadStats (void)
+{
+	const SAPUThreadStats	&stats = spcthread::stats;
+	uint32					frames = stats.Frames + stats.LockstepFrames;
+	char					buf[256];
+
+	if (!frames)
+		return;
+
+	sprintf(buf, "%s: threaded APU ran %u of %u frames, %u port reads, %u syncs (%.1f per threaded frame), %u lookahead stalls",
+		Memory.ROMName, stats.Frames, frames, stats.PortReads, stats.Syncs,
+		stats.Frames ? (double) stats.Syncs / stats.Frames : 0.0, stats.QueueFull);
+	S9xMessage(S9X_INFO, S9X_DEBUG_OUTPUT, buf);
+}
+
+static inline int32 TakeAPUClocks (void)
+{
+	int32	clocks = S9xAPUGetClock(CPU.Cycles);
+
+	spc::remainder = S9xAPUGetClockRemainder(CPU.Cycles);
+	S9xAPUSetReferenceTime(CPU.Cycles);
+
+	return (clocks);
+}
+
 uint8 S9xAPUReadPort (int port)
 {
+	if (APUThreaded())
+	{
+		int32	clocks = TakeAPUClocks();
+
+		spcthread::stats.PortReads++;
+		if (clocks || spcthread::head.load(std::memory_order_relaxed) != spcthread::tail.load(std::memory_order_acquire))
+		{
+			QueueAPUJob(clocks, -1, 0, FALSE);
+			DrainAPUQueue();
+			spcthread::stats.Syncs++;
+			spcthread::frame_syncs++;
+		}
+
+		return ((uint8) SNES::smp.port_read (port & 3));
+	}
+
 	S9xAPUExecute ();
 	return ((uint8) SNES::smp.port_read (port & 3));
 }
 
 void S9xAPUWritePort (int port, uint8 byte)
 {
+	if (APUThreaded())
+	{
+		QueueAPUJob(TakeAPUClocks(), port & 3, byte, FALSE);
+		return;
+	}
+
 	S9xAPUExecute ();
 	SNES::cpu.port_write (port & 3, byte);
 }
@@ -552,6 +803,14 @@ void S9xAPUSetReferenceTime (int32 cpucycles)
 
 void S9xAPUExecute (void)
 {
+	if (APUThreaded())
+	{
+		QueueAPUJob(TakeAPUClocks(), -1, 0, FALSE);
+		return;
+	}
+
+	S9xAPUWaitForThread();
+
 	SNES::smp.clock -= S9xAPUGetClock (CPU.Cycles);
 	SNES::smp.enter ();
 
@@ -562,8 +821,25 @@ void S9xAPUExecute (void)
 
 void S9xAPUEndScanline (void)
 {
-	S9xAPUExecute();
-	SNES::dsp.synchronize();
+	if (CPU.V_Counter == 0)
+		APUThreadEndFrame();
+
+	if (APUThreaded())
+	{
+		QueueAPUJob(TakeAPUClocks(), -1, 0, TRUE);
+
+		// Only look at the DSP output every few lines, that needs the worker idle
+		if (++spcthread::lines < APU_THREAD_LAND_LINES && spc::sound_in_sync)
+			return;
+
+		spcthread::lines = 0;
+		DrainAPUQueue();
+	}
+	else
+	{
+		S9xAPUExecute();
+		SNES::dsp.synchronize();
+	}
 
 	if (SNES::dsp.spc_dsp.sample_count() >= APU_MINIMUM_SAMPLE_BLOCK || !spc::sound_in_sync)
 		S9xLandSamples();
@@ -585,6 +861,12 @@ void S9xAPUTimingSetSpeedup (int ticks)
 
 void S9xResetAPU (void)
 {
+	S9xAPUWaitForThread();
+	memset(&spcthread::stats, 0, sizeof(spcthread::stats));
+	spcthread::lockstep = FALSE;
+	spcthread::frame_syncs = 0;
+	spcthread::lines = 0;
+
 	spc::reference_time = 0;
 	spc::remainder = 0;
 
@@ -600,6 +882,8 @@ void S9xResetAPU (void)
 
 void S9xSoftResetAPU (void)
 {
+	S9xAPUWaitForThread();
+
 	spc::reference_time = 0;
 	spc::remainder = 0;
 	SNES::cpu.reset ();
@@ -614,6 +898,8 @@ void S9xAPUSaveState (uint8 *block)
 {
 	uint8	*ptr = block;
 
+	S9xAPUWaitForThread();
+
 	SNES::smp.save_state (&ptr);
 	SNES::dsp.save_state (&ptr);
 
@@ -630,6 +916,8 @@ void S9xAPULoadState (uint8 *block)
 {
 	uint8	*ptr = block;
 
+	S9xAPUWaitForThread();
+
 	SNES::smp.load_state (&ptr);
 	SNES::dsp.load_state (&ptr);
 
@@ -654,6 +942,8 @@ void S9xAPULoadBlarggState(uint8 *oldblock)
 {
     uint8	*ptr = oldblock;
 
+    S9xAPUWaitForThread();
+
     SNES::SPC_State_Copier copier(&ptr,to_var_from_buf);
 
     copier.copy(SNES::smp.apuram,0x10000); // RAM
@@ -760,6 +1050,8 @@ bool8 S9xSPCDump (const char *filename)
 	uint8	buf[SPC_FILE_SIZE];
 	size_t	ignore;
 
+	S9xAPUWaitForThread();
+
 	fs = fopen(filename, "wb");
 	if (!fs)
 		return (FALSE);
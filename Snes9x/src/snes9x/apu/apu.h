@@ -183,6 +183,16 @@
 
 typedef void (*apu_callback) (void *);
 
+// Counters for Settings.ThreadedAPU, cleared by S9xResetAPU()
+struct SAPUThreadStats
+{
+	uint32	Frames;			// frames with the SMP on its own thread
+	uint32	LockstepFrames;	// frames dropped back to lockstep after heavy polling
+	uint32	PortReads;		// $2140-$2143 reads
+	uint32	Syncs;			// reads that had to hand off to the SMP thread and wait
+	uint32	QueueFull;		// CPU stalls on the lookahead limit
+};
+
 #define SPC_SAVE_STATE_BLOCK_SIZE (1024 * 65)
 #define SPC_FILE_SIZE             (66048)
 
@@ -200,6 +210,9 @@ void S9xAPUAllowTimeOverflow (bool);
 void S9xAPULoadState (uint8 *);
 void S9xAPULoadBlarggState(uint8 *oldblock);
 void S9xAPUSaveState (uint8 *);
+void S9xAPUWaitForThread (void);
+const SAPUThreadStats & S9xAPUGetThreadStats (void);
+void S9xAPUReportThreadStats (void);
 void S9xDumpSPCSnapshot (void);
 bool8 S9xSPCDump (const char *);
 
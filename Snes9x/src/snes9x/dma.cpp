@@ -180,7 +180,7 @@
 #include "memmap.h"
 #include "dma.h"
 #include "apu/apu.h"
-#include "sdd1emu.h"
+#include "sdd1.h"
 #include "spc7110emu.h"
 #ifdef DEBUGGER
 #include "missing.h"
@@ -316,7 +316,7 @@ bool8 S9xDoDMA (uint8 Channel)
 			if (in_ptr)
 			{
 				in_ptr += d->AAddress;
-				SDD1_decompress(sdd1_decode_buffer, in_ptr, d->TransferBytes);
+				S9xSDD1Decompress(sdd1_decode_buffer, in_ptr, d->TransferBytes);
 			}
 		#ifdef DEBUGGER
 			else
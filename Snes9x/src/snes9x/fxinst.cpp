@@ -369,10 +369,14 @@ static void fx_bvs (void)
 	{ \
 		GSU.avReg[(reg)] = SREG; \
 		CLRFLAGS; \
+		R15++; \
 	} \
 	else \
+	{ \
 		GSU.pvDreg = &GSU.avReg[reg]; \
-	R15++
+		R15++; \
+		FX_PREFIX_STEP; \
+	}
 
 #define FX_TO_R14(reg) \
 	if (TF(B)) \
@@ -380,10 +384,14 @@ static void fx_bvs (void)
 		GSU.avReg[(reg)] = SREG; \
 		CLRFLAGS; \
 		READR14; \
+		R15++; \
 	} \
 	else \
+	{ \
 		GSU.pvDreg = &GSU.avReg[reg]; \
-	R15++
+		R15++; \
+		FX_PREFIX_STEP; \
+	}
 
 #define FX_TO_R15(reg) \
 	if (TF(B)) \
@@ -395,6 +403,7 @@ static void fx_bvs (void)
 	{ \
 		GSU.pvDreg = &GSU.avReg[reg]; \
 		R15++; \
+		FX_PREFIX_STEP; \
 	}
 
 static void fx_to_r0 (void)
@@ -481,7 +490,8 @@ static void fx_to_r15 (void)
 #define FX_WITH(reg) \
 	SF(B); \
 	GSU.pvSreg = GSU.pvDreg = &GSU.avReg[reg]; \
-	R15++
+	R15++; \
+	FX_PREFIX_STEP
 
 static void fx_with_r0 (void)
 {
@@ -715,6 +725,7 @@ static void fx_alt1 (void)
 	SF(ALT1);
 	CF(B);
 	R15++;
+	FX_PREFIX_STEP;
 }
 
 // 3e - alt2 - set alt2 mode
@@ -723,6 +734,7 @@ static void fx_alt2 (void)
 	SF(ALT2);
 	CF(B);
 	R15++;
+	FX_PREFIX_STEP;
 }
 
 // 3f - alt3 - set alt3 mode
@@ -732,6 +744,7 @@ static void fx_alt3 (void)
 	SF(ALT2);
 	CF(B);
 	R15++;
+	FX_PREFIX_STEP;
 }
 
 // 40-4b - ldw (rn) - load word from RAM
@@ -3143,6 +3156,7 @@ static void fx_sms_r15 (void)
 	{ \
 		GSU.pvSreg = &GSU.avReg[reg]; \
 		R15++; \
+		FX_PREFIX_STEP; \
 	}
 
 static void fx_from_r0 (void)
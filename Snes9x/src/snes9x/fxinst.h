@@ -303,6 +303,10 @@
 // Emulate proper R14 ROM access (slower, but safer)
 #define FX_DO_ROMBUFFER
 
+// Run the instruction following an alt/to/with/from prefix from inside the prefix
+// (undefine to step every prefix through fx_run like the reference interpreter)
+#define FX_FUSE_PREFIXES
+
 // Address checking (definately slow)
 //#define FX_ADDRESS_CHECK
 
@@ -534,6 +538,22 @@ extern struct FxRegs_s	GSU;
 	(*fx_OpcodeTable[(GSU.vStatusReg & 0x300) | vOpcode])(); \
 }
 
+#ifdef FX_FUSE_PREFIXES
+
+// Execute the instruction a prefix applies to without going back to the run loop
+#define FX_PREFIX_STEP \
+	if (GSU.vCounter) \
+	{ \
+		GSU.vCounter--; \
+		FX_STEP; \
+	}
+
+#else
+
+#define FX_PREFIX_STEP
+
+#endif
+
 extern void (*fx_PlotTable[]) (void);
 extern void (*fx_OpcodeTable[]) (void);
 
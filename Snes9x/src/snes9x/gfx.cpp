@@ -176,6 +176,8 @@
  ***********************************************************************************/
 
 
+#include <pthread.h>
+#include <atomic>
 #include "snes9x.h"
 #include "ppu.h"
 #include "tile.h"
@@ -206,10 +208,32 @@ static void DrawBackgroundOffsetMosaic (int, uint8, uint8, int);
 static inline void DrawBackgroundMode7 (int, void (*DrawMath) (uint32, uint32, int), void (*DrawNomath) (uint32, uint32, int), int);
 static inline void DrawBackdrop (void);
 static inline void RenderScreen (bool8);
+static void DrawScreenLines (void);
+static void QueueScreenLines (void);
 static uint16 get_crosshair_color (uint8);
 
 #define TILE_PLUS(t, x)	(((t) & 0xfc00) | ((t + x) & 0x3ff))
 
+// With Settings.ThreadedRendering, RenderLine() hands finished lines to a worker
+// thread in batches of this many while the CPU carries on with the frame. The
+// worker only ever runs while the PPU state it reads is frozen: every write that
+// could change it goes through FLUSH_REDRAW() or a VRAM port, and those wait for
+// the batch first. A mid-frame VRAM write also gets the lines before it drawn,
+// so they show the old data whatever the batching was. That wait is also what
+// limits the gain: a game writing PPU registers every few lines (HDMA colour or
+// scroll effects) keeps the CPU waiting on the worker and gets no overlap.
+#define RENDER_THREAD_BATCH_LINES	16
+
+static pthread_t		RenderThread;
+static pthread_mutex_t	RenderMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	RenderCond = PTHREAD_COND_INITIALIZER;
+static bool8			RenderThreadStarted = FALSE;
+static std::atomic<bool>	RenderJobQueued(false);
+
+// The last line of the previous S9xUpdateScreen(), kept apart from GFX.EndY so
+// the RTO flags don't depend on how the lines were batched
+static uint32	FlushEndY = 0;
+
 
 bool8 S9xGraphicsInit (void)
 {
@@ -383,7 +407,7 @@ void S9xStartScreenRefresh (void)
 
 		PPU.MosaicStart = 0;
 		PPU.RecomputeClipWindows = TRUE;
-		IPPU.PreviousLine = IPPU.CurrentLine = 0;
+		IPPU.PreviousLine = IPPU.CurrentLine = IPPU.DrawnLine = 0;
 
 		memset(GFX.ZBuffer, 0, GFX.ScreenSize);
 		memset(GFX.SubZBuffer, 0, GFX.ScreenSize);
@@ -394,6 +418,13 @@ void S9xStartScreenRefresh (void)
 		IPPU.DisplayedRenderedFrameCount = IPPU.RenderedFramesCount;
 		IPPU.RenderedFramesCount = 0;
 		IPPU.FrameCount = 0;
+
+	#ifdef TILE_CACHE_STATS
+		char	buf[64];
+		sprintf(buf, "Tile cache: %u hits, %u misses", IPPU.TileCacheHits, IPPU.TileCacheMisses);
+		S9xMessage(S9X_INFO, S9X_DEBUG_OUTPUT, buf);
+		IPPU.TileCacheHits = IPPU.TileCacheMisses = 0;
+	#endif
 	}
 
 	/*if (GFX.InfoStringTimeout > 0 && --GFX.InfoStringTimeout == 0)
@@ -504,6 +535,9 @@ void RenderLine (uint8 C)
 		}
 
 		IPPU.CurrentLine = C + 1;
+
+		if (Settings.ThreadedRendering && IPPU.CurrentLine - IPPU.DrawnLine >= RENDER_THREAD_BATCH_LINES)
+			QueueScreenLines();
 	}
 	else
 	{
@@ -649,12 +683,25 @@ void S9xUpdateScreen (void)
 		SetupOBJ();
 
 	// XXX: Check ForceBlank? Or anything else?
-	PPU.RangeTimeOver |= GFX.OBJLines[GFX.EndY].RTOFlags;
+	PPU.RangeTimeOver |= GFX.OBJLines[FlushEndY].RTOFlags;
 
-	GFX.StartY = IPPU.PreviousLine;
-	if ((GFX.EndY = IPPU.CurrentLine - 1) >= PPU.ScreenHeight)
-		GFX.EndY = PPU.ScreenHeight - 1;
+	if ((FlushEndY = IPPU.CurrentLine - 1) >= PPU.ScreenHeight)
+		FlushEndY = PPU.ScreenHeight - 1;
 
+	IPPU.PreviousLine = IPPU.CurrentLine;
+
+	// The render thread may already have drawn everything up to here
+	if (IPPU.DrawnLine != IPPU.CurrentLine)
+	{
+		GFX.StartY = IPPU.DrawnLine;
+		GFX.EndY = FlushEndY;
+		IPPU.DrawnLine = IPPU.CurrentLine;
+		DrawScreenLines();
+	}
+}
+
+static void DrawScreenLines (void)
+{
 	if (!PPU.ForcedBlanking)
 	{
 		// If force blank, may as well completely skip all this. We only did
@@ -742,8 +789,98 @@ void S9xUpdateScreen (void)
 			for (int x = 0; x < IPPU.RenderedScreenWidth; x++)
 				GFX.S[x] = black;
 	}
+}
+
+static void * RenderThreadFunc (void *)
+{
+	pthread_mutex_lock(&RenderMutex);
+
+	for (;;)
+	{
+		while (!RenderJobQueued)
+			pthread_cond_wait(&RenderCond, &RenderMutex);
+
+		pthread_mutex_unlock(&RenderMutex);
+		DrawScreenLines();
+		pthread_mutex_lock(&RenderMutex);
+
+		RenderJobQueued = false;
+		pthread_cond_broadcast(&RenderCond);
+	}
 
-	IPPU.PreviousLine = IPPU.CurrentLine;
+	return (NULL);
+}
+
+static void SetupPendingLines (void)
+{
+	if (IPPU.OBJChanged || IPPU.InterlaceOBJ)
+		SetupOBJ();
+
+	GFX.StartY = IPPU.DrawnLine;
+	if ((GFX.EndY = IPPU.CurrentLine - 1) >= PPU.ScreenHeight)
+		GFX.EndY = PPU.ScreenHeight - 1;
+	IPPU.DrawnLine = IPPU.CurrentLine;
+}
+
+static void QueueScreenLines (void)
+{
+	if (GFX.RenderThreadBusy)
+	{
+		// Keep collecting lines until the last batch is done
+		if (RenderJobQueued.load(std::memory_order_acquire))
+			return;
+
+		GFX.RenderThreadBusy = FALSE;
+	}
+
+	if (!RenderThreadStarted)
+	{
+		pthread_attr_t	attr;
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+		RenderThreadStarted = pthread_create(&RenderThread, &attr, RenderThreadFunc, NULL) == 0;
+		pthread_attr_destroy(&attr);
+
+		if (!RenderThreadStarted)
+		{
+			S9xMessage(S9X_WARNING, S9X_DEBUG_OUTPUT, "Unable to start render thread");
+			Settings.ThreadedRendering = FALSE;
+			return;
+		}
+	}
+
+	SetupPendingLines();
+
+	pthread_mutex_lock(&RenderMutex);
+	RenderJobQueued = true;
+	pthread_cond_broadcast(&RenderCond);
+	pthread_mutex_unlock(&RenderMutex);
+
+	GFX.RenderThreadBusy = TRUE;
+}
+
+void S9xWaitForRenderThread (void)
+{
+	pthread_mutex_lock(&RenderMutex);
+	while (RenderJobQueued)
+		pthread_cond_wait(&RenderCond, &RenderMutex);
+	pthread_mutex_unlock(&RenderMutex);
+
+	GFX.RenderThreadBusy = FALSE;
+}
+
+void S9xDrawPendingLines (void)
+{
+	// Lines RenderLine() has passed but not yet queued are drawn now, so that
+	// how the frame happened to be batched can't decide what a VRAM write hits
+	if (GFX.RenderThreadBusy)
+		S9xWaitForRenderThread();
+
+	if (IPPU.DrawnLine != IPPU.CurrentLine)
+	{
+		SetupPendingLines();
+		DrawScreenLines();
+	}
 }
 
 static void SetupOBJ (void)
@@ -1110,7 +1247,7 @@ static void DrawBackground (int bg, uint8 Zh, uint8 Zl)
 			uint32	HOffset = GFX.LineData[Y].BG[bg].HOffset;
 			int		VirtAlign = ((Y2 + VOffset) & 7) >> (HiresInterlace ? 1 : 0);
 
-			for (Lines = 1; Lines < GFX.LinesPerTile - VirtAlign; Lines++)
+			for (Lines = 1; Lines < GFX.LinesPerTile - VirtAlign && Y + Lines <= GFX.EndY; Lines++)
 			{
 				if ((VOffset != GFX.LineData[Y + Lines].BG[bg].VOffset) || (HOffset != GFX.LineData[Y + Lines].BG[bg].HOffset))
 					break;
@@ -1304,10 +1441,10 @@ static void DrawBackgroundMosaic (int bg, uint8 Zh, uint8 Zl)
 
 	void (*DrawPix) (uint32, uint32, uint32, uint32, uint32, uint32);
 
-	int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
-
 	for (int clip = 0; clip < GFX.Clip[bg].Count; clip++)
 	{
+		int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
+
 		GFX.ClipColors = !(GFX.Clip[bg].DrawMode[clip] & 1);
 
 		if (BG.EnableMath && (GFX.Clip[bg].DrawMode[clip] & 2))
@@ -1716,10 +1853,10 @@ static void DrawBackgroundOffsetMosaic (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 
 	void (*DrawPix) (uint32, uint32, uint32, uint32, uint32, uint32);
 
-	int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
-
 	for (int clip = 0; clip < GFX.Clip[bg].Count; clip++)
 	{
+		int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
+
 		GFX.ClipColors = !(GFX.Clip[bg].DrawMode[clip] & 1);
 
 		if (BG.EnableMath && (GFX.Clip[bg].DrawMode[clip] & 2))
@@ -220,6 +220,7 @@ struct SGFX
 	uint32	StartY;
 	uint32	EndY;
 	bool8	ClipColors;
+	bool8	RenderThreadBusy;	// lines have been handed to the render thread and may still be drawing
 	uint8	OBJWidths[128];
 	uint8	OBJVisibleTiles[128];
 	struct SLineData		LineData[240];
@@ -344,6 +345,8 @@ inline uint16 COLOR_SUB (uint16 C1, uint16 C2)
 void S9xStartScreenRefresh (void);
 void S9xEndScreenRefresh (void);
 void S9xUpdateScreen (void);
+void S9xWaitForRenderThread (void);
+void S9xDrawPendingLines (void);
 void S9xBuildDirectColourMaps (void);
 void RenderLine (uint8);
 void S9xComputeClipWindows (void);
@@ -651,10 +651,15 @@ void S9xSetPPU (uint8 Byte, uint16 Address)
 				break;
 
 			case 0x2118: // VMDATAL
+				// VRAM writes don't flush, but lines already passed must not see them
+				if (Settings.ThreadedRendering)
+					S9xDrawPendingLines();
 				REGISTER_2118(Byte);
 				break;
 
 			case 0x2119: // VMDATAH
+				if (Settings.ThreadedRendering)
+					S9xDrawPendingLines();
 				REGISTER_2119(Byte);
 				break;
 
@@ -1969,6 +1974,7 @@ void S9xSoftResetPPU (void)
 	IPPU.DoubleHeightPixels = FALSE;
 	IPPU.CurrentLine = 0;
 	IPPU.PreviousLine = 0;
+	IPPU.DrawnLine = 0;
 	IPPU.XB = NULL;
 	for (int c = 0; c < 256; c++)
 		IPPU.ScreenColors[c] = c;
@@ -222,6 +222,7 @@ struct InternalPPU
 	bool8	DoubleHeightPixels;
 	int		CurrentLine;
 	int		PreviousLine;
+	int		DrawnLine;
 	const uint8	*XB;
 	uint32	Red[256];
 	uint32	Green[256];
@@ -237,6 +238,10 @@ struct InternalPPU
 	uint32	TotalEmulatedFrames;
 	uint32	SkippedFrames;
 	uint32	FrameSkip;
+#ifdef TILE_CACHE_STATS
+	uint32	TileCacheHits;
+	uint32	TileCacheMisses;
+#endif
 };
 
 struct SOBJ
@@ -404,6 +409,9 @@ extern const SnesModel	M2SNES;
 
 static inline void FLUSH_REDRAW (void)
 {
+	if (GFX.RenderThreadBusy)
+		S9xWaitForRenderThread();
+
 	if (IPPU.PreviousLine != IPPU.CurrentLine)
 		S9xUpdateScreen();
 }
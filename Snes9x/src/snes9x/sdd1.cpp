@@ -176,11 +176,22 @@
  ***********************************************************************************/
 
 
+#include <map>
+#include <vector>
 #include "snes9x.h"
 #include "memmap.h"
 #include "sdd1.h"
+#include "sdd1emu.h"
 #include "display.h"
 
+// Upper bound on the decompressed data kept by Settings.DecompressionCache
+#define SDD1_CACHE_LIMIT	(16 * 1024 * 1024)
+
+// Streams are keyed by where they start in ROM. The decoder only ever reads forward,
+// so the first bytes of a longer transfer are valid for any shorter one.
+static std::map<const uint8 *, std::vector<uint8> >	SDD1Cache;
+static uint32	SDD1CacheSize = 0;
+
 
 void S9xSetSDD1MemoryMap (uint32 bank, uint32 value)
 {
@@ -197,6 +208,9 @@ void S9xSetSDD1MemoryMap (uint32 bank, uint32 value)
 
 void S9xResetSDD1 (void)
 {
+	SDD1Cache.clear();
+	SDD1CacheSize = 0;
+
 	memset(&Memory.FillRAM[0x4800], 0, 4);
 	for (int i = 0; i < 4; i++)
 	{
@@ -210,3 +224,44 @@ void S9xSDD1PostLoadState (void)
 	for (int i = 0; i < 4; i++)
 		S9xSetSDD1MemoryMap(i, Memory.FillRAM[0x4804 + i]);
 }
+
+void S9xSDD1Decompress (uint8 *out, uint8 *in, int len)
+{
+	if (len == 0)
+		len = 0x10000;
+
+	if (!Settings.DecompressionCache || in < Memory.ROM || in >= Memory.ROM + Memory.CalculatedSize)
+	{
+		SDD1_decompress(out, in, len);
+		return;
+	}
+
+	std::vector<uint8>	&stream = SDD1Cache[in];
+
+	if (stream.size() >= (size_t) len)
+	{
+		if (!Settings.DecompressionCacheCheck)
+		{
+			memcpy(out, &stream[0], len);
+			return;
+		}
+
+		SDD1_decompress(out, in, len);
+		if (memcmp(out, &stream[0], len))
+		{
+			char	buf[64];
+			sprintf(buf, "S-DD1: cached stream at $%06X differs", (int) (in - Memory.ROM));
+			S9xMessage(S9X_ERROR, S9X_DEBUG_OUTPUT, buf);
+		}
+
+		return;
+	}
+
+	SDD1_decompress(out, in, len);
+
+	if (SDD1CacheSize - stream.size() + len <= SDD1_CACHE_LIMIT)
+	{
+		SDD1CacheSize = SDD1CacheSize - stream.size() + len;
+		stream.assign(out, out + len);
+	}
+}
@@ -182,5 +182,6 @@
 void S9xSetSDD1MemoryMap (uint32, uint32);
 void S9xResetSDD1 (void);
 void S9xSDD1PostLoadState (void);
+void S9xSDD1Decompress (uint8 *, uint8 *, int);
 
 #endif
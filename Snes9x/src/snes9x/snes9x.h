@@ -363,6 +363,8 @@ struct SSettings
 	bool8	SDD1 = 0;
 	bool8	SPC7110 = 0;
 	bool8	SPC7110RTC = 0;
+	bool8	DecompressionCache = 0;
+	bool8	DecompressionCacheCheck = 0;
 	bool8	OBC1 = 0;
 	uint8	SETA = 0;
 	bool8	SRTC = 0;
@@ -397,11 +399,13 @@ struct SSettings
 	bool8	Stereo = 1;
 	static const bool8	ReverseStereo = 0;
 	static const bool8	Mute = 0;
+	bool8	ThreadedAPU = 0;
 
 	static const bool8	SupportHiRes = 1;
 	static const bool8	Transparency = 1;
 	uint8	BG_Forced = 0;
 	static const bool8	DisableGraphicWindows = 0;
+	bool8	ThreadedRendering = 0;
 
 	static const bool8	DisplayFrameRate = 0;
 	static const bool8	DisplayWatchedAddresses = 0;
@@ -383,6 +383,9 @@ void S9xSPC7110PreSaveState (void)
 	s7snap.rtc_mode  = (int32)  s7emu.rtc_mode;
 	s7snap.rtc_index = (uint32) s7emu.rtc_index;
 
+	// A stream replayed from the cache leaves the decoder behind; catch it up first
+	s7emu.decomp.cache_sync();
+
 	s7snap.decomp_mode   = (uint32) s7emu.decomp.decomp_mode;
 	s7snap.decomp_offset = (uint32) s7emu.decomp.decomp_offset;
 
@@ -464,6 +467,7 @@ void S9xSPC7110PostLoadState (int version)
 	s7emu.rtc_mode  = (SPC7110::RTC_Mode)  s7snap.rtc_mode;
 	s7emu.rtc_index = (unsigned)           s7snap.rtc_index;
 
+	s7emu.decomp.cache_stream  = NULL;
 	s7emu.decomp.decomp_mode   = (unsigned) s7snap.decomp_mode;
 	s7emu.decomp.decomp_offset = (unsigned) s7snap.decomp_offset;
 
@@ -19,6 +19,34 @@
 #ifdef _SPC7110EMU_CPP_
 
 uint8 SPC7110Decomp::read() {
+  if(!cache_stream) return live_read();
+
+  std::vector<uint8> &stream = *cache_stream;
+  if(cache_position < stream.size() && !Settings.DecompressionCacheCheck) {
+    //once synced for a snapshot the live decoder has to keep pace with the replay
+    if(cache_live) live_read();
+    return stream[cache_position++];
+  }
+
+  //past the cached data (or verifying it): run the real decoder from here on
+  if(!cache_live) cache_sync();
+
+  uint8 data = live_read();
+  if(cache_position < stream.size()) {
+    if(data != stream[cache_position]) {
+      char buf[64];
+      sprintf(buf, "SPC7110: cached stream at $%06X differs", cache_offset);
+      S9xMessage(S9X_ERROR, S9X_DEBUG_OUTPUT, buf);
+    }
+  } else if(cache_size < cache_limit) {
+    stream.push_back(data);
+    cache_size++;
+  }
+  cache_position++;
+  return data;
+}
+
+uint8 SPC7110Decomp::live_read() {
   if(decomp_buffer_length == 0) {
     //decompress at least (decomp_buffer_size / 2) bytes to the buffer
     switch(decomp_mode) {
@@ -48,6 +76,46 @@ uint8 SPC7110Decomp::dataread() {
 }
 
 void SPC7110Decomp::init(unsigned mode, unsigned offset, unsigned index) {
+  if(Settings.DecompressionCache && mode < 3) {
+    decomp_mode = mode;
+    decomp_offset = offset;
+    cache_offset = offset;
+    cache_stream = &cache[(mode << 24) | offset];
+    cache_position = 0;
+    cache_live = false;
+
+    //skip straight to the requested index when the stream is already known
+    if(!Settings.DecompressionCacheCheck) {
+      cache_position = index < cache_stream->size() ? index : cache_stream->size();
+      index -= cache_position;
+    }
+    while(index--) read();
+    return;
+  }
+
+  cache_stream = 0;
+  live_init(mode, offset);
+
+  //decompress up to requested output data index
+  while(index--) live_read();
+}
+
+//bring the live decoder up to the replay position, so it can take over from the cache
+void SPC7110Decomp::cache_sync() {
+  if(!cache_stream || cache_live) return;
+
+  live_init(decomp_mode, cache_offset);
+  for(unsigned i = 0; i < cache_position; i++) live_read();
+  cache_live = true;
+}
+
+void SPC7110Decomp::cache_clear() {
+  cache.clear();
+  cache_stream = 0;
+  cache_size = 0;
+}
+
+void SPC7110Decomp::live_init(unsigned mode, unsigned offset) {
   decomp_mode = mode;
   decomp_offset = offset;
 
@@ -66,9 +134,6 @@ void SPC7110Decomp::init(unsigned mode, unsigned offset, unsigned index) {
     case 1: mode1(true); break;
     case 2: mode2(true); break;
   }
-
-  //decompress up to requested output data index
-  while(index--) read();
 }
 
 //
@@ -491,6 +556,7 @@ void SPC7110Decomp::reset() {
   //mode 3 is invalid; this is treated as a special case to always return 0x00
   //set to mode 3 so that reading decomp port before starting first decomp will return 0x00
   decomp_mode = 3;
+  cache_clear();
 
   decomp_buffer_rdoffset = 0;
   decomp_buffer_wroffset = 0;
@@ -499,6 +565,9 @@ void SPC7110Decomp::reset() {
 
 SPC7110Decomp::SPC7110Decomp() {
   decomp_buffer = new uint8_t[decomp_buffer_size];
+  cache_offset = 0;
+  cache_position = 0;
+  cache_live = false;
   reset();
 
   //initialize reverse morton lookup tables
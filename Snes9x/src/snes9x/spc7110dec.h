@@ -19,12 +19,31 @@
 #ifndef _SPC7110DEC_H_
 #define _SPC7110DEC_H_
 
+#include <map>
+#include <vector>
+
 class SPC7110Decomp {
 public:
   uint8 read();
   void init(unsigned mode, unsigned offset, unsigned index);
   void reset();
 
+  //Settings.DecompressionCache: streams are keyed by mode and offset, and replayed
+  //from memory once decoded; the live decoder only runs past the cached length
+  enum { cache_limit = 16 * 1024 * 1024 };
+  std::map<unsigned, std::vector<uint8> > cache;
+  std::vector<uint8> *cache_stream;
+  unsigned cache_offset;
+  unsigned cache_position;
+  unsigned cache_size;
+  bool cache_live;
+
+  void cache_sync();
+  void cache_clear();
+
+  uint8 live_read();
+  void live_init(unsigned mode, unsigned offset);
+
   SPC7110Decomp();
   ~SPC7110Decomp();
 
@@ -189,6 +189,16 @@
 #include "ppu.h"
 #include "tile.h"
 
+#ifdef LSB_FIRST
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#define TILE_SIMD
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+#include <arm_neon.h>
+#define TILE_SIMD
+#endif
+#endif
+
 static uint32	pixbit[8][16];
 static uint8	hrbit_odd[256];
 static uint8	hrbit_even[256];
@@ -253,6 +263,248 @@ void S9xInitTileRenderer (void)
 	}
 }
 
+#ifdef TILE_SIMD
+
+// The vector converters treat the bitplanes of a tile row as an 8x8 bit matrix.
+// Each row is gathered into a 64-bit lane with the highest plane in the lowest
+// byte and flipped about its anti-diagonal, which leaves pixel x in byte x with
+// bitplane n in bit n. Two rows fit in a register, so a tile is four flips.
+// The input is the tile as it sits in VRAM: one register per bitplane pair,
+// interleaved by row.
+// Hi-res tiles keep every other pixel of a 16-pixel wide tile pair, so their
+// plane bytes are squeezed to a nibble each and joined before the flip.
+
+#if defined (__SSE2__)
+
+static inline __m128i FlipAntiDiagonal (__m128i x)
+{
+	const __m128i	k1 = _mm_set1_epi64x(0xaa00aa00aa00aa00ULL);
+	const __m128i	k2 = _mm_set1_epi64x(0xcccc0000cccc0000ULL);
+	const __m128i	k4 = _mm_set1_epi64x(0xf0f0f0f00f0f0f0fULL);
+	__m128i			t;
+
+	t = _mm_xor_si128(x, _mm_slli_epi64(x, 36));
+	x = _mm_xor_si128(x, _mm_and_si128(k4, _mm_xor_si128(t, _mm_srli_epi64(x, 36))));
+	t = _mm_and_si128(k2, _mm_xor_si128(x, _mm_slli_epi64(x, 18)));
+	x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_srli_epi64(t, 18)));
+	t = _mm_and_si128(k1, _mm_xor_si128(x, _mm_slli_epi64(x, 9)));
+	x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_srli_epi64(t, 9)));
+
+	return (x);
+}
+
+static inline uint8 ConvertPlanes (uint8 *pCache, const __m128i *planes, int depth)
+{
+	__m128i	l[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		// Swap each plane pair so the higher plane comes first
+		if (i < depth / 2)
+			l[i] = _mm_or_si128(_mm_slli_epi16(planes[i], 8), _mm_srli_epi16(planes[i], 8));
+		else
+			l[i] = _mm_setzero_si128();
+	}
+
+	__m128i	hi_lo = _mm_unpacklo_epi16(l[3], l[2]), hi_hi = _mm_unpackhi_epi16(l[3], l[2]);
+	__m128i	lo_lo = _mm_unpacklo_epi16(l[1], l[0]), lo_hi = _mm_unpackhi_epi16(l[1], l[0]);
+	__m128i	r[4];
+
+	r[0] = FlipAntiDiagonal(_mm_unpacklo_epi32(hi_lo, lo_lo));
+	r[1] = FlipAntiDiagonal(_mm_unpackhi_epi32(hi_lo, lo_lo));
+	r[2] = FlipAntiDiagonal(_mm_unpacklo_epi32(hi_hi, lo_hi));
+	r[3] = FlipAntiDiagonal(_mm_unpackhi_epi32(hi_hi, lo_hi));
+
+	for (int i = 0; i < 4; i++)
+		_mm_storeu_si128((__m128i *) (pCache + i * 16), r[i]);
+
+	__m128i	non_zero = _mm_or_si128(_mm_or_si128(r[0], r[1]), _mm_or_si128(r[2], r[3]));
+
+	return (_mm_movemask_epi8(_mm_cmpeq_epi8(non_zero, _mm_setzero_si128())) != 0xffff ? TRUE : BLANK_TILE);
+}
+
+static inline uint8 ConvertTile (uint8 *pCache, uint32 TileAddr, int depth)
+{
+	__m128i	planes[4];
+
+	for (int i = 0; i < depth / 2; i++)
+		planes[i] = _mm_loadu_si128((const __m128i *) &Memory.VRAM[TileAddr + i * 16]);
+
+	return (ConvertPlanes(pCache, planes, depth));
+}
+
+// Same as the hrbit_odd/even tables: bits 6, 4, 2 and 0 (odd) or 7, 5, 3 and 1
+// (even) of each byte, packed into the low nibble
+
+static inline __m128i SqueezeHires (__m128i v, int even)
+{
+	if (even)
+		v = _mm_srli_epi16(v, 1);
+
+	v = _mm_and_si128(v, _mm_set1_epi8(0x55));
+	v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi16(v, 1)), _mm_set1_epi8(0x33));
+	v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi16(v, 2)), _mm_set1_epi8(0x0f));
+
+	return (v);
+}
+
+static inline uint8 ConvertTileHires (uint8 *pCache, uint32 TileAddr, uint32 Tile, int depth, int even)
+{
+	uint8	*tp1 = &Memory.VRAM[TileAddr], *tp2;
+	int		shift = depth == 2 ? 4 : 5;
+	__m128i	planes[2];
+
+	if (Tile == 0x3ff)
+		tp2 = tp1 - (0x3ff << shift);
+	else
+		tp2 = tp1 + (1 << shift);
+
+	for (int i = 0; i < depth / 2; i++)
+	{
+		__m128i	v1 = SqueezeHires(_mm_loadu_si128((const __m128i *) (tp1 + i * 16)), even);
+		__m128i	v2 = SqueezeHires(_mm_loadu_si128((const __m128i *) (tp2 + i * 16)), even);
+		planes[i] = _mm_or_si128(_mm_slli_epi16(v1, 4), v2);
+	}
+
+	return (ConvertPlanes(pCache, planes, depth));
+}
+
+#else
+
+static inline uint64x2_t FlipAntiDiagonal (uint64x2_t x)
+{
+	const uint64x2_t	k1 = vdupq_n_u64(0xaa00aa00aa00aa00ULL);
+	const uint64x2_t	k2 = vdupq_n_u64(0xcccc0000cccc0000ULL);
+	const uint64x2_t	k4 = vdupq_n_u64(0xf0f0f0f00f0f0f0fULL);
+	uint64x2_t			t;
+
+	t = veorq_u64(x, vshlq_n_u64(x, 36));
+	x = veorq_u64(x, vandq_u64(k4, veorq_u64(t, vshrq_n_u64(x, 36))));
+	t = vandq_u64(k2, veorq_u64(x, vshlq_n_u64(x, 18)));
+	x = veorq_u64(x, veorq_u64(t, vshrq_n_u64(t, 18)));
+	t = vandq_u64(k1, veorq_u64(x, vshlq_n_u64(x, 9)));
+	x = veorq_u64(x, veorq_u64(t, vshrq_n_u64(t, 9)));
+
+	return (x);
+}
+
+static inline uint8 ConvertPlanes (uint8 *pCache, const uint8x16_t *planes, int depth)
+{
+	uint16x8_t	l[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		// Swap each plane pair so the higher plane comes first
+		if (i < depth / 2)
+			l[i] = vreinterpretq_u16_u8(vrev16q_u8(planes[i]));
+		else
+			l[i] = vdupq_n_u16(0);
+	}
+
+	uint16x8x2_t	hi = vzipq_u16(l[3], l[2]);
+	uint16x8x2_t	lo = vzipq_u16(l[1], l[0]);
+	uint32x4x2_t	rows0123 = vzipq_u32(vreinterpretq_u32_u16(hi.val[0]), vreinterpretq_u32_u16(lo.val[0]));
+	uint32x4x2_t	rows4567 = vzipq_u32(vreinterpretq_u32_u16(hi.val[1]), vreinterpretq_u32_u16(lo.val[1]));
+	uint64x2_t		r[4];
+
+	r[0] = FlipAntiDiagonal(vreinterpretq_u64_u32(rows0123.val[0]));
+	r[1] = FlipAntiDiagonal(vreinterpretq_u64_u32(rows0123.val[1]));
+	r[2] = FlipAntiDiagonal(vreinterpretq_u64_u32(rows4567.val[0]));
+	r[3] = FlipAntiDiagonal(vreinterpretq_u64_u32(rows4567.val[1]));
+
+	for (int i = 0; i < 4; i++)
+		vst1q_u8(pCache + i * 16, vreinterpretq_u8_u64(r[i]));
+
+	uint64x2_t	non_zero = vorrq_u64(vorrq_u64(r[0], r[1]), vorrq_u64(r[2], r[3]));
+
+	return ((vgetq_lane_u64(non_zero, 0) | vgetq_lane_u64(non_zero, 1)) ? TRUE : BLANK_TILE);
+}
+
+static inline uint8 ConvertTile (uint8 *pCache, uint32 TileAddr, int depth)
+{
+	uint8x16_t	planes[4];
+
+	for (int i = 0; i < depth / 2; i++)
+		planes[i] = vld1q_u8(&Memory.VRAM[TileAddr + i * 16]);
+
+	return (ConvertPlanes(pCache, planes, depth));
+}
+
+// Same as the hrbit_odd/even tables: bits 6, 4, 2 and 0 (odd) or 7, 5, 3 and 1
+// (even) of each byte, packed into the low nibble
+
+static inline uint8x16_t SqueezeHires (uint8x16_t v, int even)
+{
+	if (even)
+		v = vshrq_n_u8(v, 1);
+
+	v = vandq_u8(v, vdupq_n_u8(0x55));
+	v = vandq_u8(vorrq_u8(v, vshrq_n_u8(v, 1)), vdupq_n_u8(0x33));
+	v = vandq_u8(vorrq_u8(v, vshrq_n_u8(v, 2)), vdupq_n_u8(0x0f));
+
+	return (v);
+}
+
+static inline uint8 ConvertTileHires (uint8 *pCache, uint32 TileAddr, uint32 Tile, int depth, int even)
+{
+	uint8		*tp1 = &Memory.VRAM[TileAddr], *tp2;
+	int			shift = depth == 2 ? 4 : 5;
+	uint8x16_t	planes[2];
+
+	if (Tile == 0x3ff)
+		tp2 = tp1 - (0x3ff << shift);
+	else
+		tp2 = tp1 + (1 << shift);
+
+	for (int i = 0; i < depth / 2; i++)
+	{
+		uint8x16_t	v1 = SqueezeHires(vld1q_u8(tp1 + i * 16), even);
+		uint8x16_t	v2 = SqueezeHires(vld1q_u8(tp2 + i * 16), even);
+		planes[i] = vorrq_u8(vshlq_n_u8(v1, 4), v2);
+	}
+
+	return (ConvertPlanes(pCache, planes, depth));
+}
+
+#endif
+
+static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	return (ConvertTile(pCache, TileAddr, 2));
+}
+
+static uint8 ConvertTile4 (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	return (ConvertTile(pCache, TileAddr, 4));
+}
+
+static uint8 ConvertTile8 (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	return (ConvertTile(pCache, TileAddr, 8));
+}
+
+static uint8 ConvertTile2h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	return (ConvertTileHires(pCache, TileAddr, Tile, 2, FALSE));
+}
+
+static uint8 ConvertTile4h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	return (ConvertTileHires(pCache, TileAddr, Tile, 4, FALSE));
+}
+
+static uint8 ConvertTile2h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	return (ConvertTileHires(pCache, TileAddr, Tile, 2, TRUE));
+}
+
+static uint8 ConvertTile4h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	return (ConvertTileHires(pCache, TileAddr, Tile, 4, TRUE));
+}
+
+#else
+
 // Here are the tile converters, selected by S9xSelectTileConverter().
 // Really, except for the definition of DOBIT and the number of times it is called, they're all the same.
 
@@ -474,6 +726,8 @@ static uint8 ConvertTile4h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 
 #undef DOBIT
 
+#endif
+
 // First-level include: Get all the renderers.
 
 #include "tile.cpp"
@@ -677,6 +931,16 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 #ifndef NAME1 // First-level: Get all the renderers.
 /*****************************************************************************/
 
+#ifdef TILE_CACHE_STATS
+#define COUNT_TILE_FETCH(miss) \
+	if (miss) \
+		IPPU.TileCacheMisses++; \
+	else \
+		IPPU.TileCacheHits++
+#else
+#define COUNT_TILE_FETCH(miss)
+#endif
+
 #define GET_CACHED_TILE() \
 	uint32	TileNumber; \
 	uint32	TileAddr = BG.TileAddress + ((Tile & 0x3ff) << BG.TileShift); \
@@ -687,12 +951,14 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 	if (Tile & H_FLIP) \
 	{ \
 		pCache = &BG.BufferFlip[TileNumber << 6]; \
+		COUNT_TILE_FETCH(!BG.BufferedFlip[TileNumber]); \
 		if (!BG.BufferedFlip[TileNumber]) \
 			BG.BufferedFlip[TileNumber] = BG.ConvertTileFlip(pCache, TileAddr, Tile & 0x3ff); \
 	} \
 	else \
 	{ \
 		pCache = &BG.Buffer[TileNumber << 6]; \
+		COUNT_TILE_FETCH(!BG.Buffered[TileNumber]); \
 		if (!BG.Buffered[TileNumber]) \
 			BG.Buffered[TileNumber] = BG.ConvertTile(pCache, TileAddr, Tile & 0x3ff); \
 	}
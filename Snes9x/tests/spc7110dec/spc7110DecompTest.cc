@@ -0,0 +1,130 @@
+/*  This file is part of Snes9x EX.
+
+	Snes9x EX is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Snes9x EX is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Snes9x EX.  If not, see <http://www.gnu.org/licenses/> */
+
+// Checks SPC7110Decomp with Settings.DecompressionCache against the live
+// decoder on random ROM data, including the snapshot handoffs:
+// save+load (cache_sync() then the stream is dropped, as in
+// S9xSPC7110PostLoadState()) and save-then-continue (cache_sync() then
+// replay carries on, past the cached length)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+
+#define SPC7110_DECOMP_BUFFER_SIZE 64
+
+// the parts of snes9x.h, memmap.h and display.h spc7110dec.cpp uses
+static struct
+{
+	bool DecompressionCache;
+	bool DecompressionCacheCheck;
+} Settings;
+
+enum { S9X_ERROR };
+enum { S9X_DEBUG_OUTPUT };
+
+static int cacheMismatches;
+
+static void S9xMessage(int, int, const char *)
+{
+	cacheMismatches++;
+}
+
+static uint8 rom[0x200000];
+
+#define memory_cartrom_size() sizeof(rom)
+#define memory_cartrom_read(a) rom[(a)]
+
+#include "spc7110dec.h"
+#define _SPC7110EMU_CPP_
+#include "spc7110dec.cpp"
+
+enum Handoff { NONE, SAVE_LOAD, SAVE_CONTINUE };
+
+static const unsigned maxRead = 2000, tailRead = 300;
+static SPC7110Decomp decomp;
+
+static void liveStream(uint8 *out, unsigned mode, unsigned offset, unsigned index, unsigned len)
+{
+	Settings.DecompressionCache = false;
+	decomp.init(mode, offset, index);
+	for(unsigned i = 0; i < len; i++)
+		out[i] = decomp.read();
+}
+
+// reads len bytes of a cached stream, doing the handoff after handoffAt bytes
+static unsigned cachedStreamErrors(const uint8 *ref, unsigned mode, unsigned offset, unsigned index,
+	unsigned len, Handoff handoff, unsigned handoffAt)
+{
+	Settings.DecompressionCache = true;
+	decomp.init(mode, offset, index);
+	unsigned errors = 0;
+	for(unsigned i = 0; i < len; i++)
+	{
+		if(handoff != NONE && i == handoffAt)
+		{
+			decomp.cache_sync();
+			if(handoff == SAVE_LOAD)
+				decomp.cache_stream = 0;
+		}
+		if(decomp.read() != ref[i])
+			errors++;
+	}
+	return errors;
+}
+
+int main()
+{
+	srand(1);
+	for(auto &b : rom)
+		b = rand() >> 7;
+	static const char *handoffName[] = { "replay", "save+load", "save-then-continue" };
+	unsigned errors[3] = {};
+	static uint8 ref[maxRead + tailRead];
+	for(int i = 0; i < 3000; i++)
+	{
+		unsigned mode = rand() % 3, offset = (rand() % 8) * 0x1000, index = rand() % 300;
+		unsigned len = rand() % maxRead;
+		liveStream(ref, mode, offset, index, len + tailRead);
+		Settings.DecompressionCacheCheck = i % 7 == 0;
+		// first use fills the cache up to len
+		errors[NONE] += cachedStreamErrors(ref, mode, offset, index, len, NONE, 0);
+		// a snapshot part way through the cached bytes, then reading on past them
+		Handoff handoff = (Handoff)(i % 3);
+		unsigned handoffAt = len ? rand() % len : 0;
+		errors[handoff] += cachedStreamErrors(ref, mode, offset, index, len + tailRead, handoff, handoffAt);
+		// whatever the handoff appended to the cache must still be correct
+		errors[NONE] += cachedStreamErrors(ref, mode, offset, index, len + tailRead, NONE, 0);
+	}
+	int failed = 0;
+	for(int h = 0; h < 3; h++)
+	{
+		printf("%s: %u wrong bytes\n", handoffName[h], errors[h]);
+		if(errors[h])
+			failed = 1;
+	}
+	if(cacheMismatches)
+	{
+		printf("DecompressionCacheCheck reported %d mismatches\n", cacheMismatches);
+		failed = 1;
+	}
+	printf("%zu streams, %u bytes cached\n", decomp.cache.size(), decomp.cache_size);
+	return failed;
+}
@@ -18,6 +18,7 @@ ifneq ($(ENV), ps3)
 endif
 
 include $(imagineSrcDir)/audio/system.mk
+include $(imagineSrcDir)/audio/Resampler.mk
 include $(imagineSrcDir)/input/system.mk
 include $(imagineSrcDir)/gfx/system.mk
 include $(imagineSrcDir)/fs/system.mk
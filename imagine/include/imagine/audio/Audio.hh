@@ -34,6 +34,10 @@ namespace Audio
 	#if defined CONFIG_AUDIO_OPENSL_ES || defined CONFIG_AUDIO_COREAUDIO
 	#define CONFIG_AUDIO_SOLO_MIX
 	#endif
+
+	#if defined CONFIG_AUDIO_PULSEAUDIO || defined CONFIG_AUDIO_FILE
+	#define CONFIG_AUDIO_STATS
+	#endif
 	}
 
 struct BufferContext
@@ -50,6 +54,18 @@ struct BufferContext
 	}
 };
 
+struct OutputStats
+{
+	uint underruns = 0; // times the output ran out of queued frames
+	uint underrunFrames = 0; // silent frames played in place of samples
+	uint lateWrites = 0; // writes made after the output already ran dry
+	uint droppedFrames = 0; // frames discarded because the buffer was full
+
+	constexpr OutputStats() {}
+	constexpr OutputStats(uint underruns, uint underrunFrames, uint lateWrites, uint droppedFrames):
+		underruns{underruns}, underrunFrames{underrunFrames}, lateWrites{lateWrites}, droppedFrames{droppedFrames} {}
+};
+
 extern PcmFormat preferredPcmFormat;
 extern PcmFormat pcmFormat; // the currently playing format
 
@@ -80,6 +96,14 @@ static void setSoloMix(bool newSoloMix) {}
 static bool soloMix() { return 0; }
 #endif
 
+#ifdef CONFIG_AUDIO_STATS
+OutputStats outputStats();
+void resetOutputStats();
+#else
+static OutputStats outputStats() { return {}; }
+static void resetOutputStats() {}
+#endif
+
 // shortcuts
 static PcmFormat &pPCM = preferredPcmFormat;
 
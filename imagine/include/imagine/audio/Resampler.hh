@@ -0,0 +1,60 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+
+namespace Audio
+{
+
+// Windowed-sinc polyphase resampler for interleaved 16-bit mono or stereo audio.
+// The ratio can be changed at any time for rate control, the filter's cutoff is
+// chosen from the rates passed to init() so keep later changes small.
+class Resampler
+{
+public:
+	static constexpr uint PHASES = 128;
+	static constexpr uint MAX_TAPS = 512;
+
+	constexpr Resampler() {}
+	// taps is the filter length when not decimating, it's scaled up by the
+	// decimation factor so the cutoff stays below the output's nyquist rate
+	bool init(double inRate, double outRate, uint channels, uint taps = 16);
+	void deinit();
+	void reset();
+	void setRates(double inRate, double outRate);
+	double ratio() const;
+	uint taps() const { return taps_; }
+	// upper bound of frames produced by the next process() call with inFrames
+	uint maxOutputFrames(uint inFrames) const;
+	// consumes all input and returns the number of frames written to out,
+	// input that doesn't produce output yet is kept for the next call
+	uint process(const int16 *in, uint inFrames, int16 *out, uint outFrames);
+
+private:
+	static constexpr uint CHUNK_FRAMES = 1024;
+	float *coef{}; // PHASES + 1 rows of taps
+	float *coefDelta{}; // PHASES rows, next row minus current for interpolation
+	float *hist[2]{};
+	float *phaseCoef{};
+	uint64 pos = 0; // 32.32 fixed point input position of the next output frame
+	uint64 step = 0;
+	uint taps_ = 0;
+	uint histFrames = 0;
+	uint channels = 0;
+};
+
+}
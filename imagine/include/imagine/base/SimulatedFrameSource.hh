@@ -0,0 +1,57 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/base/baseDefs.hh>
+
+namespace Base
+{
+
+// Produces vsync timestamps for a given refresh rate with optional jitter and
+// periodically missed vblanks. The sequence only depends on the parameters and
+// seed, so frame pacing code sees the same timing on any machine.
+class SimulatedFrameSource
+{
+public:
+	constexpr SimulatedFrameSource() {}
+	void init(double refreshRate, double jitterSecs = 0, uint32 seed = 1);
+	// skip missedFrames vblanks after every interval delivered frames, 0 interval disables
+	void setMissedFrames(uint interval, uint missedFrames);
+	FrameTimeBase nextFrameTime();
+	double refreshRate() const { return rate; }
+	FrameTimeBase timePerFrame() const { return frameTimeBaseFromS(1. / rate); }
+	uint frames() const { return frameCount; }
+	uint missedFrames() const { return missedCount; }
+
+private:
+	double rate = 60.;
+	double jitter = 0;
+	uint64 vblank = 0;
+	uint32 rngState = 1;
+	uint frameCount = 0;
+	uint missInterval = 0, missFrames = 0, missedCount = 0;
+
+	uint32 nextRandom();
+};
+
+// Drive screen frames from src instead of the display, frames are delivered back
+// to back without waiting for real time to pass. Must be set before the first
+// frame is posted. Currently only honored by the X11 frame timer.
+void setSimulatedFrameSource(SimulatedFrameSource *src);
+SimulatedFrameSource *simulatedFrameSource();
+
+}
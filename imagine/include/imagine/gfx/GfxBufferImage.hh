@@ -21,8 +21,10 @@
 #include <imagine/data-type/image/GfxImageSource.hh>
 #include <imagine/util/RefCount.hh>
 
-#ifdef CONFIG_GFX_OPENGL
+#if defined CONFIG_GFX_OPENGL
 #include <imagine/gfx/opengl/BufferImage.hh>
+#elif defined CONFIG_GFX_SOFTWARE
+#include <imagine/gfx/software/BufferImage.hh>
 #endif
 
 namespace Gfx
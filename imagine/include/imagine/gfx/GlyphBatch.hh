@@ -0,0 +1,53 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/gfx/GfxBufferImage.hh>
+
+namespace Gfx
+{
+
+// Collects textured quads sorted by texture page so a whole string
+// is drawn with one call per page instead of one per character
+class GlyphBatch
+{
+public:
+	static constexpr uint MAX_PAGES = 4;
+	static constexpr uint MAX_QUADS = 0x10000 / 4; // keeps vertex indices in range of VertexIndex
+
+	constexpr GlyphBatch() {}
+	void deinit();
+	void reset();
+	// x/y is the bottom-left corner, u/v the top-left texture coordinate like TexRect
+	bool addQuad(uint page, GC x, GC y, GC x2, GC y2, GTexC u, GTexC v, GTexC u2, GTexC v2);
+	uint quads(uint page) const { return pageVerts[page].quads; }
+	const TexVertex *vertices(uint page) const { return pageVerts[page].v; }
+	static const VertexIndex *quadIndices(uint quads);
+	void draw(uint page, const BufferImage &img) const;
+
+private:
+	struct PageVerts
+	{
+		constexpr PageVerts() {}
+		TexVertex *v{};
+		uint quads = 0, maxQuads = 0;
+	};
+	PageVerts pageVerts[MAX_PAGES];
+};
+
+}
@@ -25,7 +25,11 @@ namespace Gfx
 class RenderTarget
 {
 private:
+	#ifdef CONFIG_GFX_SOFTWARE
+	bool isInit = false;
+	#else
 	GLuint fbo = 0;
+	#endif
 	BufferImage tex;
 
 public:
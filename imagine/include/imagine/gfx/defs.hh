@@ -21,8 +21,10 @@
 #include <imagine/util/rectangle2.h>
 #include <imagine/gfx/TextureSizeSupport.hh>
 
-#ifdef CONFIG_GFX_OPENGL
+#if defined CONFIG_GFX_OPENGL
 #include <imagine/gfx/opengl/gfx-globals.hh>
+#elif defined CONFIG_GFX_SOFTWARE
+#include <imagine/gfx/software/gfx-globals.hh>
 #endif
 
 namespace Gfx
@@ -0,0 +1,58 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/pixmap/Pixmap.hh>
+
+namespace Gfx
+{
+
+// texel storage is always RGBA8888 so the rasterizer only needs one sample path,
+// srcFormat selects how alpha-only & intensity images are expanded
+class SoftTexture
+{
+public:
+	IG::ManagedPixmap pix{PixelFormatRGBA8888};
+	const PixelFormatDesc *srcFormat = &PixelFormatRGBA8888;
+	uint filter = 0;
+	bool repeatX = false, repeatY = false;
+
+	constexpr SoftTexture() {}
+	void write(const IG::Pixmap &src);
+};
+
+class TextureBufferImage
+{
+public:
+	constexpr TextureBufferImage() {}
+
+protected:
+	TextureDesc desc;
+	void write(IG::Pixmap &p, uint hints);
+	void write(IG::Pixmap &p, uint hints, uint alignment);
+	void replace(IG::Pixmap &p, uint hints);
+	IG::Pixmap *lock(uint x, uint y, uint xlen, uint ylen, IG::Pixmap *fallback);
+	void unlock(IG::Pixmap *pix, uint hints);
+	void deinit();
+	const TextureDesc &textureDesc() const { return desc; };
+	TextureDesc &textureDesc() { return desc; };
+	bool isInit() const { return desc.tid != nullptr; }
+};
+
+using BufferImageImpl = TextureBufferImage;
+
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/util/normalFloat.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <imagine/pixmap/Pixmap.hh>
+
+#define CONFIG_GFX_MATH_GLM
+
+#include <imagine/gfx/Mat4.hh>
+
+namespace Base
+{
+class Window;
+}
+
+namespace Gfx
+{
+
+typedef float TransformCoordinate;
+typedef float VertexPos;
+typedef float Angle;
+typedef float TextureCoordinate;
+
+static constexpr Angle angleFromDegree(Angle deg) { return IG::toRadians(deg); }
+static constexpr Angle angleFromRadian(Angle rad) { return rad; }
+static constexpr Angle angleToDegree(Angle a) { return IG::toDegrees(a); }
+static constexpr Angle angleToRadian(Angle a) { return a; }
+
+static const uint gColor_steps = 255;
+typedef NormalFloat<gColor_steps> ColorComp;
+
+class SoftTexture;
+typedef SoftTexture* TextureHandle;
+typedef ushort VertexIndex;
+typedef uint VertexColor;
+typedef uint VertexArrayRef;
+
+// same memory layout as the OpenGL back-end, R,G,B,A bytes in order
+#define VertexColorPixelFormat PixelFormatABGR8888
+
+class VertexInfo
+{
+public:
+	static const uint posOffset = 0;
+	static constexpr bool hasColor = false;
+	static const uint colorOffset = 0;
+	static constexpr bool hasTexture = false;
+	static const uint textureOffset = 0;
+	template<class Vtx>
+	static void draw(const Vtx *v, uint type, uint count);
+	template<class Vtx>
+	static void draw(const Vtx *v, const VertexIndex *idx, uint type, uint count);
+};
+
+class Vertex : public VertexInfo
+{
+public:
+	VertexPos x,y;
+
+	Vertex() = default;
+	Vertex(VertexPos x, VertexPos y):
+		x{x}, y{y} {}
+	static constexpr uint ID = 1;
+};
+
+class ColVertex : public VertexInfo
+{
+public:
+	VertexPos x,y;
+	VertexColor color;
+
+	ColVertex() = default;
+	constexpr ColVertex(VertexPos x, VertexPos y, uint color = 0):
+		x{x}, y{y}, color(color) {}
+	static constexpr bool hasColor = true;
+	static const uint colorOffset;
+	static constexpr uint ID = 2;
+};
+
+class TexVertex : public VertexInfo
+{
+public:
+	VertexPos x,y;
+	TextureCoordinate u,v;
+
+	TexVertex() = default;
+	constexpr TexVertex(VertexPos x, VertexPos y, TextureCoordinate u = 0, TextureCoordinate v = 0):
+		x{x}, y{y}, u{u}, v{v} {}
+	static constexpr bool hasTexture = true;
+	static const uint textureOffset;
+	static constexpr uint ID = 3;
+};
+
+class ColTexVertex : public VertexInfo
+{
+public:
+	VertexPos x, y;
+	TextureCoordinate u, v;
+	VertexColor color;
+
+	ColTexVertex() = default;
+	constexpr ColTexVertex(VertexPos x, VertexPos y, uint color = 0, TextureCoordinate u = 0, TextureCoordinate v = 0):
+		x{x}, y{y}, u{u}, v{v}, color(color) {}
+	static constexpr bool hasColor = true;
+	static const uint colorOffset;
+	static constexpr bool hasTexture = true;
+	static const uint textureOffset;
+	static constexpr uint ID = 4;
+};
+
+class TextureDesc
+{
+public:
+	TextureHandle tid = nullptr;
+	static constexpr uint target = 0;
+	TextureCoordinate xStart = 0, xEnd = 0;
+	TextureCoordinate yStart = 0, yEnd = 0;
+
+	constexpr TextureDesc() {}
+};
+
+using Shader = uint;
+enum { SHADER_VERTEX = 1, SHADER_FRAGMENT = 2 }; // dummy values
+
+// No programmable pipeline, programs only select the texture environment
+class SoftProgram
+{
+public:
+	constexpr SoftProgram() {}
+	operator bool() const { return true; }
+};
+
+// default programs
+
+class DefaultProgram
+{
+public:
+	constexpr DefaultProgram(uint imgMode, bool hasTex): imgMode{imgMode}, hasTex{hasTex} {}
+	bool compile() { return false; }
+	void use() { use(nullptr); }
+	void use(Mat4 modelMat) { use(&modelMat); }
+	void use(const Mat4 *modelMat);
+
+private:
+	uint imgMode;
+	bool hasTex;
+};
+
+using DefaultTexReplaceProgram = DefaultProgram;
+using DefaultTexProgram = DefaultProgram;
+using DefaultTexAlphaReplaceProgram = DefaultProgram;
+using DefaultTexAlphaProgram = DefaultProgram;
+using DefaultTexIntensityAlphaReplaceProgram = DefaultProgram;
+using DefaultTexIntensityAlphaProgram = DefaultProgram;
+using DefaultTexExternalReplaceProgram = DefaultProgram;
+using DefaultTexExternalProgram = DefaultProgram;
+using DefaultColorProgram = DefaultProgram;
+
+// color replacement
+extern DefaultTexReplaceProgram texReplaceProgram;
+extern DefaultTexAlphaReplaceProgram texAlphaReplaceProgram;
+extern DefaultTexIntensityAlphaReplaceProgram texIntensityAlphaReplaceProgram;
+extern DefaultTexExternalReplaceProgram texExternalReplaceProgram;
+
+// color modulation
+extern DefaultTexProgram texProgram;
+extern DefaultTexAlphaProgram texAlphaProgram;
+extern DefaultTexIntensityAlphaProgram texIntensityAlphaProgram;
+extern DefaultTexExternalProgram texExternalProgram;
+extern DefaultColorProgram noTexProgram;
+
+using ProgramImpl = SoftProgram;
+
+enum { TEX_UNSET, TEX_2D_1, TEX_2D_2, TEX_2D_4, TEX_2D_EXTERNAL };
+
+// framebuffer the window draws into, allocated on demand to the window's size
+// unless the app supplies its own with setFramebuffer(), which must outlive its use
+void setFramebuffer(IG::Pixmap &pix);
+IG::Pixmap &framebuffer();
+
+// called from presentWindow() with the finished frame, used to save
+// reference images or hand the frame to a non-GL window system
+using PresentDelegate = DelegateFunc<void (Base::Window &win, const IG::Pixmap &pix)>;
+void setOnPresent(PresentDelegate del);
+
+}
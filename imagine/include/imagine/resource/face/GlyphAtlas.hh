@@ -0,0 +1,98 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/engine-globals.h>
+#include <imagine/pixmap/Pixmap.hh>
+#include <imagine/gfx/GfxBufferImage.hh>
+#include <imagine/resource/font/glyphTable.h>
+
+// Packs glyph rectangles into horizontal shelves, no GPU state so it can be exercised on its own
+class GlyphShelfPacker
+{
+public:
+	static constexpr uint MAX_SHELVES = 128;
+
+	constexpr GlyphShelfPacker() {}
+	void init(uint width, uint height);
+	void reset();
+	bool pack(uint w, uint h, uint &x, uint &y);
+	uint width() const { return w; }
+	uint height() const { return h; }
+	uint shelves() const { return usedShelves; }
+
+private:
+	struct Shelf
+	{
+		constexpr Shelf() {}
+		uint16 y = 0, height = 0, xEnd = 0;
+	};
+	Shelf shelf[MAX_SHELVES]{};
+	uint usedShelves = 0;
+	uint16 w = 0, h = 0, yEnd = 0;
+};
+
+// Fixed set of A8 texture pages shared by all glyphs of a face. Glyphs are
+// placed with a GlyphShelfPacker and, once every page is full, the least
+// recently drawn page is cleared and reused. Entries pointing into an evicted
+// page are detected by their stale generation number and re-cached.
+class GlyphAtlas
+{
+public:
+	static constexpr uint MAX_PAGES = 4;
+	static constexpr uint PAGE_SIZE = 512;
+	static constexpr uint GLYPH_PADDING = 1; // keeps linear filtering from sampling the neighbor glyph
+	static constexpr uint32 NO_BITMAP_GEN = 0xFFFFFFFF; // glyph with empty bitmap, needs no page
+
+	constexpr GlyphAtlas() {}
+	void deinit();
+	bool add(GlyphEntry &entry);
+	bool isCached(const GlyphEntry &entry) const
+	{
+		if(!entry.pageGen)
+			return false;
+		return entry.pageGen == NO_BITMAP_GEN || entry.pageGen == page[entry.page].gen;
+	}
+	void initGlyphPixmap(const GlyphEntry &entry, IG::Pixmap &pix);
+	void touch(const GlyphEntry &entry)
+	{
+		if(entry.pageGen != NO_BITMAP_GEN)
+			page[entry.page].lastUse = useClock;
+	}
+	void beginUse() { useClock++; }
+	Gfx::BufferImage *pageImage(uint pageIdx);
+	uint pages() const { return usedPages; }
+	uint evictions() const { return evictionCount; }
+
+private:
+	struct Page
+	{
+		constexpr Page() {}
+		IG::ManagedPixmap pix{PixelFormatA8};
+		Gfx::BufferImage img;
+		GlyphShelfPacker packer;
+		uint32 gen = 1;
+		uint32 lastUse = 0;
+		bool dirty = false;
+	};
+	Page page[MAX_PAGES];
+	uint usedPages = 0;
+	uint32 useClock = 1;
+	uint evictionCount = 0;
+
+	bool initPage(Page &p);
+	void evictPage(Page &p);
+};
@@ -18,10 +18,10 @@
 #include <imagine/engine-globals.h>
 #include <imagine/resource/font/ResourceFont.h>
 #include <imagine/resource/font/glyphTable.h>
+#include <imagine/resource/face/GlyphAtlas.hh>
 #define RESOURCE_FACE_SETTINGS_UNCHANGED 128
 #include <imagine/io/FileIO.hh>
 #include <imagine/pixmap/Pixmap.hh>
-#include <imagine/data-type/image/GfxImageSource.hh>
 
 class ResourceFace
 {
@@ -50,6 +50,7 @@ public:
 		return precache("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789");
 	}
 	GlyphEntry *glyphEntry(int c);
+	GlyphAtlas &glyphAtlas() { return atlas; }
 	uint nominalHeight() const;
 	void freeCaches(uint32 rangeToFreeBits);
 	void freeCaches() { freeCaches(~0); }
@@ -57,6 +58,7 @@ public:
 private:
 	ResourceFont *font = nullptr;
 	GlyphEntry *glyphTable = nullptr;
+	GlyphAtlas atlas;
 	FontSizeRef faceSize;
 	uint nominalHeight_ = 0;
 	uint32 usedGlyphTableBits = 0;
@@ -65,16 +67,3 @@ private:
 	bool initGlyphTable();
 	CallResult cacheChar(int c, int tableIdx);
 };
-
-class GfxGlyphImage : public GfxImageSource
-{
-public:
-	ResourceFace *face;
-	GlyphEntry *entry;
-
-	GfxGlyphImage(ResourceFace *face, GlyphEntry *entry): face(face), entry(entry) {}
-	CallResult getImage(IG::Pixmap &dest) override { return face->writeCurrentChar(dest); }
-	uint width() override { return entry->metrics.xSize; }
-	uint height() override { return entry->metrics.ySize; }
-	const PixelFormatDesc *pixelFormat() override { return &PixelFormatA8; }
-};
@@ -22,6 +22,9 @@ class BufferImage;
 struct GlyphEntry
 {
 	constexpr GlyphEntry() { }
-	Gfx::BufferImage glyph;
 	GlyphMetrics metrics;
+	// position of the bitmap in the face's GlyphAtlas, only valid while pageGen matches the page
+	uint16 page = 0;
+	uint16 x = 0, y = 0;
+	uint32 pageGen = 0;
 };
@@ -0,0 +1,273 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Resampler"
+#include <imagine/audio/Resampler.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/mem/mem.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined __SSE__
+#include <xmmintrin.h>
+#elif defined __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+namespace Audio
+{
+
+static constexpr uint PHASE_BITS = 7;
+static_assert((1 << PHASE_BITS) == Resampler::PHASES, "PHASE_BITS doesn't match PHASES");
+static constexpr uint SUBPHASE_BITS = 32 - PHASE_BITS;
+
+// taps is always a multiple of 4
+static void interpolateCoef(float *dest, const float *c, const float *d, float frac, uint taps)
+{
+	#if defined __SSE__
+	auto f = _mm_set1_ps(frac);
+	for(uint i = 0; i < taps; i += 4)
+	{
+		_mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(c + i), _mm_mul_ps(f, _mm_loadu_ps(d + i))));
+	}
+	#elif defined __ARM_NEON__
+	for(uint i = 0; i < taps; i += 4)
+	{
+		vst1q_f32(dest + i, vmlaq_n_f32(vld1q_f32(c + i), vld1q_f32(d + i), frac));
+	}
+	#else
+	iterateTimes(taps, i)
+	{
+		dest[i] = c[i] + frac * d[i];
+	}
+	#endif
+}
+
+static float dotProduct(const float *s, const float *c, uint taps)
+{
+	#if defined __SSE__
+	auto acc = _mm_setzero_ps();
+	for(uint i = 0; i < taps; i += 4)
+	{
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(s + i), _mm_loadu_ps(c + i)));
+	}
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	return _mm_cvtss_f32(acc);
+	#elif defined __ARM_NEON__
+	auto acc = vdupq_n_f32(0);
+	for(uint i = 0; i < taps; i += 4)
+	{
+		acc = vmlaq_f32(acc, vld1q_f32(s + i), vld1q_f32(c + i));
+	}
+	auto sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	sum = vpadd_f32(sum, sum);
+	return vget_lane_f32(sum, 0);
+	#else
+	float acc[4]{};
+	for(uint i = 0; i < taps; i += 4)
+	{
+		acc[0] += s[i] * c[i];
+		acc[1] += s[i + 1] * c[i + 1];
+		acc[2] += s[i + 2] * c[i + 2];
+		acc[3] += s[i + 3] * c[i + 3];
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+	#endif
+}
+
+static int16 toSample(float v)
+{
+	int s = v >= 0 ? (int)(v + .5f) : (int)(v - .5f);
+	return std::min(std::max(s, -32768), 32767);
+}
+
+static double sinc(double x)
+{
+	if(std::abs(x) < 1e-9)
+		return 1.;
+	return std::sin(M_PI * x) / (M_PI * x);
+}
+
+bool Resampler::init(double inRate, double outRate, uint channels, uint taps)
+{
+	assert(channels == 1 || channels == 2);
+	assert(inRate > 0 && outRate > 0);
+	deinit();
+	double bandwidth = std::min(1., outRate / inRate);
+	// widen the filter as the passband shrinks so the transition band stays the same relative width
+	uint newTaps = std::ceil(std::max(taps, 4u) / bandwidth);
+	newTaps = std::min((newTaps + 3) & ~3u, MAX_TAPS);
+	taps_ = newTaps;
+	this->channels = channels;
+	coef = (float*)mem_alloc(sizeof(float) * taps_ * (PHASES + 1));
+	coefDelta = (float*)mem_alloc(sizeof(float) * taps_ * PHASES);
+	phaseCoef = (float*)mem_alloc(sizeof(float) * taps_);
+	iterateTimes(channels, c)
+	{
+		hist[c] = (float*)mem_alloc(sizeof(float) * (taps_ + CHUNK_FRAMES));
+	}
+	if(!coef || !coefDelta || !phaseCoef || !hist[0] || (channels == 2 && !hist[1]))
+	{
+		logErr("out of memory");
+		deinit();
+		return false;
+	}
+	// leave some room for the transition band below nyquist
+	double cutoff = bandwidth * .9;
+	iterateTimes(PHASES + 1, p)
+	{
+		double frac = p / (double)PHASES;
+		auto row = &coef[p * taps_];
+		double sum = 0;
+		iterateTimes(taps_, k)
+		{
+			double t = k - (double)(taps_ / 2 - 1) - frac;
+			// Blackman window over [0, taps]
+			double n = (t + taps_ / 2.) / taps_;
+			double window = .42 - .5 * std::cos(2. * M_PI * n) + .08 * std::cos(4. * M_PI * n);
+			double h = cutoff * sinc(cutoff * t) * window;
+			row[k] = h;
+			sum += h;
+		}
+		// unity gain at DC for every phase
+		iterateTimes(taps_, k)
+		{
+			row[k] /= sum;
+		}
+	}
+	iterateTimes(PHASES * taps_, i)
+	{
+		coefDelta[i] = coef[i + taps_] - coef[i];
+	}
+	setRates(inRate, outRate);
+	reset();
+	logMsg("init %.2fHz -> %.2fHz, %d channels, %d taps", inRate, outRate, channels, taps_);
+	return true;
+}
+
+void Resampler::deinit()
+{
+	mem_free(coef);
+	mem_free(coefDelta);
+	mem_free(phaseCoef);
+	for(auto &h : hist)
+	{
+		mem_free(h);
+		h = nullptr;
+	}
+	coef = coefDelta = phaseCoef = nullptr;
+	taps_ = 0;
+	histFrames = 0;
+	channels = 0;
+}
+
+void Resampler::reset()
+{
+	// pre-fill the left half of the filter so output starts at the first input frame
+	histFrames = taps_ / 2 - 1;
+	iterateTimes(channels, c)
+	{
+		std::fill_n(hist[c], histFrames, 0.f);
+	}
+	pos = 0;
+}
+
+void Resampler::setRates(double inRate, double outRate)
+{
+	assert(inRate > 0 && outRate > 0);
+	step = std::llround(inRate / outRate * 4294967296.);
+}
+
+double Resampler::ratio() const
+{
+	return 4294967296. / step;
+}
+
+uint Resampler::maxOutputFrames(uint inFrames) const
+{
+	uint64 frames = histFrames + inFrames;
+	if(frames < taps_)
+		return 0;
+	uint64 lastPos = (frames - taps_) << 32 | 0xFFFFFFFF;
+	if(lastPos < pos)
+		return 0;
+	return (lastPos - pos) / step + 1;
+}
+
+uint Resampler::process(const int16 *in, uint inFrames, int16 *out, uint outFrames)
+{
+	assert(taps_);
+	const uint histCapacity = taps_ + CHUNK_FRAMES;
+	uint produced = 0;
+	while(1)
+	{
+		uint chunk = std::min(inFrames, histCapacity - histFrames);
+		if(channels == 2)
+		{
+			auto l = &hist[0][histFrames], r = &hist[1][histFrames];
+			iterateTimes(chunk, i)
+			{
+				l[i] = in[i*2];
+				r[i] = in[i*2 + 1];
+			}
+		}
+		else
+		{
+			std::copy_n(in, chunk, &hist[0][histFrames]);
+		}
+		histFrames += chunk;
+		in += chunk * channels;
+		inFrames -= chunk;
+
+		for(; produced < outFrames; produced++)
+		{
+			uint idx = pos >> 32;
+			if(idx + taps_ > histFrames)
+				break;
+			uint32 frac = pos;
+			uint phase = frac >> SUBPHASE_BITS;
+			float subPhase = (frac & ((1 << SUBPHASE_BITS) - 1)) * (1.f / (1 << SUBPHASE_BITS));
+			interpolateCoef(phaseCoef, &coef[phase * taps_], &coefDelta[phase * taps_], subPhase, taps_);
+			iterateTimes(channels, c)
+			{
+				*out++ = toSample(dotProduct(&hist[c][idx], phaseCoef, taps_));
+			}
+			pos += step;
+		}
+
+		// drop frames no longer covered by the filter
+		uint consumed = std::min((uint)(pos >> 32), histFrames);
+		if(consumed)
+		{
+			iterateTimes(channels, c)
+			{
+				memmove(hist[c], &hist[c][consumed], (histFrames - consumed) * sizeof(float));
+			}
+			histFrames -= consumed;
+			pos -= (uint64)consumed << 32;
+		}
+		if(!inFrames)
+			break;
+		if(histFrames == histCapacity)
+		{
+			logWarn("output buffer full, dropping %d input frames", inFrames);
+			break;
+		}
+	}
+	return produced;
+}
+
+}
@@ -0,0 +1,8 @@
+ifndef inc_audio
+inc_audio := 1
+
+configDefs += CONFIG_AUDIO CONFIG_AUDIO_FILE
+
+SRC += audio/file/file.cc
+
+endif
@@ -0,0 +1,324 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+// Audio sink without a device, for headless runs and audio regression tests.
+// Accepted samples are appended to a WAV file in the order they're written and
+// a simulated device drains the buffer, either in real time or instantly.
+// Configured at run time from the environment:
+// IMAGINE_AUDIO_FILE: WAV output path, default "audio.wav", "none" discards samples
+// IMAGINE_AUDIO_LOG: optional CSV path, one line per write with the device state
+// IMAGINE_AUDIO_CLOCK: "realtime" (default) or "fast" to never block on the buffer
+
+#define LOGTAG "AudioFile"
+#include <imagine/audio/Audio.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/time/sys.hh>
+#include <imagine/util/strings.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace Audio
+{
+
+PcmFormat preferredPcmFormat { 48000, SampleFormats::s16, 2 };
+PcmFormat pcmFormat;
+static uint wantedLatency = 100000;
+static FileIO wavFile, logFile;
+static bool wavOpen = false, logOpen = false;
+static bool fastClock = false;
+static bool isPlaying_ = false, hadUnderrun = false;
+static uint bufferFrames = 0;
+static uint queuedFrames = 0;
+static uint64 framesAccepted = 0, framesPlayed = 0;
+static TimeSys resumeTime{};
+static uint64 framesPlayedAtResume = 0;
+static TimeSys openTime{};
+static uint underruns = 0, underrunFrames = 0, lateWrites = 0, droppedFrames = 0;
+static char *playBuff{};
+static uint playBuffFrames = 0;
+
+int maxRate()
+{
+	return 48000;
+}
+
+void setHintOutputLatency(uint us)
+{
+	wantedLatency = us;
+}
+
+uint hintOutputLatency()
+{
+	return wantedLatency;
+}
+
+static const char *envOrDefault(const char *name, const char *defaultVal)
+{
+	auto val = getenv(name);
+	return val ? val : defaultVal;
+}
+
+static void writeWavHeader(uint32 dataBytes)
+{
+	uint32 blockAlign = pcmFormat.framesToBytes(1);
+	wavFile.seekS(0);
+	wavFile.write("RIFF", 4);
+	wavFile.writeVal<uint32>(36 + dataBytes, nullptr);
+	wavFile.write("WAVEfmt ", 8);
+	wavFile.writeVal<uint32>(16, nullptr);
+	wavFile.writeVal<uint16>(1, nullptr); // PCM
+	wavFile.writeVal<uint16>(pcmFormat.channels, nullptr);
+	wavFile.writeVal<uint32>(pcmFormat.rate, nullptr);
+	wavFile.writeVal<uint32>(pcmFormat.rate * blockAlign, nullptr);
+	wavFile.writeVal<uint16>(blockAlign, nullptr);
+	wavFile.writeVal<uint16>(pcmFormat.sample.toBits(), nullptr);
+	wavFile.write("data", 4);
+	wavFile.writeVal<uint32>(dataBytes, nullptr);
+}
+
+// drain queued frames up to the simulated device's current position
+static void updateDevice()
+{
+	if(!isPlaying_)
+		return;
+	uint64 target;
+	if(fastClock)
+		target = framesPlayed + queuedFrames;
+	else
+	{
+		auto elapsedNs = (TimeSys::now() - resumeTime).toNs();
+		target = framesPlayedAtResume + (uint64)elapsedNs * pcmFormat.rate / 1000000000;
+	}
+	if(target <= framesPlayed)
+		return;
+	uint framesToPlay = target - framesPlayed;
+	if(framesToPlay > queuedFrames)
+	{
+		if(!hadUnderrun)
+		{
+			hadUnderrun = true;
+			underruns++;
+		}
+		underrunFrames += framesToPlay - queuedFrames;
+		queuedFrames = 0;
+	}
+	else
+		queuedFrames -= framesToPlay;
+	framesPlayed = target;
+}
+
+static void logWrite(uint frames, uint accepted)
+{
+	if(!logOpen)
+		return;
+	std::array<char, 128> line;
+	string_printf(line, "%lld,%u,%u,%u,%u\n",
+		(long long)((TimeSys::now() - openTime).toNs() / 1000), frames, accepted, queuedFrames, underruns);
+	logFile.write(line.data(), strlen(line.data()));
+}
+
+static void acceptFrames(const void *samples, uint frames)
+{
+	if(hadUnderrun)
+		lateWrites++;
+	uint accepted = std::min(frames, bufferFrames - queuedFrames);
+	if(accepted != frames)
+	{
+		//logMsg("overrun, wrote %d out of %d frames", accepted, frames);
+		droppedFrames += frames - accepted;
+	}
+	if(wavOpen && accepted)
+		wavFile.write(samples, pcmFormat.framesToBytes(accepted));
+	queuedFrames += accepted;
+	framesAccepted += accepted;
+	logWrite(frames, accepted);
+}
+
+int frameDelay()
+{
+	if(unlikely(!isOpen()))
+		return 0;
+	updateDevice();
+	return queuedFrames;
+}
+
+int framesFree()
+{
+	if(unlikely(!isOpen()))
+		return 0;
+	updateDevice();
+	return bufferFrames - queuedFrames;
+}
+
+void pausePcm()
+{
+	if(unlikely(!isOpen()))
+		return;
+	updateDevice();
+	isPlaying_ = false;
+}
+
+void resumePcm()
+{
+	if(unlikely(!isOpen()))
+		return;
+	updateDevice();
+	hadUnderrun = false;
+	if(isPlaying_)
+		return;
+	resumeTime = TimeSys::now();
+	framesPlayedAtResume = framesPlayed;
+	isPlaying_ = true;
+}
+
+void clearPcm()
+{
+	if(unlikely(!isOpen()))
+		return;
+	logMsg("clearing queued samples");
+	isPlaying_ = false;
+	queuedFrames = 0;
+}
+
+void writePcm(const void *samples, uint framesToWrite)
+{
+	if(unlikely(!isOpen()))
+		return;
+	updateDevice();
+	acceptFrames(samples, framesToWrite);
+}
+
+BufferContext getPlayBuffer(uint wantedFrames)
+{
+	if(unlikely(!isOpen()) || !framesFree())
+		return {};
+	auto frames = std::min(wantedFrames, (uint)framesFree());
+	if(frames > playBuffFrames)
+	{
+		auto newBuff = (char*)mem_realloc(playBuff, pcmFormat.framesToBytes(frames));
+		if(!newBuff)
+			return {};
+		playBuff = newBuff;
+		playBuffFrames = frames;
+	}
+	return {playBuff, frames};
+}
+
+void commitPlayBuffer(BufferContext buffer, uint frames)
+{
+	assert(frames <= buffer.frames);
+	acceptFrames(buffer.data, frames);
+}
+
+OutputStats outputStats()
+{
+	return {underruns, underrunFrames, lateWrites, droppedFrames};
+}
+
+void resetOutputStats()
+{
+	underruns = 0;
+	underrunFrames = 0;
+	lateWrites = 0;
+	droppedFrames = 0;
+}
+
+CallResult openPcm(const PcmFormat &format)
+{
+	if(isOpen())
+	{
+		logMsg("audio already open");
+		return OK;
+	}
+	pcmFormat = format;
+	bufferFrames = std::max(format.uSecsToFrames(wantedLatency), 1u);
+	queuedFrames = 0;
+	framesAccepted = framesPlayed = 0;
+	isPlaying_ = hadUnderrun = false;
+	openTime = TimeSys::now();
+	auto wavPath = envOrDefault("IMAGINE_AUDIO_FILE", "audio.wav");
+	if(!string_equal(wavPath, "none"))
+	{
+		if(wavFile.create(wavPath) != OK)
+		{
+			logErr("can't create %s", wavPath);
+			pcmFormat = {};
+			return IO_ERROR;
+		}
+		wavOpen = true;
+		writeWavHeader(0);
+	}
+	auto logPath = getenv("IMAGINE_AUDIO_LOG");
+	if(logPath)
+	{
+		if(logFile.create(logPath) == OK)
+		{
+			logOpen = true;
+			const char header[] = "time_us,frames,accepted,queued,underruns\n";
+			logFile.write(header, sizeof(header) - 1);
+		}
+		else
+			logWarn("can't create %s, timing log disabled", logPath);
+	}
+	logMsg("opened %s sink %dHz %d channels, %d frame buffer, %s clock",
+		wavOpen ? wavPath : "null", format.rate, format.channels, bufferFrames, fastClock ? "fast" : "realtime");
+	return OK;
+}
+
+void closePcm()
+{
+	if(!isOpen())
+	{
+		logMsg("audio already closed");
+		return;
+	}
+	if(wavOpen)
+	{
+		writeWavHeader(pcmFormat.framesToBytes(framesAccepted));
+		wavFile.close();
+		wavOpen = false;
+	}
+	if(logOpen)
+	{
+		logFile.close();
+		logOpen = false;
+	}
+	mem_free(playBuff);
+	playBuff = nullptr;
+	playBuffFrames = 0;
+	isPlaying_ = false;
+	logMsg("closed sink after %lld frames", (long long)framesAccepted);
+	pcmFormat = {};
+}
+
+bool isOpen()
+{
+	return pcmFormat.rate;
+}
+
+bool isPlaying()
+{
+	return isPlaying_ && !hadUnderrun;
+}
+
+CallResult init()
+{
+	fastClock = string_equal(envOrDefault("IMAGINE_AUDIO_CLOCK", "realtime"), "fast");
+	logMsg("init with %s clock", fastClock ? "fast" : "realtime");
+	return OK;
+}
+
+}
@@ -17,6 +17,7 @@
 #include <imagine/audio/Audio.hh>
 #include <imagine/logger/logger.h>
 #include <imagine/base/Base.hh>
+#include <imagine/util/ringbuffer/LinuxRingBuffer.hh>
 #include <pulse/pulseaudio.h>
 #ifdef CONFIG_AUDIO_PULSEAUDIO_GLIB
 #include <pulse/glib-mainloop.h>
@@ -33,6 +34,12 @@ static uint wantedLatency = 100000;
 static pa_context* context = nullptr;
 static pa_stream* stream = nullptr;
 static bool isCorked = true;
+// Samples are queued in rBuff by writePcm() and moved to the server from the stream's
+// write callback, so the caller never needs the main loop lock to submit audio
+static StaticLinuxRingBuffer<> rBuff;
+static std::atomic_bool hadUnderrun{false};
+static std::atomic_uint serverDelayFrames{0};
+static std::atomic_uint underruns{0}, underrunFrames{0}, lateWrites{0}, droppedFrames{0};
 
 #ifdef CONFIG_AUDIO_PULSEAUDIO_GLIB
 static pa_glib_mainloop* mainloop = nullptr;
@@ -158,29 +165,14 @@ int frameDelay()
 {
 	if(unlikely(!isOpen()))
 		return 0;
-	pa_usec_t delay;
-	iterateMainLoop();
-	lockMainLoop();
-	int err = pa_stream_get_latency(stream, &delay, nullptr);
-	unlockMainLoop();
-	if(err)
-	{
-		// TODO: check exact error like PA_ERR_NODATA
-		logErr("error getting stream latency");
-		return 0;
-	}
-	return pcmFormat.uSecsToFrames(delay);
+	return pcmFormat.bytesToFrames(rBuff.writtenSize()) + serverDelayFrames;
 }
 
 int framesFree()
 {
 	if(unlikely(!isOpen()))
 		return 0;
-	iterateMainLoop();
-	lockMainLoop();
-	auto bytes = pa_stream_writable_size(stream);
-	unlockMainLoop();
-	return pcmFormat.bytesToFrames(bytes);
+	return pcmFormat.bytesToFrames(rBuff.freeSpace());
 }
 
 void pausePcm()
@@ -190,8 +182,8 @@ void pausePcm()
 	logMsg("pausing playback");
 	lockMainLoop();
 	pa_stream_cork(stream, 1, nullptr, nullptr);
-	unlockMainLoop();
 	isCorked = true;
+	unlockMainLoop();
 	iterateMainLoop();
 }
 
@@ -199,10 +191,13 @@ void resumePcm()
 {
 	if(unlikely(!isOpen()))
 		return;
+	hadUnderrun = false;
+	if(!isCorked)
+		return; // stream kept running on silence, new samples play on the next callback
 	lockMainLoop();
 	pa_stream_cork(stream, 0, nullptr, nullptr);
-	unlockMainLoop();
 	isCorked = false;
+	unlockMainLoop();
 	iterateMainLoop();
 }
 
@@ -212,7 +207,11 @@ void clearPcm()
 		return;
 	logMsg("clearing queued samples");
 	lockMainLoop();
+	pa_stream_cork(stream, 1, nullptr, nullptr);
+	isCorked = true;
 	pa_stream_flush(stream, nullptr, nullptr);
+	// write callback runs with the lock held, safe to reset the read side here
+	rBuff.reset();
 	unlockMainLoop();
 	iterateMainLoop();
 }
@@ -221,38 +220,102 @@ void writePcm(const void *samples, uint framesToWrite)
 {
 	if(unlikely(!isOpen()))
 		return;
-
-	iterateMainLoop();
-	lockMainLoop(); // TODO: locking here is sub-optimal, writes should be async using a ring-buffer
-	auto bytesFreeOnHW = pa_stream_writable_size(stream);
-	auto framesFreeOnHW = pcmFormat.bytesToFrames(bytesFreeOnHW);
-	auto bytesToWrite = pcmFormat.framesToBytes(framesToWrite);
-	//logMsg("writing %d frames, %d free", framesToWrite, framesFreeOnHW);
-	/*{
-		static uint framesToWriteAvg = 0, writeCount = 0;
-		framesToWriteAvg += framesToWrite;
-		writeCount++;
-		if(writeCount == 120)
-		{
-			logMsg("avg frames: %f, %d free", framesToWriteAvg / (double)120., framesFree());
-			framesToWriteAvg = 0;
-			writeCount = 0;
-		}
-	}*/
-	if(framesFreeOnHW < framesToWrite)
+	if(hadUnderrun)
+		lateWrites++;
+	auto bytes = pcmFormat.framesToBytes(framesToWrite);
+	auto written = rBuff.write(samples, bytes);
+	if(written != bytes)
 	{
-		logWarn("sending %d frames but only %d free", framesToWrite, framesFreeOnHW);
-		bytesToWrite = bytesFreeOnHW;
+		//logMsg("overrun, wrote %d out of %d bytes", written, bytes);
+		droppedFrames += pcmFormat.bytesToFrames(bytes - written);
 	}
-	int err = pa_stream_write(stream, samples, bytesToWrite, nullptr, 0, PA_SEEK_RELATIVE);
-	unlockMainLoop();
-	if(err < 0)
+	iterateMainLoop();
+}
+
+BufferContext getPlayBuffer(uint wantedFrames)
+{
+	if(unlikely(!isOpen()) || !framesFree())
+		return {};
+	if(hadUnderrun)
+		lateWrites++;
+	if((uint)framesFree() < wantedFrames)
 	{
-		logWarn("error writing %d bytes", bytesToWrite);
+		logDMsg("buffer has only %d/%d frames free", framesFree(), wantedFrames);
 	}
+	// will always have a contiguous block from mirrored pages
+	return {rBuff.writeAddr(), std::min(wantedFrames, (uint)framesFree())};
+}
+
+void commitPlayBuffer(BufferContext buffer, uint frames)
+{
+	assert(frames <= buffer.frames);
+	rBuff.commitWrite(pcmFormat.framesToBytes(frames));
 	iterateMainLoop();
 }
 
+OutputStats outputStats()
+{
+	return {underruns, underrunFrames, lateWrites, droppedFrames};
+}
+
+void resetOutputStats()
+{
+	underruns = 0;
+	underrunFrames = 0;
+	lateWrites = 0;
+	droppedFrames = 0;
+}
+
+static void streamWriteCallback(pa_stream *stream, size_t nbytes, void *)
+{
+	const uint frameBytes = pcmFormat.framesToBytes(1);
+	while(nbytes)
+	{
+		// copy straight into the server's memblock to avoid pa_stream_write()'s extra copy
+		void *data;
+		size_t bytes = nbytes;
+		if(pa_stream_begin_write(stream, &data, &bytes) < 0 || !data)
+		{
+			logErr("error in pa_stream_begin_write");
+			return;
+		}
+		bytes = std::min(bytes, nbytes);
+		bytes -= bytes % frameBytes;
+		if(isCorked)
+		{
+			// pre-fill the server buffer before playback starts but don't pad with silence
+			bytes = std::min(bytes, (size_t)rBuff.writtenSize());
+		}
+		if(!bytes)
+		{
+			pa_stream_cancel_write(stream);
+			break;
+		}
+		uint read = hadUnderrun ? 0 : rBuff.read(data, bytes);
+		if(unlikely(read != bytes))
+		{
+			if(!hadUnderrun)
+			{
+				//logMsg("underrun, read %d out of %d bytes", read, (int)bytes);
+				hadUnderrun = true;
+				underruns++;
+			}
+			underrunFrames += pcmFormat.bytesToFrames(bytes - read);
+			mem_zero((char*)data + read, bytes - read);
+		}
+		if(pa_stream_write(stream, data, bytes, nullptr, 0, PA_SEEK_RELATIVE) < 0)
+		{
+			logErr("error writing %d bytes", (int)bytes);
+			return;
+		}
+		nbytes -= bytes;
+	}
+	pa_usec_t delay;
+	int negative;
+	if(pa_stream_get_latency(stream, &delay, &negative) == 0)
+		serverDelayFrames = negative ? 0 : pcmFormat.uSecsToFrames(delay);
+}
+
 CallResult openPcm(const PcmFormat &format)
 {
 	if(isOpen())
@@ -261,6 +324,12 @@ CallResult openPcm(const PcmFormat &format)
 		return OK;
 	}
 	pcmFormat = format;
+	if(!rBuff.init(format.uSecsToBytes(wantedLatency)))
+	{
+		return OUT_OF_MEMORY;
+	}
+	hadUnderrun = false;
+	serverDelayFrames = 0;
 	pa_sample_spec spec {(pa_sample_format_t)0};
 	spec.format = pcmFormatToPA(format.sample);
 	spec.rate = format.rate;
@@ -273,6 +342,8 @@ CallResult openPcm(const PcmFormat &format)
 	{
 		logErr("error creating stream");
 		pa_proplist_free(props);
+		unlockMainLoop();
+		rBuff.deinit();
 		return INVALID_PARAMETER;
 	}
 	pa_proplist_free(props);
@@ -292,16 +363,21 @@ CallResult openPcm(const PcmFormat &format)
 				break;
 			}
 		}, &finalState);
+	pa_stream_set_write_callback(stream, streamWriteCallback, nullptr);
 	pa_buffer_attr bufferAttr {0};
 	bufferAttr.maxlength = -1;
-	bufferAttr.tlength = format.uSecsToBytes(wantedLatency);
-	bufferAttr.prebuf = -1;
+	// the ring buffer holds the rest of the requested latency
+	bufferAttr.tlength = format.uSecsToBytes(wantedLatency / 2);
+	// underruns are padded with silence in the write callback, so never stop for pre-buffering
+	bufferAttr.prebuf = 0;
 	bufferAttr.minreq = -1;
+	isCorked = true;
 	if(pa_stream_connect_playback(stream, nullptr, &bufferAttr,
-		pa_stream_flags_t(PA_STREAM_ADJUST_LATENCY /*| PA_STREAM_AUTO_TIMING_UPDATE | PA_STREAM_INTERPOLATE_TIMING*/),
+		pa_stream_flags_t(PA_STREAM_ADJUST_LATENCY | PA_STREAM_START_CORKED | PA_STREAM_AUTO_TIMING_UPDATE),
 		nullptr, nullptr) < 0)
 	{
 		logErr("error connecting playback stream");
+		unlockMainLoop();
 		closePcm();
 		return INVALID_PARAMETER;
 	}
@@ -310,13 +386,13 @@ CallResult openPcm(const PcmFormat &format)
 	if(finalState != PA_STREAM_READY)
 	{
 		logErr("error connecting playback stream async");
+		unlockMainLoop();
 		closePcm();
 		return INVALID_PARAMETER;
 	}
 	auto serverAttr = pa_stream_get_buffer_attr(stream);
 	unlockMainLoop();
 	assert(serverAttr);
-	isCorked = false;
 	logMsg("opened stream with target fill bytes: %d", serverAttr->tlength);
 	return OK;
 }
@@ -329,12 +405,14 @@ void closePcm()
 		return;
 	}
 	lockMainLoop();
+	pa_stream_set_write_callback(stream, nullptr, nullptr);
 	pa_stream_disconnect(stream);
 	pa_stream_unref(stream);
 	unlockMainLoop();
 	iterateMainLoop();
 	isCorked = true;
 	stream = nullptr;
+	rBuff.deinit();
 }
 
 bool isOpen()
@@ -346,7 +424,7 @@ bool isPlaying()
 {
 	if(!isOpen())
 		return false;
-	return !isCorked;
+	return !isCorked && !hadUnderrun;
 //	lockMainLoop();
 //	bool isCorked = pa_stream_is_corked(stream);
 //	unlockMainLoop();
@@ -2,6 +2,6 @@ ifndef inc_base_common
 inc_base_common := 1
 
 SRC += base/common/Base.cc base/common/Window.cc \
- base/common/Screen.cc
+ base/common/Screen.cc base/common/SimulatedFrameSource.cc
 
 endif
\ No newline at end of file
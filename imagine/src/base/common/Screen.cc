@@ -15,6 +15,7 @@
 
 #define LOGTAG "Screen"
 #include <imagine/base/Base.hh>
+#include <imagine/base/SimulatedFrameSource.hh>
 #include <imagine/util/time/sys.hh>
 #include "windowPrivate.hh"
 
@@ -175,7 +176,10 @@ uint Screen::elapsedFrames(FrameTimeBase frameTime)
 		return 0;
 	if(unlikely(!timePerFrame))
 	{
-		timePerFrame = frameTimeBaseFromS((double)1./(double)refreshRate());
+		if(auto sim = simulatedFrameSource())
+			timePerFrame = sim->timePerFrame();
+		else
+			timePerFrame = frameTimeBaseFromS((double)1./(double)refreshRate());
 		assert(timePerFrame);
 	}
 	FrameTimeBase diff = frameTime - prevFrameTime;
@@ -0,0 +1,86 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "SimFrameSource"
+#include <imagine/base/SimulatedFrameSource.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+
+namespace Base
+{
+
+static SimulatedFrameSource *simSource{};
+
+// first timestamp, must be non-zero since Screen treats 0 as no previous frame
+static constexpr double startTimeSecs = 1.;
+
+void SimulatedFrameSource::init(double refreshRate, double jitterSecs, uint32 seed)
+{
+	assert(refreshRate > 0);
+	rate = refreshRate;
+	// keep frames in order, jitter can't move a frame past the middle of its neighbor's interval
+	jitter = std::min(std::max(jitterSecs, 0.), .49 / rate);
+	rngState = seed ? seed : 1;
+	vblank = 0;
+	frameCount = 0;
+	missedCount = 0;
+	logMsg("simulating %.3fHz display, %.3fms jitter", rate, jitter * 1000.);
+}
+
+void SimulatedFrameSource::setMissedFrames(uint interval, uint missedFrames)
+{
+	missInterval = interval;
+	missFrames = missedFrames;
+}
+
+uint32 SimulatedFrameSource::nextRandom()
+{
+	// xorshift32
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+FrameTimeBase SimulatedFrameSource::nextFrameTime()
+{
+	if(missInterval && frameCount && frameCount % missInterval == 0)
+	{
+		vblank += missFrames;
+		missedCount += missFrames;
+	}
+	double time = startTimeSecs + (double)vblank / rate;
+	if(jitter > 0)
+	{
+		// uniform in [-jitter, jitter]
+		double offset = (nextRandom() / (double)0xFFFFFFFF) * 2. - 1.;
+		time += offset * jitter;
+	}
+	vblank++;
+	frameCount++;
+	return frameTimeBaseFromS(time);
+}
+
+void setSimulatedFrameSource(SimulatedFrameSource *src)
+{
+	simSource = src;
+}
+
+SimulatedFrameSource *simulatedFrameSource()
+{
+	return simSource;
+}
+
+}
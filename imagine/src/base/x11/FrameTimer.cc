@@ -18,6 +18,8 @@
 #include <imagine/base/Window.hh>
 #include <imagine/base/GLContext.hh>
 #include <imagine/base/EventLoopFileSource.hh>
+#include <imagine/base/SimulatedFrameSource.hh>
+#include <imagine/base/Timer.hh>
 #include <imagine/util/time/sys.hh>
 #include <imagine/util/thread/sys.hh>
 #include <imagine/logger/logger.h>
@@ -118,6 +120,34 @@ static OMLFrameTimer frameTimer;
 static SGIFrameTimer frameTimer;
 #endif
 
+// delivers frames from a SimulatedFrameSource as soon as the event loop is idle
+static Timer simFrameTimer;
+static bool simFrameRequested = false;
+
+static void scheduleSimulatedVSync(SimulatedFrameSource &src)
+{
+	if(simFrameRequested)
+		return;
+	simFrameRequested = true;
+	simFrameTimer.callbackAfterNSec(
+		[&src]()
+		{
+			if(!simFrameRequested)
+				return;
+			simFrameRequested = false;
+			auto frameTime = src.nextFrameTime();
+			iterateTimes(Screen::screens(), i)
+			{
+				auto s = Screen::screen(i);
+				if(s->isPosted())
+				{
+					s->frameUpdate(frameTime);
+					s->prevFrameTime = frameTime;
+				}
+			}
+		}, 1);
+}
+
 void initFrameTimer()
 {
 	if(frameTimer)
@@ -130,11 +160,29 @@ void initFrameTimer()
 
 void frameTimerScheduleVSync()
 {
+	if(auto sim = simulatedFrameSource())
+	{
+		scheduleSimulatedVSync(*sim);
+		return;
+	}
+	// created on first use so a simulated source doesn't require display vsync support
+	initFrameTimer();
 	frameTimer.scheduleVSync();
 }
 
 void frameTimerCancel()
 {
+	if(simulatedFrameSource())
+	{
+		if(simFrameRequested)
+		{
+			simFrameRequested = false;
+			simFrameTimer.cancel();
+		}
+		return;
+	}
+	if(!frameTimer)
+		return;
 	frameTimer.cancel();
 }
 
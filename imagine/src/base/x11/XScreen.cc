@@ -15,9 +15,11 @@
 
 #define LOGTAG "XScreen"
 #include <imagine/base/Screen.hh>
+#include <imagine/base/SimulatedFrameSource.hh>
 #include <imagine/util/time/sys.hh>
 #include <imagine/logger/logger.h>
 #include "internal.hh"
+#include <cmath>
 
 namespace Base
 {
@@ -46,6 +48,8 @@ int Screen::height()
 
 uint Screen::refreshRate()
 {
+	if(auto sim = simulatedFrameSource())
+		return std::round(sim->refreshRate());
 	auto conf = XRRGetScreenInfo(DisplayOfScreen(xScreen), RootWindowOfScreen(xScreen));
 	auto rate = XRRConfigCurrentRate(conf);
 	logMsg("refresh rate %d", (int)rate);
@@ -216,7 +216,6 @@ CallResult initWindowSystem(EventLoopFileSource &eventSrc)
 		return IO_ERROR;
 	}
 	initXScreens();
-	initFrameTimer();
 	doOrAbort(Input::init());
 	eventSrc.initX(ConnectionNumber(dpy));
 	return OK;
@@ -17,11 +17,16 @@
 #include <cctype>
 #include <imagine/resource/face/ResourceFace.hh>
 #include <imagine/gfx/GfxText.hh>
+#include <imagine/gfx/GlyphBatch.hh>
 #include <imagine/util/strings.h>
 
 namespace Gfx
 {
 
+// shared by all Text objects, only ever used from the UI thread
+static GlyphBatch batch;
+static_assert(GlyphBatch::MAX_PAGES >= GlyphAtlas::MAX_PAGES, "GlyphBatch can't index every atlas page");
+
 void Text::deinit()
 {
 	spaceSize = 0;
@@ -173,8 +178,6 @@ void Text::draw(GC xPos, GC yPos, _2DOrigin o, const ProjectionPlane &projP) con
 	//logMsg("drawing with origin: %s,%s", o.toString(o.x), o.toString(o.y));
 	//resetTransforms();
 	setBlendMode(BLEND_MODE_ALPHA);
-	Sprite spr;
-	spr.init(0, 0, 1, 1);
 	_2DOrigin align = o;
 	xPos = o.adjustX(xPos, xSize, LT2DO);
 	//logMsg("aligned to %f, converted to %d", Gfx::alignYToPixel(yPos), toIYPos(Gfx::alignYToPixel(yPos)));
@@ -182,67 +185,90 @@ void Text::draw(GC xPos, GC yPos, _2DOrigin o, const ProjectionPlane &projP) con
 	if(IG::isOdd(projP.viewport.height()))
 		yPos = projP.alignYToPixel(yPos);
 	yPos -= nominalHeight - yLineStart;
-	GC xOrig = xPos;
+	GC xOrig = xPos, yOrig = yPos;
 	
 	//logMsg("drawing text @ %f,%f: str", xPos, yPos, str);
 	auto xViewLimit = projP.wHalf();
-	const char *s = str;
-	uint totalCharsDrawn = 0;
 	if(lines > 1)
 	{
 		assert(lineInfo);
 	}
-	iterateTimes(lines, l)
-	{
-		// Get line info (1 line case doesn't use per-line info)
-		GC xLineSize = lines > 1 ? lineInfo[l].size : xSize;
-		uint charsToDraw = lines > 1 ? lineInfo[l].chars : chars;
-		xPos = projP.alignXToPixel(LT2DO.adjustX(xOrig, xSize-xLineSize, align));
-		//logMsg("line %d, %d chars", l, charsToDraw);
-		iterateTimes(charsToDraw, i)
+	auto &atlas = face->glyphAtlas();
+	const GTexC texScale = 1. / GlyphAtlas::PAGE_SIZE;
+	auto buildBatch =
+		[&]()
 		{
-			uint c;
-			auto res = string_convertCharCode(&s, c);
-			if(res != OK)
+			batch.reset();
+			xPos = xOrig;
+			yPos = yOrig;
+			const char *s = str;
+			uint totalCharsDrawn = 0;
+			iterateTimes(lines, l)
 			{
-				logWarn("failed char conversion while drawing line %d, char %d, result %d", l, i, res);
-				spr.setImg(nullptr);
-				return;
-			}
+				// Get line info (1 line case doesn't use per-line info)
+				GC xLineSize = lines > 1 ? lineInfo[l].size : xSize;
+				uint charsToDraw = lines > 1 ? lineInfo[l].chars : chars;
+				xPos = projP.alignXToPixel(LT2DO.adjustX(xOrig, xSize-xLineSize, align));
+				//logMsg("line %d, %d chars", l, charsToDraw);
+				iterateTimes(charsToDraw, i)
+				{
+					uint c;
+					auto res = string_convertCharCode(&s, c);
+					if(res != OK)
+					{
+						logWarn("failed char conversion while drawing line %d, char %d, result %d", l, i, res);
+						return;
+					}
 
-			if(c == '\n')
-			{
-				continue;
-			}
+					if(c == '\n')
+					{
+						continue;
+					}
 
-			GlyphEntry *gly = face->glyphEntry(c);
-			if(!gly)
-			{
-				//logMsg("no glyph for %X", c);
-				xPos += spaceSize;
-				continue;
+					GlyphEntry *gly = face->glyphEntry(c);
+					if(!gly)
+					{
+						//logMsg("no glyph for %X", c);
+						xPos += spaceSize;
+						continue;
+					}
+					if(xPos >= xViewLimit)
+					{
+						//logMsg("skipped %c, off right screen edge", s[i]);
+						continue;
+					}
+					if(gly->pageGen != GlyphAtlas::NO_BITMAP_GEN)
+					{
+						auto &metrics = gly->metrics;
+						GC xSize = projP.unprojectXSize(metrics.xSize);
+						auto x = xPos + projP.unprojectXSize(metrics.xOffset);
+						auto y = yPos - projP.unprojectYSize(metrics.ySize - metrics.yOffset);
+						GTexC u = gly->x * texScale, v = gly->y * texScale;
+						batch.addQuad(gly->page, x, y, x + xSize, y + projP.unprojectYSize(metrics.ySize),
+							u, v, u + metrics.xSize * texScale, v + metrics.ySize * texScale);
+					}
+					xPos += projP.unprojectXSize(gly->metrics.xAdvance);
+				}
+				yPos -= nominalHeight;
+				yPos = projP.alignYToPixel(yPos);
+				totalCharsDrawn += charsToDraw;
 			}
-			if(xPos >= xViewLimit)
-			{
-				//logMsg("skipped %c, off right screen edge", s[i]);
-				continue;
-			}
-			GC xSize = projP.unprojectXSize(gly->metrics.xSize);
-
-			spr.setImg(&gly->glyph);
-			auto x = xPos + projP.unprojectXSize(gly->metrics.xOffset);
-			auto y = yPos - projP.unprojectYSize(gly->metrics.ySize - gly->metrics.yOffset);
-			spr.setPos(x, y, x + xSize, y + projP.unprojectYSize(gly->metrics.ySize));
-			//logMsg("drawing");
-			spr.draw();
-			xPos += projP.unprojectXSize(gly->metrics.xAdvance);
-		}
-		yPos -= nominalHeight;
-		yPos = projP.alignYToPixel(yPos);
-		totalCharsDrawn += charsToDraw;
+			assert(totalCharsDrawn <= chars);
+		};
+	atlas.beginUse();
+	auto evictions = atlas.evictions();
+	buildBatch();
+	if(atlas.evictions() != evictions)
+	{
+		// a page holding glyphs from earlier in the string was reused, rebuild now that they're re-cached
+		logMsg("rebuilding text batch after glyph page eviction");
+		buildBatch();
+	}
+	iterateTimes(atlas.pages(), p)
+	{
+		if(batch.quads(p))
+			batch.draw(p, *atlas.pageImage(p));
 	}
-	assert(totalCharsDrawn <= chars);
-	spr.setImg(nullptr);
 }
 
 }
@@ -0,0 +1,104 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "GlyphBatch"
+#include <imagine/gfx/GlyphBatch.hh>
+#include <imagine/logger/logger.h>
+
+namespace Gfx
+{
+
+static VertexIndex *quadIdx{};
+static uint quadIdxQuads = 0;
+
+void GlyphBatch::deinit()
+{
+	for(auto &p : pageVerts)
+	{
+		mem_free(p.v);
+		p = {};
+	}
+}
+
+void GlyphBatch::reset()
+{
+	for(auto &p : pageVerts)
+	{
+		p.quads = 0;
+	}
+}
+
+bool GlyphBatch::addQuad(uint page, GC x, GC y, GC x2, GC y2, GTexC u, GTexC v, GTexC u2, GTexC v2)
+{
+	assert(page < MAX_PAGES);
+	auto &p = pageVerts[page];
+	if(p.quads == p.maxQuads)
+	{
+		if(p.maxQuads == MAX_QUADS)
+		{
+			logWarn("too many quads in page %d", page);
+			return false;
+		}
+		uint newMax = std::min(std::max(p.maxQuads * 2, 64u), MAX_QUADS);
+		auto newV = (TexVertex*)mem_realloc(p.v, sizeof(TexVertex) * 4 * newMax);
+		if(!newV)
+		{
+			logErr("out of memory");
+			return false;
+		}
+		p.v = newV;
+		p.maxQuads = newMax;
+	}
+	// same vertex order as QuadGeneric, BL TL BR TR
+	auto vtx = &p.v[p.quads * 4];
+	vtx[0] = {x, y, u, v2};
+	vtx[1] = {x, y2, u, v};
+	vtx[2] = {x2, y, u2, v2};
+	vtx[3] = {x2, y2, u2, v};
+	p.quads++;
+	return true;
+}
+
+const VertexIndex *GlyphBatch::quadIndices(uint quads)
+{
+	assert(quads <= MAX_QUADS);
+	if(quads > quadIdxQuads)
+	{
+		uint newQuads = std::min(std::max(quads, quadIdxQuads * 2), MAX_QUADS);
+		auto newIdx = (VertexIndex*)mem_realloc(quadIdx, sizeof(VertexIndex) * 6 * newQuads);
+		if(!newIdx)
+		{
+			logErr("out of memory");
+			return nullptr;
+		}
+		quadIdx = newIdx;
+		iterateTimesFromStart(newQuads - quadIdxQuads, (int)quadIdxQuads, i)
+		{
+			// Triangle 1, BL TL BR
+			VertexIndex v = i * 4;
+			quadIdx[i*6] = v;
+			quadIdx[i*6 + 1] = v + 1;
+			quadIdx[i*6 + 2] = v + 2;
+			// Triangle 2, BR TL TR
+			quadIdx[i*6 + 3] = v + 2;
+			quadIdx[i*6 + 4] = v + 1;
+			quadIdx[i*6 + 5] = v + 3;
+		}
+		quadIdxQuads = newQuads;
+	}
+	return quadIdx;
+}
+
+}
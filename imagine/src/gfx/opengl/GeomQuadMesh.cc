@@ -14,6 +14,7 @@
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
 #include <imagine/gfx/GeomQuadMesh.hh>
+#include <imagine/gfx/GlyphBatch.hh>
 #include "private.hh"
 
 namespace Gfx
@@ -126,4 +127,26 @@ void GeomQuadMesh::setPos(GC x, GC y, GC x2, GC y2)
 		}
 }
 
+void GlyphBatch::draw(uint page, const BufferImage &img) const
+{
+	auto &p = pageVerts[page];
+	if(!p.quads)
+		return;
+	auto idx = quadIndices(p.quads);
+	if(!idx)
+		return;
+	Gfx::setActiveTexture(img.textureDesc().tid, img.textureDesc().target);
+	if(useVBOFuncs)
+	{
+		glcBindBuffer(GL_ARRAY_BUFFER, globalStreamVBO[globalStreamVBOIdx]);
+		globalStreamVBOIdx = (globalStreamVBOIdx+1) % sizeofArray(globalStreamVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(TexVertex) * 4 * p.quads, p.v, GL_STREAM_DRAW);
+		p.v->draw((TexVertex*)nullptr, idx, Gfx::TRIANGLE, p.quads * 6);
+	}
+	else
+	{
+		p.v->draw(p.v, idx, Gfx::TRIANGLE, p.quads * 6);
+	}
+}
+
 }
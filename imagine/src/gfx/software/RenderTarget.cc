@@ -0,0 +1,62 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gfx/RenderTarget.hh>
+#include <imagine/logger/logger.h>
+#include "private.hh"
+
+namespace Gfx
+{
+
+void RenderTarget::init()
+{
+	isInit = true;
+}
+
+void RenderTarget::deinit()
+{
+	if(tex && softState.target == &tex.textureDesc().tid->pix)
+		setDefaultCurrent();
+	isInit = false;
+	tex.deinit();
+}
+
+void RenderTarget::initTexture(IG::PixmapDesc &pix, uint filter)
+{
+	IG::Pixmap pixmap = pix;
+	tex.init(pixmap, 0, filter, 0);
+	logMsg("set texture %p as render target", tex.textureDesc().tid);
+}
+
+void RenderTarget::setCurrent()
+{
+	if(Config::DEBUG_BUILD && !tex)
+	{
+		bug_exit("render target has no texture");
+	}
+	softState.target = &tex.textureDesc().tid->pix;
+}
+
+void RenderTarget::setDefaultCurrent()
+{
+	softState.target = &framebuffer();
+}
+
+RenderTarget::operator bool() const
+{
+	return isInit;
+}
+
+}
@@ -0,0 +1,16 @@
+ifndef inc_gfx
+inc_gfx := 1
+
+include $(imagineSrcDir)/base/system.mk
+include $(imagineSrcDir)/pixmap/build.mk
+
+configDefs += CONFIG_GFX CONFIG_GFX_SOFTWARE
+
+SRC += gfx/software/software.cc gfx/software/transforms.cc gfx/software/raster.cc \
+ gfx/software/shader.cc gfx/software/texture.cc gfx/software/geometry.cc \
+ gfx/software/GeomQuadMesh.cc gfx/software/RenderTarget.cc gfx/common/ProjectionPlane.cc \
+ gfx/common/GfxText.cc gfx/common/GlyphBatch.cc gfx/common/AnimatedViewport.cc
+
+include $(imagineSrcDir)/util/math/GLM.mk
+
+endif
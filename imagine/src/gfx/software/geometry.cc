@@ -0,0 +1,179 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/gfx/GfxBufferImage.hh>
+#include <imagine/gfx/GeomQuad.hh>
+#include <imagine/gfx/GfxSprite.hh>
+#include <imagine/util/edge.h>
+#include "private.hh"
+
+namespace Gfx
+{
+
+const uint ColVertex::colorOffset = offsetof(ColVertex, color);
+
+const uint TexVertex::textureOffset = offsetof(TexVertex, u);
+
+const uint ColTexVertex::colorOffset = offsetof(ColTexVertex, color);
+const uint ColTexVertex::textureOffset = offsetof(ColTexVertex, u);
+
+static_assertIsPod(Vertex);
+static_assertIsPod(ColVertex);
+static_assertIsPod(TexVertex);
+static_assertIsPod(ColTexVertex);
+
+template<class Vtx>
+static void setColor(Vtx v[4], ColorComp r, ColorComp g, ColorComp b, ColorComp a, uint edges)
+{
+	if(edges & EDGE_BL) v[0].color = VertexColorPixelFormat.build((uint)r, (uint)g, (uint)b, (uint)a);
+	if(edges & EDGE_TL) v[1].color = VertexColorPixelFormat.build((uint)r, (uint)g, (uint)b, (uint)a);
+	if(edges & EDGE_TR) v[3].color = VertexColorPixelFormat.build((uint)r, (uint)g, (uint)b, (uint)a);
+	if(edges & EDGE_BR) v[2].color = VertexColorPixelFormat.build((uint)r, (uint)g, (uint)b, (uint)a);
+}
+
+template<class Vtx>
+static void setColorRGB(Vtx v[4], ColorComp r, ColorComp g, ColorComp b, uint edges)
+{
+	if(edges & EDGE_BL) setColor(v, r, g, b, VertexColorPixelFormat.a(v[0].color), EDGE_BL);
+	if(edges & EDGE_TL) setColor(v, r, g, b, VertexColorPixelFormat.a(v[1].color), EDGE_TL);
+	if(edges & EDGE_TR) setColor(v, r, g, b, VertexColorPixelFormat.a(v[3].color), EDGE_TR);
+	if(edges & EDGE_BR) setColor(v, r, g, b, VertexColorPixelFormat.a(v[2].color), EDGE_BR);
+}
+
+template<class Vtx>
+static void setColorAlpha(Vtx v[4], ColorComp a, uint edges)
+{
+	if(edges & EDGE_BL) setColor(v, VertexColorPixelFormat.r(v[0].color), VertexColorPixelFormat.g(v[0].color), VertexColorPixelFormat.b(v[0].color), a, EDGE_BL);
+	if(edges & EDGE_TL) setColor(v, VertexColorPixelFormat.r(v[1].color), VertexColorPixelFormat.g(v[1].color), VertexColorPixelFormat.b(v[1].color), a, EDGE_TL);
+	if(edges & EDGE_TR) setColor(v, VertexColorPixelFormat.r(v[3].color), VertexColorPixelFormat.g(v[3].color), VertexColorPixelFormat.b(v[3].color), a, EDGE_TR);
+	if(edges & EDGE_BR) setColor(v, VertexColorPixelFormat.r(v[2].color), VertexColorPixelFormat.g(v[2].color), VertexColorPixelFormat.b(v[2].color), a, EDGE_BR);
+}
+
+template<class Vtx>
+CallResult QuadGeneric<Vtx>::init(Coordinate x, Coordinate y, Coordinate x2, Coordinate y2, Coordinate x3, Coordinate y3, Coordinate x4, Coordinate y4)
+{
+	v[0] = Vtx(x, y); //BL
+	v[1] = Vtx(x2, y2); //TL
+	v[2] = Vtx(x4, y4); //BR
+	v[3] = Vtx(x3, y3); //TR
+	return OK;
+}
+
+template<class Vtx>
+void QuadGeneric<Vtx>::deinit() {}
+
+template<class Vtx>
+void QuadGeneric<Vtx>::setPos(GC x, GC y, GC x2, GC y2, GC x3, GC y3, GC x4, GC y4)
+{
+	v[0].x = x; v[0].y = y; //BL
+	v[1].x = x2; v[1].y = y2; //TL
+	v[2].x = x4; v[2].y = y4; //BR
+	v[3].x = x3; v[3].y = y3; //TR
+}
+
+template<class Vtx>
+void QuadGeneric<Vtx>::draw() const
+{
+	if(!Vtx::hasTexture)
+	{
+		Gfx::setActiveTexture(nullptr);
+	}
+	Vtx::draw(v, Gfx::TRIANGLE_STRIP, 4);
+}
+
+template class QuadGeneric<Vertex>;
+template class QuadGeneric<ColVertex>;
+template class QuadGeneric<TexVertex>;
+template class QuadGeneric<ColTexVertex>;
+
+void TexQuad::mapImg(const BufferImage &img) { Gfx::mapImg(v, img.textureDesc()); };
+void TexQuad::mapImg(GTexC leftTexU, GTexC topTexV, GTexC rightTexU, GTexC bottomTexV) { Gfx::mapImg(v, leftTexU, topTexV, rightTexU, bottomTexV); };
+
+void ColQuad::setColor(ColorComp r, ColorComp g, ColorComp b, ColorComp a, uint edges) { Gfx::setColor(v, r, g, b, a, edges); }
+void ColQuad::setColorRGB(ColorComp r, ColorComp g, ColorComp b, uint edges) { Gfx::setColorRGB(v, r, g, b, edges); }
+void ColQuad::setColorAlpha(ColorComp a, uint edges) { Gfx::setColorAlpha(v, a, edges); }
+
+void ColTexQuad::mapImg(const BufferImage &img) { Gfx::mapImg(v, img.textureDesc()); };
+void ColTexQuad::mapImg(GTexC leftTexU, GTexC topTexV, GTexC rightTexU, GTexC bottomTexV) { Gfx::mapImg(v, leftTexU, topTexV, rightTexU, bottomTexV); };
+void ColTexQuad::setColor(ColorComp r, ColorComp g, ColorComp b, ColorComp a, uint edges) { Gfx::setColor(v, r, g, b, a, edges); }
+void ColTexQuad::setColorRGB(ColorComp r, ColorComp g, ColorComp b, uint edges) { Gfx::setColorRGB(v, r, g, b, edges); }
+void ColTexQuad::setColorAlpha(ColorComp a, uint edges) { Gfx::setColorAlpha(v, a, edges); }
+
+template<class BaseRect>
+CallResult SpriteBase<BaseRect>::init(GC x, GC y, GC x2, GC y2, BufferImage *img)
+{
+	BaseRect::init(x, y, x2, y2);
+	setImg(img);
+	return OK;
+}
+
+template<class BaseRect>
+void SpriteBase<BaseRect>::setRefImg(BufferImage *newImg)
+{
+	if(!newImg)
+	{
+		if(img)
+			img->freeRef();
+		img = nullptr;
+		return;
+	}
+
+	newImg->ref();
+	if(img)
+		img->freeRef();
+	img = newImg;
+}
+
+template<class BaseRect>
+void SpriteBase<BaseRect>::setImg(BufferImage *newImg)
+{
+	setRefImg(newImg);
+	if(!newImg)
+		return;
+	Gfx::mapImg(BaseRect::v, newImg->textureDesc());
+}
+
+template<class BaseRect>
+void SpriteBase<BaseRect>::setImg(BufferImage *newImg, GTexC leftTexU, GTexC topTexV, GTexC rightTexU, GTexC bottomTexV)
+{
+	setRefImg(newImg);
+	mapImg(leftTexU, topTexV, rightTexU, bottomTexV);
+}
+
+template<class BaseRect>
+void SpriteBase<BaseRect>::mapImg(GTexC leftTexU, GTexC topTexV, GTexC rightTexU, GTexC bottomTexV)
+{
+	Gfx::mapImg(BaseRect::v, leftTexU, topTexV, rightTexU, bottomTexV);
+}
+
+template<class BaseRect>
+void SpriteBase<BaseRect>::deinit()
+{
+	setRefImg(nullptr);
+	BaseRect::deinit();
+}
+
+template<class BaseRect>
+void SpriteBase<BaseRect>::draw() const
+{
+	Gfx::setActiveTexture(img->textureDesc().tid, img->textureDesc().target);
+	BaseRect::draw();
+}
+
+template class SpriteBase<TexRect>;
+template class SpriteBase<ColTexQuad>;
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/gfx/GfxBufferImage.hh>
+#include <imagine/util/Interpolator.hh>
+
+namespace Gfx
+{
+
+// RGBA components scaled to 0-255
+struct SoftColor
+{
+	uint r = 0, g = 0, b = 0, a = 0;
+
+	constexpr SoftColor() {}
+	constexpr SoftColor(uint r, uint g, uint b, uint a): r{r}, g{g}, b{b}, a{a} {}
+};
+
+struct SoftRect
+{
+	int x = 0, y = 0, x2 = 0, y2 = 0; // framebuffer rows, top-down, x2/y2 exclusive
+};
+
+struct SoftState
+{
+	IG::Pixmap *target{};
+	SoftColor color{255, 255, 255, 255};
+	SoftColor clearColor{0, 0, 0, 255};
+	SoftColor imgBlendColor{};
+	uint blendMode = BLEND_MODE_OFF;
+	uint blendEq = BLEND_EQ_ADD;
+	uint imgMode = IMG_MODE_MODULATE;
+	SoftTexture *tex{};
+	bool clip = false;
+	SoftRect clipRect;
+	IG::Rect2<int> viewport; // in GL format, origin at bottom-left
+	Mat4 modelMat, projMat;
+};
+
+extern SoftState softState;
+extern Base::Window *currWin;
+extern TimedInterpolator<Gfx::GC> projAngleM;
+
+void setImgMode(uint mode);
+void updateWindowFramebuffer(Base::Window &win);
+
+// pixels are loaded as native-endian words, 24-bit as 3 little-endian bytes
+inline uint loadPixel(const char *p, uint bytesPerPixel)
+{
+	switch(bytesPerPixel)
+	{
+		case 1: return *(const uchar*)p;
+		case 2: return *(const uint16*)p;
+		case 3: return ((const uchar*)p)[0] | (((const uchar*)p)[1] << 8) | (((const uchar*)p)[2] << 16);
+		default: return *(const uint32*)p;
+	}
+}
+
+inline void storePixel(char *p, uint bytesPerPixel, uint pixel)
+{
+	switch(bytesPerPixel)
+	{
+		bcase 1: *(uchar*)p = pixel;
+		bcase 2: *(uint16*)p = pixel;
+		bcase 3:
+			((uchar*)p)[0] = pixel;
+			((uchar*)p)[1] = pixel >> 8;
+			((uchar*)p)[2] = pixel >> 16;
+		bdefault: *(uint32*)p = pixel;
+	}
+}
+
+inline uint scaleComponentTo8(uint c, uint bits)
+{
+	switch(bits)
+	{
+		case 0: return 0;
+		case 8: return c;
+		default: return (c * 255) / ((1 << bits) - 1);
+	}
+}
+
+inline uint scaleComponentFrom8(uint c, uint bits)
+{
+	switch(bits)
+	{
+		case 0: return 0;
+		case 8: return c;
+		default: return (c * ((1 << bits) - 1) + 127) / 255;
+	}
+}
+
+inline SoftColor unpackColor(const PixelFormatDesc &format, uint pixel)
+{
+	return
+	{
+		scaleComponentTo8(format.r(pixel), format.rBits),
+		scaleComponentTo8(format.g(pixel), format.gBits),
+		scaleComponentTo8(format.b(pixel), format.bBits),
+		format.aBits ? scaleComponentTo8(format.a(pixel), format.aBits) : 255
+	};
+}
+
+inline uint packColor(const PixelFormatDesc &format, SoftColor c)
+{
+	return format.build(scaleComponentFrom8(c.r, format.rBits),
+		scaleComponentFrom8(c.g, format.gBits),
+		scaleComponentFrom8(c.b, format.bBits),
+		scaleComponentFrom8(c.a, format.aBits));
+}
+
+inline SoftColor toSoftColor(ColorComp r, ColorComp g, ColorComp b, ColorComp a)
+{
+	return
+	{
+		IG::scaleDecToBits<uint>((float)r, 8),
+		IG::scaleDecToBits<uint>((float)g, 8),
+		IG::scaleDecToBits<uint>((float)b, 8),
+		IG::scaleDecToBits<uint>((float)a, 8)
+	};
+}
+
+template<class Vtx>
+inline void mapImg(Vtx v[4], GTexC leftTexU, GTexC topTexV, GTexC rightTexU, GTexC bottomTexV)
+{
+	v[0].u = leftTexU; v[0].v = bottomTexV; //BL
+	v[1].u = leftTexU; v[1].v = topTexV; //TL
+	v[2].u = rightTexU; v[2].v = bottomTexV; //BR
+	v[3].u = rightTexU; v[3].v = topTexV; //TR
+}
+
+template<class Vtx>
+inline void mapImg(Vtx v[4], const Gfx::TextureDesc &img)
+{
+	mapImg(v, img.xStart, img.yStart, img.xEnd, img.yEnd);
+}
+
+}
@@ -0,0 +1,339 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "GfxRaster"
+#include <algorithm>
+#include <cmath>
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/logger/logger.h>
+#include "private.hh"
+
+namespace Gfx
+{
+
+static constexpr int SUBPIXEL_BITS = 4;
+static constexpr int SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+
+struct RasterVertex
+{
+	int64 x = 0, y = 0; // framebuffer position in sub-pixels, rows top-down
+	float invW = 0;
+	float u = 0, v = 0;
+	float r = 0, g = 0, b = 0, a = 0;
+};
+
+static uint mul8(uint a, uint b)
+{
+	return (a * b + 127) / 255;
+}
+
+static uint clamp8(int c)
+{
+	return std::min(std::max(c, 0), 255);
+}
+
+static int wrapCoord(int c, int size, bool repeat)
+{
+	if(repeat)
+	{
+		c %= size;
+		return c < 0 ? c + size : c;
+	}
+	return std::min(std::max(c, 0), size - 1);
+}
+
+static SoftColor texel(const SoftTexture &tex, int x, int y)
+{
+	auto &pix = tex.pix;
+	x = wrapCoord(x, pix.x, tex.repeatX);
+	y = wrapCoord(y, pix.y, tex.repeatY);
+	return unpackColor(pix.format, loadPixel(pix.getPixel(x, y), 4));
+}
+
+static SoftColor sampleTexture(const SoftTexture &tex, float u, float v)
+{
+	float x = u * tex.pix.x, y = v * tex.pix.y;
+	if(tex.filter == BufferImage::NEAREST)
+	{
+		return texel(tex, std::floor(x), std::floor(y));
+	}
+	x -= .5f;
+	y -= .5f;
+	int x0 = std::floor(x), y0 = std::floor(y);
+	uint fx = (x - x0) * 256.f, fy = (y - y0) * 256.f;
+	auto c00 = texel(tex, x0, y0), c10 = texel(tex, x0 + 1, y0),
+		c01 = texel(tex, x0, y0 + 1), c11 = texel(tex, x0 + 1, y0 + 1);
+	auto lerp2D =
+		[=](uint c00, uint c10, uint c01, uint c11)
+		{
+			uint top = c00 * (256 - fx) + c10 * fx;
+			uint bottom = c01 * (256 - fx) + c11 * fx;
+			return (top * (256 - fy) + bottom * fy) >> 16;
+		};
+	return
+	{
+		lerp2D(c00.r, c10.r, c01.r, c11.r),
+		lerp2D(c00.g, c10.g, c01.g, c11.g),
+		lerp2D(c00.b, c10.b, c01.b, c11.b),
+		lerp2D(c00.a, c10.a, c01.a, c11.a)
+	};
+}
+
+// applies the texture environment the same way as the fixed function OpenGL pipeline
+static SoftColor shadeTexel(SoftColor frag, SoftColor tex, const PixelFormatDesc &texFormat)
+{
+	bool alphaOnly = !texFormat.hasColorComponent();
+	switch(softState.imgMode)
+	{
+		case IMG_MODE_REPLACE:
+			if(alphaOnly)
+				return {frag.r, frag.g, frag.b, tex.a};
+			return {tex.r, tex.g, tex.b, texFormat.aBits ? tex.a : frag.a};
+		case IMG_MODE_ADD:
+			return {clamp8(frag.r + tex.r), clamp8(frag.g + tex.g), clamp8(frag.b + tex.b), mul8(frag.a, tex.a)};
+		case IMG_MODE_BLEND:
+		{
+			auto &env = softState.imgBlendColor;
+			return
+			{
+				mul8(frag.r, 255 - tex.r) + mul8(env.r, tex.r),
+				mul8(frag.g, 255 - tex.g) + mul8(env.g, tex.g),
+				mul8(frag.b, 255 - tex.b) + mul8(env.b, tex.b),
+				mul8(frag.a, tex.a)
+			};
+		}
+		default: // IMG_MODE_MODULATE
+			if(alphaOnly)
+				return {frag.r, frag.g, frag.b, mul8(frag.a, tex.a)};
+			return {mul8(frag.r, tex.r), mul8(frag.g, tex.g), mul8(frag.b, tex.b), mul8(frag.a, tex.a)};
+	}
+}
+
+static uint blendComponent(uint src, uint dest, uint srcFactor, uint destFactor)
+{
+	int s = mul8(src, srcFactor), d = mul8(dest, destFactor);
+	switch(softState.blendEq)
+	{
+		case BLEND_EQ_SUB: return clamp8(s - d);
+		case BLEND_EQ_RSUB: return clamp8(d - s);
+		default: return clamp8(s + d);
+	}
+}
+
+static void writeFragment(char *p, const PixelFormatDesc &format, SoftColor c)
+{
+	if(softState.blendMode != BLEND_MODE_OFF)
+	{
+		auto dest = unpackColor(format, loadPixel(p, format.bytesPerPixel));
+		uint destFactor = softState.blendMode == BLEND_MODE_INTENSITY ? 255 : 255 - c.a;
+		c = {blendComponent(c.r, dest.r, c.a, destFactor),
+			blendComponent(c.g, dest.g, c.a, destFactor),
+			blendComponent(c.b, dest.b, c.a, destFactor),
+			blendComponent(c.a, dest.a, c.a, destFactor)};
+	}
+	storePixel(p, format.bytesPerPixel, packColor(format, c));
+}
+
+static int64 edge(const RasterVertex &a, const RasterVertex &b, int64 px, int64 py)
+{
+	return (px - a.x) * (b.y - a.y) - (py - a.y) * (b.x - a.x);
+}
+
+// top-left fill rule so pixels on an edge shared by two triangles are only drawn once,
+// which matters for blended quads split into triangle strips
+static bool edgeOwnsTies(const RasterVertex &a, const RasterVertex &b)
+{
+	auto dy = b.y - a.y, dx = b.x - a.x;
+	return dy > 0 || (dy == 0 && dx > 0);
+}
+
+static SoftRect drawBounds(const IG::Pixmap &pix)
+{
+	auto &vp = softState.viewport;
+	SoftRect r {vp.x, (int)pix.y - (vp.y + vp.y2), vp.x + vp.x2, (int)pix.y - vp.y};
+	r.x = std::max(r.x, 0);
+	r.y = std::max(r.y, 0);
+	r.x2 = std::min(r.x2, (int)pix.x);
+	r.y2 = std::min(r.y2, (int)pix.y);
+	if(softState.clip)
+	{
+		auto &c = softState.clipRect;
+		r.x = std::max(r.x, c.x);
+		r.y = std::max(r.y, c.y);
+		r.x2 = std::min(r.x2, c.x2);
+		r.y2 = std::min(r.y2, c.y2);
+	}
+	return r;
+}
+
+static void rasterTriangle(RasterVertex v0, RasterVertex v1, RasterVertex v2, bool hasTex)
+{
+	auto &pix = *softState.target;
+	int64 area = edge(v0, v1, v2.x, v2.y);
+	if(!area)
+		return;
+	if(area < 0)
+	{
+		std::swap(v1, v2);
+		area = -area;
+	}
+	auto bounds = drawBounds(pix);
+	int minX = std::max((int)(std::min({v0.x, v1.x, v2.x}) >> SUBPIXEL_BITS), bounds.x);
+	int minY = std::max((int)(std::min({v0.y, v1.y, v2.y}) >> SUBPIXEL_BITS), bounds.y);
+	int maxX = std::min((int)((std::max({v0.x, v1.x, v2.x}) + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS), bounds.x2);
+	int maxY = std::min((int)((std::max({v0.y, v1.y, v2.y}) + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS), bounds.y2);
+	if(minX >= maxX || minY >= maxY)
+		return;
+
+	bool tie0 = edgeOwnsTies(v1, v2), tie1 = edgeOwnsTies(v2, v0), tie2 = edgeOwnsTies(v0, v1);
+	// edge function steps per pixel
+	int64 e0dx = (v2.y - v1.y) * SUBPIXEL_ONE, e0dy = -(v2.x - v1.x) * SUBPIXEL_ONE;
+	int64 e1dx = (v0.y - v2.y) * SUBPIXEL_ONE, e1dy = -(v0.x - v2.x) * SUBPIXEL_ONE;
+	int64 e2dx = (v1.y - v0.y) * SUBPIXEL_ONE, e2dy = -(v1.x - v0.x) * SUBPIXEL_ONE;
+	int64 centerX = ((int64)minX << SUBPIXEL_BITS) + SUBPIXEL_ONE / 2;
+	int64 centerY = ((int64)minY << SUBPIXEL_BITS) + SUBPIXEL_ONE / 2;
+	int64 e0Row = edge(v1, v2, centerX, centerY);
+	int64 e1Row = edge(v2, v0, centerX, centerY);
+	int64 e2Row = edge(v0, v1, centerX, centerY);
+	float invArea = 1.f / (float)area;
+	auto *tex = hasTex ? softState.tex : nullptr;
+	uint bpp = pix.format.bytesPerPixel;
+	for(int y = minY; y < maxY; y++)
+	{
+		int64 e0 = e0Row, e1 = e1Row, e2 = e2Row;
+		char *p = pix.getPixel(minX, y);
+		for(int x = minX; x < maxX; x++, p += bpp, e0 += e0dx, e1 += e1dx, e2 += e2dx)
+		{
+			if(e0 < 0 || e1 < 0 || e2 < 0
+				|| (e0 == 0 && !tie0) || (e1 == 0 && !tie1) || (e2 == 0 && !tie2))
+				continue;
+			// perspective-correct barycentric weights
+			float l0 = e0 * invArea * v0.invW, l1 = e1 * invArea * v1.invW, l2 = e2 * invArea * v2.invW;
+			float norm = 1.f / (l0 + l1 + l2);
+			l0 *= norm; l1 *= norm; l2 *= norm;
+			SoftColor frag
+			{
+				(uint)clamp8(l0 * v0.r + l1 * v1.r + l2 * v2.r + .5f),
+				(uint)clamp8(l0 * v0.g + l1 * v1.g + l2 * v2.g + .5f),
+				(uint)clamp8(l0 * v0.b + l1 * v1.b + l2 * v2.b + .5f),
+				(uint)clamp8(l0 * v0.a + l1 * v1.a + l2 * v2.a + .5f)
+			};
+			if(tex)
+			{
+				auto t = sampleTexture(*tex, l0 * v0.u + l1 * v1.u + l2 * v2.u, l0 * v0.v + l1 * v1.v + l2 * v2.v);
+				frag = shadeTexel(frag, t, *tex->srcFormat);
+			}
+			writeFragment(p, pix.format, frag);
+		}
+		e0Row += e0dy;
+		e1Row += e1dy;
+		e2Row += e2dy;
+	}
+}
+
+template<class Vtx>
+static bool transformVertex(const Mat4 &mvp, const IG::Pixmap &pix, const Vtx &vtx, RasterVertex &out)
+{
+	auto clip = mvp.mult({vtx.x, vtx.y, 0., 1.}).v;
+	if(clip.w <= 0)
+		return false;
+	float invW = 1.f / clip.w;
+	auto &vp = softState.viewport;
+	float winX = vp.x + (clip.x * invW + 1.f) * .5f * vp.x2;
+	float winY = vp.y + (clip.y * invW + 1.f) * .5f * vp.y2;
+	out.x = std::lround(winX * SUBPIXEL_ONE);
+	out.y = std::lround(((float)pix.y - winY) * SUBPIXEL_ONE);
+	out.invW = invW;
+	if(Vtx::hasColor)
+	{
+		auto color = *(const VertexColor*)((const char*)&vtx + Vtx::colorOffset);
+		out.r = VertexColorPixelFormat.r(color);
+		out.g = VertexColorPixelFormat.g(color);
+		out.b = VertexColorPixelFormat.b(color);
+		out.a = VertexColorPixelFormat.a(color);
+	}
+	else
+	{
+		auto &c = softState.color;
+		out.r = c.r; out.g = c.g; out.b = c.b; out.a = c.a;
+	}
+	if(Vtx::hasTexture)
+	{
+		auto texC = (const TextureCoordinate*)((const char*)&vtx + Vtx::textureOffset);
+		out.u = texC[0];
+		out.v = texC[1];
+	}
+	return true;
+}
+
+template<class Vtx, class IdxFunc>
+static void drawPrimitives(const Vtx *v, IdxFunc idx, uint type, uint count)
+{
+	auto pix = softState.target;
+	if(!pix || !pix->data || count < 3)
+		return;
+	Mat4 mvp {softState.projMat.m * softState.modelMat.m};
+	bool hasTex = Vtx::hasTexture && softState.tex;
+	auto drawTri =
+		[&](uint i0, uint i1, uint i2)
+		{
+			RasterVertex r0, r1, r2;
+			if(!transformVertex(mvp, *pix, v[idx(i0)], r0)
+				|| !transformVertex(mvp, *pix, v[idx(i1)], r1)
+				|| !transformVertex(mvp, *pix, v[idx(i2)], r2))
+			{
+				// geometry crossing the near plane isn't used by the UI
+				logWarn("skipped triangle behind camera");
+				return;
+			}
+			rasterTriangle(r0, r1, r2, hasTex);
+		};
+	switch(type)
+	{
+		bcase TRIANGLE:
+			for(uint i = 0; i + 2 < count; i += 3)
+				drawTri(i, i + 1, i + 2);
+		bcase TRIANGLE_STRIP:
+			for(uint i = 0; i + 2 < count; i++)
+				drawTri(i, i + 1, i + 2);
+		bcase QUAD:
+			for(uint i = 1; i + 1 < count; i++)
+				drawTri(0, i, i + 1);
+		bdefault: bug_branch("%d", type);
+	}
+}
+
+template<class Vtx>
+void VertexInfo::draw(const Vtx *v, uint type, uint count)
+{
+	drawPrimitives(v, [](uint i){ return i; }, type, count);
+}
+
+template<class Vtx>
+void VertexInfo::draw(const Vtx *v, const VertexIndex *idx, uint type, uint count)
+{
+	drawPrimitives(v, [idx](uint i){ return (uint)idx[i]; }, type, count);
+}
+
+template void VertexInfo::draw<Vertex>(const Vertex *v, uint type, uint count);
+template void VertexInfo::draw<Vertex>(const Vertex *v, const VertexIndex *idx, uint type, uint count);
+template void VertexInfo::draw<ColVertex>(const ColVertex *v, uint type, uint count);
+template void VertexInfo::draw<ColVertex>(const ColVertex *v, const VertexIndex *idx, uint type, uint count);
+template void VertexInfo::draw<TexVertex>(const TexVertex *v, uint type, uint count);
+template void VertexInfo::draw<TexVertex>(const TexVertex *v, const VertexIndex *idx, uint type, uint count);
+template void VertexInfo::draw<ColTexVertex>(const ColTexVertex *v, uint type, uint count);
+template void VertexInfo::draw<ColTexVertex>(const ColTexVertex *v, const VertexIndex *idx, uint type, uint count);
+
+}
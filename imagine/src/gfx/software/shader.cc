@@ -0,0 +1,97 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/gfx/GfxBufferImage.hh>
+#include "private.hh"
+
+namespace Gfx
+{
+
+bool Program::init(Shader vShader, Shader fShader, bool hasColor, bool hasTex)
+{
+	return false;
+}
+
+void Program::deinit() {}
+
+bool Program::link()
+{
+	return false;
+}
+
+int Program::uniformLocation(const char *uniformName)
+{
+	return -1;
+}
+
+Shader makeShader(const char *src, uint type)
+{
+	return 0;
+}
+
+Shader makePluginVertexShader(const char *src, uint imgMode)
+{
+	return 0;
+}
+
+Shader makePluginFragmentShader(const char *src, uint imgMode, bool isExternalTex)
+{
+	return 0;
+}
+
+Shader makeDefaultVShader()
+{
+	return 0;
+}
+
+void deleteShader(Shader shader) {}
+
+void uniformF(int uniformLocation, float v1, float v2)
+{
+	bug_exit("called uniformF() without shader support");
+}
+
+void setProgram(Program &program)
+{
+	bug_exit("called setProgram() without shader support");
+}
+
+void setProgram(Program &program, Mat4 modelMat)
+{
+	bug_exit("called setProgram() without shader support");
+}
+
+void DefaultProgram::use(const Mat4 *modelMat)
+{
+	if(!hasTex)
+		setActiveTexture(nullptr);
+	setImgMode(imgMode);
+	if(modelMat)
+		loadTransform(*modelMat);
+}
+
+DefaultTexReplaceProgram texReplaceProgram{IMG_MODE_REPLACE, true};
+DefaultTexAlphaReplaceProgram texAlphaReplaceProgram{IMG_MODE_REPLACE, true};
+DefaultTexIntensityAlphaReplaceProgram texIntensityAlphaReplaceProgram{IMG_MODE_REPLACE, true};
+DefaultTexExternalReplaceProgram texExternalReplaceProgram{IMG_MODE_REPLACE, true};
+
+DefaultTexProgram texProgram{IMG_MODE_MODULATE, true};
+DefaultTexAlphaProgram texAlphaProgram{IMG_MODE_MODULATE, true};
+DefaultTexIntensityAlphaProgram texIntensityAlphaProgram{IMG_MODE_MODULATE, true};
+DefaultTexExternalProgram texExternalProgram{IMG_MODE_MODULATE, true};
+DefaultColorProgram noTexProgram{IMG_MODE_MODULATE, false};
+
+}
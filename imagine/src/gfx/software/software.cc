@@ -0,0 +1,319 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "GfxSoftware"
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/base/Base.hh>
+#include <imagine/base/Window.hh>
+#include "private.hh"
+
+namespace Gfx
+{
+
+SoftState softState;
+Base::Window *currWin{};
+TimedInterpolator<Gfx::GC> projAngleM;
+bool preferBGRA = false, preferBGR = false;
+static IG::ManagedPixmap windowFramebuffer{PixelFormatRGBA8888};
+static IG::Pixmap *appFramebuffer{};
+static Viewport currViewport;
+static PresentDelegate onPresent;
+
+TextureSizeSupport textureSizeSupport =
+{
+	1, // nonPow2
+	1, // nonSquare
+	1, // filtering
+	1, // nonPow2CanMipmap
+	0, 0, // minXSize, minYSize
+	8192, 8192 // maxXSize, maxYSize
+};
+
+CallResult init()
+{
+	return init(defaultColorBits());
+}
+
+CallResult init(uint colorBits)
+{
+	logMsg("running init, using software rasterizer");
+	setClearColor(0., 0., 0.);
+	setColor(COLOR_WHITE);
+	return OK;
+}
+
+uint defaultColorBits()
+{
+	return 24;
+}
+
+Base::WindowConfig makeWindowConfig()
+{
+	Base::WindowConfig config;
+	setWindowConfig(config);
+	return config;
+}
+
+void setWindowConfig(Base::WindowConfig &config) {}
+
+void initWindow(Base::Window &win, Base::WindowConfig config)
+{
+	setWindowConfig(config);
+	win.init(config);
+}
+
+void setWindowValidOrientations(Base::Window &win, uint validO)
+{
+	if(win != Base::mainWindow())
+		return;
+	win.setValidOrientations(validO);
+}
+
+void setFramebuffer(IG::Pixmap &pix)
+{
+	appFramebuffer = &pix;
+	softState.target = appFramebuffer;
+}
+
+IG::Pixmap &framebuffer()
+{
+	return appFramebuffer ? *appFramebuffer : (IG::Pixmap&)windowFramebuffer;
+}
+
+void updateWindowFramebuffer(Base::Window &win)
+{
+	if(appFramebuffer)
+		return;
+	uint x = win.realWidth(), y = win.realHeight();
+	if(windowFramebuffer.x != x || windowFramebuffer.y != y)
+	{
+		logMsg("allocating %dx%d framebuffer", x, y);
+		windowFramebuffer.init(x, y);
+	}
+}
+
+void setOnPresent(PresentDelegate del)
+{
+	onPresent = del;
+}
+
+void setActiveTexture(TextureHandle texture, uint type)
+{
+	softState.tex = texture;
+}
+
+void setZTest(bool on)
+{
+	if(on)
+		logWarn("depth testing not supported");
+}
+
+void setBlendMode(uint mode)
+{
+	softState.blendMode = mode;
+}
+
+void setBlendEquation(uint mode)
+{
+	softState.blendEq = mode;
+}
+
+void setImgMode(uint mode)
+{
+	softState.imgMode = mode;
+}
+
+void setImgBlendColor(ColorComp r, ColorComp g, ColorComp b, ColorComp a)
+{
+	softState.imgBlendColor = toSoftColor(r, g, b, a);
+}
+
+void setZBlend(bool on) {}
+
+void setZBlendColor(ColorComp r, ColorComp g, ColorComp b) {}
+
+void setColor(ColorComp r, ColorComp g, ColorComp b, ColorComp a)
+{
+	softState.color = toSoftColor(r, g, b, a);
+}
+
+uint color()
+{
+	auto &c = softState.color;
+	return ColorFormat.build(c.r, c.g, c.b, c.a);
+}
+
+void setVisibleGeomFace(uint faces)
+{
+	// all geometry is 2D in the UI, triangles are rasterized regardless of winding
+}
+
+void setClipRect(bool on)
+{
+	softState.clip = on;
+}
+
+void setClipRectBounds(const Base::Window &win, int x, int y, int w, int h)
+{
+	// translate from view to framebuffer rows
+	if(!Config::SYSTEM_ROTATES_WINDOWS)
+	{
+		using namespace Base;
+		switch(win.softOrientation())
+		{
+			bcase VIEW_ROTATE_90:
+				std::swap(x, y);
+				std::swap(w, h);
+				x = (win.realWidth() - x) - w;
+			bcase VIEW_ROTATE_270:
+				std::swap(x, y);
+				std::swap(w, h);
+				y = (win.realHeight() - y) - h;
+			bcase VIEW_ROTATE_180:
+				x = (win.realWidth() - x) - w;
+				y = (win.realHeight() - y) - h;
+		}
+	}
+	softState.clipRect = {x, y, x + w, y + h};
+}
+
+void setClearColor(ColorComp r, ColorComp g, ColorComp b, ColorComp a)
+{
+	softState.clearColor = toSoftColor(r, g, b, a);
+}
+
+void setDither(uint on) {}
+
+uint dither()
+{
+	return 0;
+}
+
+void releaseShaderCompiler() {}
+
+void autoReleaseShaderCompiler() {}
+
+void clear()
+{
+	auto pix = softState.target;
+	if(!pix || !pix->data)
+		return;
+	auto clearPixel = packColor(pix->format, softState.clearColor);
+	uint bpp = pix->format.bytesPerPixel;
+	iterateTimes(pix->y, y)
+	{
+		auto p = pix->getPixel(0, y);
+		iterateTimes(pix->x, x)
+		{
+			storePixel(p, bpp, clearPixel);
+			p += bpp;
+		}
+	}
+}
+
+bool setCurrentWindow(Base::Window *win)
+{
+	if(win == currWin)
+		return false;
+	currWin = win;
+	if(win)
+	{
+		updateWindowFramebuffer(*win);
+		softState.target = &framebuffer();
+	}
+	return true;
+}
+
+bool updateCurrentWindow(Base::Window &win, Base::Window::DrawParams params, Viewport viewport, Mat4 projMat)
+{
+	if(setCurrentWindow(&win) || params.wasResized())
+	{
+		updateWindowFramebuffer(win);
+		softState.target = &framebuffer();
+		setViewport(viewport);
+		setProjectionMatrix(projMat);
+		return true;
+	}
+	return false;
+}
+
+void presentWindow(Base::Window &win)
+{
+	if(onPresent)
+		onPresent(win, framebuffer());
+}
+
+void setViewport(const Viewport &v)
+{
+	softState.viewport = v.inGLFormat();
+	currViewport = v;
+}
+
+const Viewport &viewport()
+{
+	return currViewport;
+}
+
+Viewport Viewport::makeFromRect(const IG::WindowRect &fullRect, const IG::WindowRect &fullRealRect, const IG::WindowRect &rect)
+{
+	Viewport v;
+	v.rect = rect;
+	v.w = rect.xSize();
+	v.h = rect.ySize();
+	v.wMM = 1;
+	v.hMM = 1;
+	#ifdef __ANDROID__
+	v.wSMM = 1;
+	v.hSMM = 1;
+	#endif
+	#ifdef CONFIG_GFX_SOFT_ORIENTATION
+	v.softOrientation_ = 0;
+	#endif
+	v.relYFlipViewport = {v.realBounds().x, fullRealRect.ySize() - v.realBounds().y2, v.realWidth(), v.realHeight()};
+	return v;
+}
+
+Viewport Viewport::makeFromWindow(const Base::Window &win, const IG::WindowRect &rect)
+{
+	Viewport v;
+	v.rect = rect;
+	v.w = rect.xSize();
+	v.h = rect.ySize();
+	float wScaler = v.w / (float)win.width();
+	float hScaler = v.h / (float)win.height();
+	v.wMM = win.widthMM() * wScaler;
+	v.hMM = win.heightMM() * hScaler;
+	#ifdef __ANDROID__
+	v.wSMM = win.widthSMM() * wScaler;
+	v.hSMM = win.heightSMM() * hScaler;
+	#endif
+	#ifdef CONFIG_GFX_SOFT_ORIENTATION
+	v.softOrientation_ = win.softOrientation();
+	#endif
+	// same bottom-left origin as glViewport(), the rasterizer flips Y when writing rows
+	v.relYFlipViewport = {v.realBounds().x, win.realHeight() - v.realBounds().y2, v.realWidth(), v.realHeight()};
+	return v;
+}
+
+void setCorrectnessChecks(bool on)
+{
+	if(on)
+	{
+		logWarn("no state verification in software rasterizer");
+	}
+}
+
+}
@@ -0,0 +1,186 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "GfxSoftTexture"
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/gfx/GfxBufferImage.hh>
+#include <imagine/logger/logger.h>
+#include "private.hh"
+
+namespace Gfx
+{
+
+void SoftTexture::write(const IG::Pixmap &src)
+{
+	if(src.x > pix.x || src.y > pix.y)
+	{
+		logWarn("pixmap %dx%d larger than texture %dx%d", src.x, src.y, pix.x, pix.y);
+	}
+	uint x = std::min(src.x, pix.x), y = std::min(src.y, pix.y);
+	auto &format = src.format;
+	bool alphaOnly = !format.hasColorComponent();
+	iterateTimes(y, yIdx)
+	{
+		auto s = src.getPixel(0, yIdx);
+		auto d = pix.getPixel(0, yIdx);
+		iterateTimes(x, xIdx)
+		{
+			auto c = unpackColor(format, loadPixel(s, format.bytesPerPixel));
+			if(alphaOnly)
+				c = {255, 255, 255, c.a};
+			storePixel(d, 4, packColor(pix.format, c));
+			s += format.bytesPerPixel;
+			d += 4;
+		}
+	}
+}
+
+uint BufferImage::bestAlignment(const IG::Pixmap &p)
+{
+	return 1;
+}
+
+bool BufferImage::hasMipmaps()
+{
+	return false;
+}
+
+void BufferImage::setFilter(uint filter)
+{
+	if(textureDesc().tid)
+		textureDesc().tid->filter = filter;
+}
+
+void BufferImage::setRepeatMode(uint xMode, uint yMode)
+{
+	if(!textureDesc().tid)
+		return;
+	textureDesc().tid->repeatX = xMode;
+	textureDesc().tid->repeatY = yMode;
+}
+
+void TextureBufferImage::write(IG::Pixmap &p, uint hints, uint alignment)
+{
+	write(p, hints);
+}
+
+void TextureBufferImage::write(IG::Pixmap &p, uint hints)
+{
+	desc.tid->srcFormat = &p.format;
+	desc.tid->write(p);
+}
+
+void TextureBufferImage::replace(IG::Pixmap &p, uint hints)
+{
+	desc.tid->pix.init(p.x, p.y);
+	write(p, hints);
+}
+
+IG::Pixmap *TextureBufferImage::lock(uint x, uint y, uint xlen, uint ylen, IG::Pixmap *fallback) { return fallback; }
+
+void TextureBufferImage::unlock(IG::Pixmap *pix, uint hints) { write(*pix, hints); }
+
+void TextureBufferImage::deinit()
+{
+	logMsg("freeing texture %p", desc.tid);
+	desc.tid->pix.deinit();
+	delete desc.tid;
+	desc.tid = nullptr;
+}
+
+static SoftTexture *newTexture(const PixelFormatDesc &format, uint x, uint y, uint filter, bool textured)
+{
+	auto tex = new SoftTexture;
+	tex->pix.init(x, y);
+	mem_zero(tex->pix.data, tex->pix.size());
+	tex->srcFormat = &format;
+	tex->filter = filter;
+	tex->repeatX = tex->repeatY = textured;
+	return tex;
+}
+
+bool BufferImage::compileDefaultProgram(uint mode)
+{
+	return false;
+}
+
+void BufferImage::useDefaultProgram(uint mode, const Mat4 *modelMat)
+{
+	// texture format is handled when sampling, only the environment mode matters
+	switch(mode)
+	{
+		bcase IMG_MODE_REPLACE: texReplaceProgram.use(modelMat);
+		bcase IMG_MODE_MODULATE: texProgram.use(modelMat);
+	}
+}
+
+CallResult BufferImage::init(GfxImageSource &img, uint filter, uint hints, bool textured)
+{
+	deinit();
+
+	var_selfs(hints);
+	auto pixFmt = img.pixelFormat();
+	IG::ManagedPixmap texPix(*pixFmt);
+	texPix.init(img.width(), img.height());
+	mem_zero(texPix.data, texPix.size());
+	img.getImage(texPix);
+	logMsg("creating texture with size %dx%d from image %s", texPix.x, texPix.y, pixFmt->name);
+	textureDesc().tid = newTexture(*pixFmt, texPix.x, texPix.y, filter, textured);
+	textureDesc().tid->write(texPix);
+	texPix.deinit();
+
+	textureDesc().xStart = 0;
+	textureDesc().yStart = 0;
+	textureDesc().xEnd = 1;
+	textureDesc().yEnd = 1;
+	return OK;
+}
+
+CallResult BufferImage::init(IG::Pixmap &pix, bool upload, uint filter, uint hints, bool textured)
+{
+	deinit();
+
+	var_selfs(hints);
+	logMsg("%s texture with size %dx%d, format %s", upload ? "uploading" : "creating", pix.x, pix.y, pix.format.name);
+	textureDesc().tid = newTexture(pix.format, pix.x, pix.y, filter, textured);
+	textureDesc().xStart = 0;
+	textureDesc().yStart = 0;
+	textureDesc().xEnd = 1;
+	textureDesc().yEnd = 1;
+
+	if(upload)
+	{
+		write(pix);
+	}
+
+	return OK;
+}
+
+void BufferImage::write(IG::Pixmap &p) { BufferImageImpl::write(p, hints); }
+void BufferImage::write(IG::Pixmap &p, uint assumeAlign) { BufferImageImpl::write(p, hints, assumeAlign); }
+void BufferImage::replace(IG::Pixmap &p)
+{
+	BufferImageImpl::replace(p, hints);
+}
+void BufferImage::unlock(IG::Pixmap *p) { BufferImageImpl::unlock(p, hints); }
+
+void BufferImage::deinit()
+{
+	if(!isInit())
+		return;
+	BufferImageImpl::deinit();
+}
+
+}
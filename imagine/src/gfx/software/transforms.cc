@@ -0,0 +1,91 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gfx/Gfx.hh>
+#include <imagine/base/Base.hh>
+#include <imagine/logger/logger.h>
+#include "private.hh"
+
+namespace Gfx
+{
+
+static Angle projectionMatRot = 0;
+static Mat4 projectionMatPreTransformed;
+
+void setProjectionMatrixRotation(Angle angle)
+{
+	projectionMatRot = angle;
+}
+
+const Mat4 &projectionMatrix()
+{
+	return projectionMatPreTransformed;
+}
+
+void setProjectionMatrix(const Mat4 &mat)
+{
+	projectionMatPreTransformed = mat;
+	if(projectionMatRot)
+	{
+		logMsg("rotated projection matrix by %f degrees", (double)IG::toDegrees(projectionMatRot));
+		softState.projMat = mat.rollRotate(projectionMatRot);
+	}
+	else
+	{
+		softState.projMat = mat;
+	}
+}
+
+void animateProjectionMatrixRotation(Angle srcAngle, Angle destAngle)
+{
+	Gfx::projAngleM.set(srcAngle, destAngle, INTERPOLATOR_TYPE_EASEOUTQUAD, 10);
+	Base::mainScreen().addOnFrameOnce(
+		[](Base::Screen &screen, Base::Screen::FrameParams params)
+		{
+			using namespace Base;
+			setCurrentWindow(&mainWindow());
+			projAngleM.update(1);
+			setProjectionMatrixRotation(projAngleM.now());
+			setProjectionMatrix(projectionMatrix());
+			mainWindow().setNeedsDraw(true);
+			if(!projAngleM.isComplete())
+			{
+				screen.postOnFrame(params.thisOnFrame());
+			}
+		});
+}
+
+void setTransformTarget(TransformTargetEnum target)
+{
+	if(target == TARGET_TEXTURE)
+		bug_exit("texture matrix not supported");
+}
+
+void loadTransform(Mat4 mat)
+{
+	softState.modelMat = mat;
+}
+
+void loadTranslate(TransformCoordinate x, TransformCoordinate y, TransformCoordinate z)
+{
+	loadTransform(Mat4::makeTranslate({x, y, z}));
+}
+
+void loadIdentTransform()
+{
+	loadTransform({});
+}
+
+}
@@ -1 +1,7 @@
-include $(imagineSrcDir)/gfx/opengl/build.mk
+gfxAPI ?= opengl
+
+ifeq ($(gfxAPI), software)
+ include $(imagineSrcDir)/gfx/software/build.mk
+else
+ include $(imagineSrcDir)/gfx/opengl/build.mk
+endif
@@ -0,0 +1,200 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "GlyphAtlas"
+
+#include <imagine/resource/face/GlyphAtlas.hh>
+#include <imagine/logger/logger.h>
+
+void GlyphShelfPacker::init(uint width, uint height)
+{
+	w = width;
+	h = height;
+	reset();
+}
+
+void GlyphShelfPacker::reset()
+{
+	usedShelves = 0;
+	yEnd = 0;
+}
+
+bool GlyphShelfPacker::pack(uint rectW, uint rectH, uint &x, uint &y)
+{
+	if(rectW > w || rectH > h)
+		return false;
+	// find the shelf with the least wasted height that still has room
+	int bestShelf = -1;
+	uint bestWaste = ~0;
+	iterateTimes(usedShelves, i)
+	{
+		auto &s = shelf[i];
+		if(s.height < rectH || s.xEnd + rectW > w)
+			continue;
+		uint waste = s.height - rectH;
+		if(waste < bestWaste)
+		{
+			bestShelf = i;
+			bestWaste = waste;
+			if(!waste)
+				break;
+		}
+	}
+	// open a new shelf instead if the best fit would waste over half the glyph's height
+	if((bestShelf == -1 || bestWaste > rectH / 2)
+		&& usedShelves < MAX_SHELVES && yEnd + rectH <= h)
+	{
+		auto &s = shelf[usedShelves++];
+		s.y = yEnd;
+		s.height = rectH;
+		s.xEnd = 0;
+		yEnd += rectH;
+		bestShelf = usedShelves - 1;
+	}
+	if(bestShelf == -1)
+		return false;
+	auto &s = shelf[bestShelf];
+	x = s.xEnd;
+	y = s.y;
+	s.xEnd += rectW;
+	return true;
+}
+
+bool GlyphAtlas::initPage(Page &p)
+{
+	p.pix.init(PAGE_SIZE, PAGE_SIZE);
+	if(!p.pix.data)
+	{
+		logErr("out of memory allocating glyph page");
+		return false;
+	}
+	mem_zero(p.pix.data, p.pix.size());
+	if(p.img.init(p.pix, false, Gfx::BufferImage::LINEAR, Gfx::BufferImage::HINT_NO_MINIFY) != OK)
+	{
+		logErr("error creating glyph page texture");
+		p.pix.deinit();
+		return false;
+	}
+	p.packer.init(PAGE_SIZE, PAGE_SIZE);
+	p.dirty = true;
+	return true;
+}
+
+void GlyphAtlas::evictPage(Page &p)
+{
+	logMsg("evicting glyph page %d, used %d shelves", (int)(&p - page), p.packer.shelves());
+	p.gen++;
+	if(!p.gen || p.gen == NO_BITMAP_GEN)
+		p.gen = 1;
+	p.packer.reset();
+	mem_zero(p.pix.data, p.pix.size());
+	p.dirty = true;
+	evictionCount++;
+}
+
+bool GlyphAtlas::add(GlyphEntry &entry)
+{
+	auto &metrics = entry.metrics;
+	if(metrics.xSize <= 0 || metrics.ySize <= 0)
+	{
+		entry.pageGen = NO_BITMAP_GEN;
+		return true;
+	}
+	uint w = metrics.xSize + GLYPH_PADDING, h = metrics.ySize + GLYPH_PADDING;
+	if(w > PAGE_SIZE || h > PAGE_SIZE)
+	{
+		logErr("glyph size %dx%d too large for atlas", metrics.xSize, metrics.ySize);
+		return false;
+	}
+	uint x, y;
+	int pageIdx = -1;
+	iterateTimes(usedPages, i)
+	{
+		if(page[i].packer.pack(w, h, x, y))
+		{
+			pageIdx = i;
+			break;
+		}
+	}
+	if(pageIdx == -1)
+	{
+		if(usedPages < MAX_PAGES && initPage(page[usedPages]))
+		{
+			pageIdx = usedPages++;
+			logMsg("added glyph page %d", pageIdx);
+		}
+		else if(usedPages)
+		{
+			// reuse the page that went longest without being drawn
+			pageIdx = 0;
+			for(uint i = 1; i < usedPages; i++)
+			{
+				if(page[i].lastUse < page[pageIdx].lastUse)
+					pageIdx = i;
+			}
+			evictPage(page[pageIdx]);
+		}
+		else
+			return false;
+		if(!page[pageIdx].packer.pack(w, h, x, y))
+		{
+			bug_exit("glyph didn't fit in empty page");
+			return false;
+		}
+	}
+	auto &p = page[pageIdx];
+	entry.page = pageIdx;
+	entry.x = x;
+	entry.y = y;
+	entry.pageGen = p.gen;
+	p.lastUse = useClock;
+	p.dirty = true;
+	return true;
+}
+
+void GlyphAtlas::initGlyphPixmap(const GlyphEntry &entry, IG::Pixmap &pix)
+{
+	assert(entry.pageGen && entry.pageGen != NO_BITMAP_GEN);
+	pix.initSubPixmap(page[entry.page].pix, entry.x, entry.y, entry.metrics.xSize, entry.metrics.ySize);
+}
+
+Gfx::BufferImage *GlyphAtlas::pageImage(uint pageIdx)
+{
+	assert(pageIdx < usedPages);
+	auto &p = page[pageIdx];
+	if(p.dirty)
+	{
+		p.img.write(p.pix);
+		p.dirty = false;
+	}
+	return &p.img;
+}
+
+void GlyphAtlas::deinit()
+{
+	iterateTimes(usedPages, i)
+	{
+		auto &p = page[i];
+		p.img.deinit();
+		p.pix.deinit();
+		p.packer.reset();
+		// invalidate any entries still referencing the page
+		p.gen++;
+		if(!p.gen || p.gen == NO_BITMAP_GEN)
+			p.gen = 1;
+		p.dirty = false;
+	}
+	usedPages = 0;
+}
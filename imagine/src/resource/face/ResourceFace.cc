@@ -17,7 +17,6 @@
 
 #include <imagine/util/strings.h>
 #include <imagine/util/bits.h>
-#include <imagine/gfx/GfxBufferImage.hh>
 #include <imagine/resource/face/ResourceFace.hh>
 
 #ifdef CONFIG_RESOURCE_FONT_FREETYPE
@@ -75,13 +74,18 @@ void ResourceFace::freeCaches(uint32 purgeBits)
 					//logMsg( "%c not a known drawable character, skipping", c);
 					continue;
 				}
-				glyphTable[tableIdx].glyph.deinit();
+				glyphTable[tableIdx].pageGen = 0;
 			}
 			unsetBits(usedGlyphTableBits, IG::bit(i));
 		}
 		tableBits >>= 1;
 		purgeBits >>= 1;
 	}
+	if(!usedGlyphTableBits)
+	{
+		logMsg("no glyphs in use, freeing atlas");
+		atlas.deinit();
+	}
 }
 
 ResourceFace *ResourceFace::load(const char *path, FontSettings *set)
@@ -179,10 +183,7 @@ ResourceFace *ResourceFace::create(ResourceFont *font, FontSettings *set)
 void ResourceFace::free()
 {
 	font->freeSize(faceSize);
-	iterateTimes(glyphTableEntries, i)
-	{
-		glyphTable[i].glyph.deinit();
-	}
+	atlas.deinit();
 	mem_free(glyphTable);
 	delete this;
 }
@@ -217,10 +218,7 @@ CallResult ResourceFace::applySettings(FontSettings set)
 		{
 			logMsg("flushing glyph cache");
 			font->freeSize(faceSize);
-			iterateTimes(glyphTableEntries, i)
-			{
-				glyphTable[i].glyph.deinit();
-			}
+			atlas.deinit();
 		}
 
 		settings = set;
@@ -275,10 +273,19 @@ CallResult ResourceFace::cacheChar(int c, int tableIdx)
 		return INVALID_PARAMETER;
 	}
 	//logMsg("setting up table entry %d", tableIdx);
-	glyphTable[tableIdx].metrics = metrics;
-	auto img = GfxGlyphImage(this, &glyphTable[tableIdx]);
-	glyphTable[tableIdx].glyph.init(img, Gfx::BufferImage::LINEAR, Gfx::BufferImage::HINT_NO_MINIFY);
-	glyphTable[tableIdx].glyph.ref();
+	auto &entry = glyphTable[tableIdx];
+	entry.metrics = metrics;
+	if(!atlas.add(entry))
+	{
+		entry.pageGen = 0;
+		return INVALID_PARAMETER;
+	}
+	if(entry.pageGen != GlyphAtlas::NO_BITMAP_GEN)
+	{
+		IG::Pixmap pix{PixelFormatA8};
+		atlas.initGlyphPixmap(entry, pix);
+		writeCurrentChar(pix);
+	}
 	usedGlyphTableBits |= IG::bit((c >> 11) & 0x1F); // use upper 5 BMP plane bits to map in range 0-31
 	//logMsg("used table bits 0x%X", usedGlyphTableBits);
 	return OK;
@@ -332,7 +339,7 @@ CallResult ResourceFace::precache(const char *string)
 			//logMsg( "%c not a known drawable character, skipping", c);
 			continue;
 		}
-		if(glyphTable[tableIdx].glyph)
+		if(atlas.isCached(glyphTable[tableIdx]))
 		{
 			//logMsg( "%c already cached", c);
 			continue;
@@ -351,13 +358,14 @@ GlyphEntry *ResourceFace::glyphEntry(int c)
 	if(mapCharToTable(c, tableIdx) != OK)
 		return nullptr;
 	assert(tableIdx < glyphTableEntries);
-	if(!glyphTable[tableIdx].glyph)
+	auto &entry = glyphTable[tableIdx];
+	if(!atlas.isCached(entry))
 	{
 		font->applySize(faceSize);
 		if(cacheChar(c, tableIdx) != OK)
 			return nullptr;
 		logMsg("char 0x%X was not in table, cached", c);
 	}
-
-	return &glyphTable[tableIdx];
+	atlas.touch(entry);
+	return &entry;
 }
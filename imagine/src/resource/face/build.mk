@@ -5,6 +5,6 @@ include $(IMAGINE_PATH)/src/resource/build.mk
 
 configDefs += CONFIG_RESOURCE_FACE
 
-SRC += resource/face/ResourceFace.cc
+SRC += resource/face/ResourceFace.cc resource/face/GlyphAtlas.cc
 
 endif
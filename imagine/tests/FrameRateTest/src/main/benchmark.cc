@@ -0,0 +1,170 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "benchmark"
+#include <imagine/logger/logger.h>
+#include <imagine/util/strings.h>
+#include <cstdio>
+#include <cstdlib>
+#include "benchmark.hh"
+
+static FILE *reportFile{};
+static uint testsReported = 0;
+
+static const char *argValue(const char *arg, const char *name)
+{
+	auto len = strlen(name);
+	if(strncmp(arg, name, len) == 0 && arg[len] == '=')
+		return &arg[len + 1];
+	return nullptr;
+}
+
+static bool parseTestList(const char *list, BenchmarkOptions &opts)
+{
+	opts.tests = 0;
+	std::array<char, 64> name{};
+	while(*list)
+	{
+		auto end = strchr(list, ',');
+		uint len = end ? end - list : strlen(list);
+		if(len >= name.size())
+			return false;
+		memcpy(name.data(), list, len);
+		name[len] = 0;
+		if(opts.tests == opts.MAX_TESTS || !testIDFromStr(name.data(), opts.test[opts.tests]))
+		{
+			logErr("invalid test: %s", name.data());
+			return false;
+		}
+		opts.tests++;
+		list += end ? len + 1 : len;
+	}
+	return opts.tests;
+}
+
+bool parseBenchmarkArgs(int argc, char **argv, BenchmarkOptions &opts)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		auto arg = argv[i];
+		const char *val;
+		if(string_equal(arg, "--benchmark"))
+			opts.enabled = true;
+		else if((val = argValue(arg, "--frames")))
+			opts.frames = std::max(atoi(val), 2);
+		else if((val = argValue(arg, "--tests")))
+		{
+			if(!parseTestList(val, opts))
+				return false;
+		}
+		else if((val = argValue(arg, "--json")))
+			opts.jsonPath = val;
+		else if((val = argValue(arg, "--simulate")))
+			opts.simulatedRate = atof(val);
+		else if((val = argValue(arg, "--jitter")))
+			opts.jitterMs = atof(val);
+		else if((val = argValue(arg, "--miss")))
+		{
+			if(sscanf(val, "%u:%u", &opts.missInterval, &opts.missFrames) != 2)
+			{
+				logErr("--miss needs interval:frames");
+				return false;
+			}
+		}
+		else if((val = argValue(arg, "--seed")))
+			opts.seed = strtoul(val, nullptr, 0);
+		else
+			logWarn("ignoring argument: %s", arg);
+	}
+	if(opts.enabled && !opts.tests)
+	{
+		for(auto t : {TEST_CLEAR, TEST_DRAW, TEST_WRITE})
+			opts.test[opts.tests++] = t;
+	}
+	return true;
+}
+
+bool beginBenchmarkReport(const BenchmarkOptions &opts, Base::Screen &screen)
+{
+	if(string_equal(opts.jsonPath, "-"))
+		reportFile = stdout;
+	else if(!(reportFile = fopen(opts.jsonPath, "wb")))
+	{
+		logErr("can't open %s for writing", opts.jsonPath);
+		return false;
+	}
+	testsReported = 0;
+	fprintf(reportFile, "{\n"
+		"\t\"refreshRate\": %u,\n"
+		"\t\"simulated\": %s,\n"
+		"\t\"jitterMs\": %f,\n"
+		"\t\"missInterval\": %u,\n"
+		"\t\"missFrames\": %u,\n"
+		"\t\"seed\": %u,\n"
+		"\t\"framesPerTest\": %u,\n"
+		"\t\"tests\": [",
+		screen.refreshRate(), opts.simulatedRate ? "true" : "false", opts.jitterMs,
+		opts.missInterval, opts.missFrames, (uint)opts.seed, opts.frames);
+	return true;
+}
+
+static void writePhase(const char *name, const PhaseTime &phase, bool last)
+{
+	fprintf(reportFile, "\t\t\t\t\"%s\": {\"avgMs\": %f, \"maxMs\": %f}%s\n",
+		name, phase.avgMs(), phase.maxMs(), last ? "" : ",");
+}
+
+void writeBenchmarkTestReport(const TestParams &params, const TestFramework &test)
+{
+	if(!reportFile)
+		return;
+	auto secs = Base::frameTimeBaseToSDec(test.endTime - test.startTime);
+	double fps = secs > 0 ? (test.frames - 1) / secs : 0.;
+	fprintf(reportFile, "%s\n\t\t{\n"
+		"\t\t\t\"name\": \"%s\",\n"
+		"\t\t\t\"frames\": %u,\n"
+		"\t\t\t\"seconds\": %f,\n"
+		"\t\t\t\"fps\": %f,\n"
+		"\t\t\t\"droppedFrames\": %u,\n"
+		"\t\t\t\"lostFrames\": %u,\n"
+		"\t\t\t\"maxContinuousFrames\": %u,\n"
+		"\t\t\t\"frameTimeHistogramMs\": [",
+		testsReported ? "," : "",
+		params.makeTestName().data(), test.frames, secs, fps,
+		test.droppedFrames, test.lostFrames, test.maxContinuousFrames);
+	iterateTimes(test.frameTimeHistogram.size(), i)
+	{
+		fprintf(reportFile, "%s%u", i ? ", " : "", test.frameTimeHistogram[i]);
+	}
+	fprintf(reportFile, "],\n\t\t\t\"cpu\": {\n");
+	writePhase("update", test.updateTime, false);
+	writePhase("draw", test.drawTime, false);
+	writePhase("present", test.presentTime, true);
+	fprintf(reportFile, "\t\t\t}\n\t\t}");
+	fflush(reportFile);
+	testsReported++;
+}
+
+void endBenchmarkReport(const Base::SimulatedFrameSource *sim)
+{
+	if(!reportFile)
+		return;
+	fprintf(reportFile, "\n\t],\n\t\"simulatedMissedFrames\": %u\n}\n", sim ? sim->missedFrames() : 0);
+	if(reportFile != stdout)
+		fclose(reportFile);
+	else
+		fflush(reportFile);
+	reportFile = nullptr;
+}
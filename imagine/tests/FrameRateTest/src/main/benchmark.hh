@@ -0,0 +1,43 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/base/SimulatedFrameSource.hh>
+#include "tests.hh"
+
+// Options for running the tests unattended, set from the command line:
+// --benchmark [--frames=N] [--tests=clear,draw,write] [--json=path|-]
+// [--simulate=hz] [--jitter=ms] [--miss=interval:frames] [--seed=N]
+struct BenchmarkOptions
+{
+	static constexpr uint MAX_TESTS = 8;
+	bool enabled{};
+	uint frames = 60*60;
+	const char *jsonPath = "-";
+	double simulatedRate{}; // 0 uses the real display
+	double jitterMs{};
+	uint missInterval{}, missFrames{};
+	uint32 seed = 1;
+	TestID test[MAX_TESTS]{};
+	uint tests{};
+
+	constexpr BenchmarkOptions() {}
+};
+
+bool parseBenchmarkArgs(int argc, char **argv, BenchmarkOptions &opts);
+bool beginBenchmarkReport(const BenchmarkOptions &opts, Base::Screen &screen);
+void writeBenchmarkTestReport(const TestParams &params, const TestFramework &test);
+void endBenchmarkReport(const Base::SimulatedFrameSource *sim);
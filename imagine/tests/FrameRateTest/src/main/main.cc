@@ -18,11 +18,13 @@
 #include <imagine/gfx/GfxSprite.hh>
 #include <imagine/gfx/GfxText.hh>
 #include <imagine/io/FileIO.hh>
+#include <imagine/util/time/sys.hh>
 #include "tests.hh"
 #include "TestPicker.hh"
+#include "benchmark.hh"
 #include <unistd.h>
 
-static const uint framesToRun = 60*60;
+static uint framesToRun = 60*60;
 static Base::Window mainWin;
 static Gfx::ProjectionPlane projP;
 static Gfx::Mat4 projMat;
@@ -30,6 +32,9 @@ static Gfx::GCRect testRect;
 static FileIO cpuFreqFile;
 static TestFramework *activeTest{};
 static TestPicker picker{mainWin};
+static BenchmarkOptions benchOpts;
+static uint benchTestIdx = 0;
+static Base::SimulatedFrameSource simFrameSource;
 
 static TestParams testParam[] =
 {
@@ -73,6 +78,36 @@ static void placeElements()
 	}
 }
 
+static const TestParams &testParamsForID(TestID id)
+{
+	for(auto &p : testParam)
+	{
+		if(p.test == id)
+			return p;
+	}
+	bug_exit("no params for test %d", id);
+	return testParam[0];
+}
+
+static void startNextBenchmarkTest(Base::Window &win)
+{
+	if(benchTestIdx == benchOpts.tests)
+	{
+		logMsg("benchmark complete");
+		endBenchmarkReport(Base::simulatedFrameSource());
+		Base::exit();
+		return;
+	}
+	auto &params = testParamsForID(benchOpts.test[benchTestIdx++]);
+	logMsg("running benchmark: %s", params.makeTestName().data());
+	auto test = startTest(win, params);
+	test->onTestFinished =
+		[&params](TestFramework &test)
+		{
+			writeBenchmarkTestReport(params, test);
+		};
+}
+
 static void finishTest(Base::Window &win, Base::FrameTimeBase frameTime)
 {
 	cpuFreqFile.close();
@@ -87,6 +122,8 @@ static void finishTest(Base::Window &win, Base::FrameTimeBase frameTime)
 	win.postDraw();
 	Base::setIdleDisplayPowerSave(true);
 	Input::setKeyRepeat(true);
+	if(benchOpts.enabled)
+		startNextBenchmarkTest(win);
 }
 
 TestFramework *startTest(Base::Window &win, const TestParams &t)
@@ -137,6 +174,18 @@ namespace Base
 
 CallResult onInit(int argc, char** argv)
 {
+	if(!parseBenchmarkArgs(argc, argv, benchOpts))
+		return INVALID_PARAMETER;
+	if(benchOpts.enabled)
+	{
+		framesToRun = benchOpts.frames;
+		if(benchOpts.simulatedRate)
+		{
+			simFrameSource.init(benchOpts.simulatedRate, benchOpts.jitterMs / 1000., benchOpts.seed);
+			simFrameSource.setMissedFrames(benchOpts.missInterval, benchOpts.missFrames);
+			Base::setSimulatedFrameSource(&simFrameSource);
+		}
+	}
 	Gfx::init();
 	View::compileGfxPrograms();
 	View::defaultFace = ResourceFace::loadSystem();
@@ -170,7 +219,10 @@ CallResult onInit(int argc, char** argv)
 				activeTest->draw();
 			}
 			Gfx::setClipRect(false);
+			auto before = TimeSys::now();
 			Gfx::presentWindow(win);
+			if(activeTest)
+				activeTest->presentTime.add((TimeSys::now() - before).toNs());
 		});
 
 	winConf.setOnInputEvent(
@@ -198,6 +250,12 @@ CallResult onInit(int argc, char** argv)
 	View::defaultFace->precacheAlphaNum();
 	picker.init(testParam, sizeofArray(testParam));
 	mainWin.show();
+	if(benchOpts.enabled)
+	{
+		if(!beginBenchmarkReport(benchOpts, *mainWin.screen()))
+			return IO_ERROR;
+		startNextBenchmarkTest(mainWin);
+	}
 	return OK;
 }
 
@@ -14,6 +14,7 @@
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
 #include <imagine/gui/TableView.hh>
+#include <imagine/util/time/sys.hh>
 #include "tests.hh"
 
 const char *testIDToStr(TestID id)
@@ -27,6 +28,19 @@ const char *testIDToStr(TestID id)
 	}
 }
 
+bool testIDFromStr(const char *str, TestID &id)
+{
+	for(auto t : {TEST_CLEAR, TEST_DRAW, TEST_WRITE})
+	{
+		if(string_equalNoCase(str, testIDToStr(t)))
+		{
+			id = t;
+			return true;
+		}
+	}
+	return false;
+}
+
 std::array<char, 64> TestParams::makeTestName() const
 {
 	std::array<char, 64> name;
@@ -97,26 +111,35 @@ void TestFramework::frameUpdate(Base::Screen &screen, Base::FrameTimeBase frameT
 	}
 	else
 	{
+		uint frameMs = Base::frameTimeBaseToSDec(frameTime - lastFrameTime) * 1000.;
+		frameTimeHistogram[std::min(frameMs, FRAME_TIME_BUCKETS - 1)]++;
 		auto elapsedScreenFrames = screen.elapsedFrames(frameTime);
 		//logMsg("elapsed: %d", screen.elapsedFrames(frameTime));
 		if(elapsedScreenFrames > 1)
 		{
 			droppedFrames++;
+			lostFrames += elapsedScreenFrames - 1;
 			string_printf(skippedFrameStr, "Lost %u frame(s) after %u continuous\nat time %f",
 				elapsedScreenFrames - 1, continuousFrames, Base::frameTimeBaseToSDec(frameTime));
 			placeSkippedFrameText();
 			continuousFrames = 0;
 		}
 	}
+	lastFrameTime = frameTime;
+	auto before = TimeSys::now();
 	frameUpdateTest(screen, frameTime);
+	updateTime.add((TimeSys::now() - before).toNs());
 	frames++;
 	continuousFrames++;
+	maxContinuousFrames = std::max(maxContinuousFrames, continuousFrames);
 }
 
 void TestFramework::draw()
 {
 	using namespace Gfx;
+	auto before = TimeSys::now();
 	drawTest();
+	drawTime.add((TimeSys::now() - before).toNs());
 	if(strlen(cpuFreqStr.data()))
 	{
 		noTexProgram.use();
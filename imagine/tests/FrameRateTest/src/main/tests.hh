@@ -41,15 +41,38 @@ public:
 	std::array<char, 64> makeTestName() const;
 };
 
+// CPU time spent in one part of the frame loop
+struct PhaseTime
+{
+	uint64 totalNs{};
+	uint64 maxNs{};
+	uint samples{};
+
+	constexpr PhaseTime() {}
+	void add(uint64 ns)
+	{
+		totalNs += ns;
+		maxNs = std::max(maxNs, ns);
+		samples++;
+	}
+	double avgMs() const { return samples ? (totalNs / (double)samples) / 1000000. : 0.; }
+	double maxMs() const { return maxNs / 1000000.; }
+};
+
 class TestFramework
 {
 public:
 	using TestFinishedDelegate = DelegateFunc<void (TestFramework &test)>;
+	static constexpr uint FRAME_TIME_BUCKETS = 64; // 1ms each, last one holds everything longer
 	bool shouldEndTest{};
 	uint frames{};
 	uint droppedFrames{};
+	uint lostFrames{};
 	uint continuousFrames{};
-	Base::FrameTimeBase startTime{}, endTime{};
+	uint maxContinuousFrames{};
+	Base::FrameTimeBase startTime{}, endTime{}, lastFrameTime{};
+	std::array<uint, FRAME_TIME_BUCKETS> frameTimeHistogram{};
+	PhaseTime updateTime, drawTime, presentTime;
 	TestFinishedDelegate onTestFinished;
 
 	constexpr TestFramework() {}
@@ -121,3 +144,4 @@ public:
 
 TestFramework *startTest(Base::Window &win, const TestParams &t);
 const char *testIDToStr(TestID id);
+bool testIDFromStr(const char *str, TestID &id);